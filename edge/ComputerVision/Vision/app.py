@@ -9,7 +9,7 @@ from typing import Dict, Iterable
 
 from .config import AppConfig
 from .db import DatabaseClient, IPCStreamConfig
-from .frame_bus import FrameHub
+from .frame_bus import FrameHub, SharedFrameHub
 from .mosaic import MosaicComposer, MosaicSettings
 from .stream import StreamWorker
 from .webrtc import WebRTCServer
@@ -23,7 +23,7 @@ class StreamCoordinator:
     def __init__(
         self,
         app_config: AppConfig,
-        frame_hub: FrameHub,
+        frame_hub: FrameHub | SharedFrameHub,
         db_client: DatabaseClient,
     ) -> None:
         self.app_config = app_config
@@ -77,6 +77,23 @@ class StreamCoordinator:
             self._workers.clear()
 
 
+def _create_frame_hub(app_config: AppConfig) -> FrameHub | SharedFrameHub:
+    if not app_config.frame_bus_name:
+        return FrameHub()
+    try:
+        frame_hub = SharedFrameHub(
+            app_config.frame_bus_name,
+            max_streams=app_config.frame_bus_max_streams,
+        )
+    except OSError as exc:
+        LOGGER.warning(
+            "Shared frame bus unavailable (%s); using in-process FrameHub", exc
+        )
+        return FrameHub()
+    LOGGER.info("Publishing frames to shared frame bus %s", frame_hub.name)
+    return frame_hub
+
+
 def run(app_config: AppConfig) -> None:
     logging.basicConfig(
         level=logging.DEBUG if app_config.debug else logging.INFO,
@@ -84,7 +101,7 @@ def run(app_config: AppConfig) -> None:
     )
     LOGGER.info("Starting fall detection service with EDGE_ID=%s", app_config.edge_id)
 
-    frame_hub = FrameHub()
+    frame_hub = _create_frame_hub(app_config)
     mosaic = MosaicComposer(
         frame_hub,
         MosaicSettings(
@@ -121,4 +138,6 @@ def run(app_config: AppConfig) -> None:
         db_client.close()
         webrtc_server.stop()
         mosaic.stop()
+        if isinstance(frame_hub, SharedFrameHub):
+            frame_hub.close(unlink=True)
         LOGGER.info("Shutdown complete.")
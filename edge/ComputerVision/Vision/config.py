@@ -40,6 +40,8 @@ class AppConfig:
     mosaic_fps: float
     webrtc_host: str
     webrtc_port: int
+    frame_bus_name: str
+    frame_bus_max_streams: int
     fall_event_endpoint: str
     fall_event_enabled: bool
     fall_event_timeout: float
@@ -72,6 +74,9 @@ class AppConfig:
         mosaic_fps = float(os.getenv("MOSAIC_FPS", "5.0"))
         webrtc_host = os.getenv("WEBRTC_HOST", "0.0.0.0")
         webrtc_port = int(os.getenv("WEBRTC_PORT", "8765"))
+        # Empty keeps frames in-process; a name enables the shared-memory bus.
+        frame_bus_name = os.getenv("FRAME_BUS_SHM", "")
+        frame_bus_max_streams = int(os.getenv("FRAME_BUS_MAX_STREAMS", "16"))
         fall_event_endpoint = os.getenv(
             "FALL_EVENT_ENDPOINT", "https://api.redsafe-tw.com/edge/event/fall"
         )
@@ -109,6 +114,8 @@ class AppConfig:
             mosaic_fps=mosaic_fps,
             webrtc_host=webrtc_host,
             webrtc_port=webrtc_port,
+            frame_bus_name=frame_bus_name,
+            frame_bus_max_streams=frame_bus_max_streams,
             fall_event_endpoint=fall_event_endpoint,
             fall_event_enabled=fall_event_enabled,
             fall_event_timeout=fall_event_timeout,
@@ -2,11 +2,18 @@
 
 from __future__ import annotations
 
+import ctypes
+import functools
+import logging
 import math
-from typing import Dict, NamedTuple, Optional, Tuple
+import os
+from pathlib import Path
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple
 
 import numpy as np
 
+LOGGER = logging.getLogger(__name__)
+
 
 def infer_labels(
     tilt_angle: float,
@@ -193,18 +200,199 @@ class FallDetectionTracker:
             scale_rate,
         )
 
-        debug_fields = [
-            f"ID {pid}",
-            f"tilt={tilt_angle} deg",
-            f"omega={tilt_velocity} deg/s",
-            f"box_ratio={scale_ratio}",
-            f"box_rate={scale_rate} 1/s",
-            f"height_ratio={height_r}",
-            f"label_weak={label_weak}",
+        self._last_box_by_id[pid] = (height, timestamp_ms)
+        return _build_result(
+            pid,
+            tilt_angle,
+            tilt_velocity,
+            scale_ratio,
+            scale_rate,
+            height_r,
+            label_weak,
+        )
+
+    def evaluate_batch(
+        self,
+        pids: Sequence[int],
+        heights: Sequence[float],
+        keypoints: np.ndarray,
+        timestamp_ms: int,
+    ) -> List[FallDetectionResult]:
+        """依序評估同一幀中的所有人員。"""
+
+        return [
+            self.evaluate(int(pid), float(height), kpts, timestamp_ms)
+            for pid, height, kpts in zip(pids, heights, keypoints)
         ]
 
-        self._last_box_by_id[pid] = (height, timestamp_ms)
-        return FallDetectionResult(
-            label_weak=label_weak,
-            log_line=", ".join(debug_fields),
+
+def _build_result(
+    pid: int,
+    tilt_angle: float,
+    tilt_velocity: float,
+    scale_ratio: float,
+    scale_rate: float,
+    height_r: float,
+    label_weak: int,
+) -> FallDetectionResult:
+    debug_fields = [
+        f"ID {pid}",
+        f"tilt={tilt_angle} deg",
+        f"omega={tilt_velocity} deg/s",
+        f"box_ratio={scale_ratio}",
+        f"box_rate={scale_rate} 1/s",
+        f"height_ratio={height_r}",
+        f"label_weak={label_weak}",
+    ]
+    return FallDetectionResult(
+        label_weak=label_weak,
+        log_line=", ".join(debug_fields),
+    )
+
+
+# 與 native/src/fall_features/fall_tracker.hpp 的 FallFeatures 相同的佈局
+FALL_FEATURE_DTYPE = np.dtype(
+    [
+        ("tilt_deg", "<f8"),
+        ("omega_deg_s", "<f8"),
+        ("box_ratio", "<f8"),
+        ("box_rate", "<f8"),
+        ("height_ratio", "<f8"),
+        ("label_weak", "<i4"),
+        ("reserved", "<i4"),
+    ]
+)
+
+_DEFAULT_LIBRARY = (
+    Path(__file__).resolve().parent.parent
+    / "native"
+    / "build"
+    / "src"
+    / "fall_features"
+    / "libedge_fall_features.so"
+)
+
+
+@functools.lru_cache(maxsize=None)
+def _load_library(path: str) -> ctypes.CDLL:
+    """載入原生特徵函式庫並宣告 C ABI。"""
+
+    lib = ctypes.CDLL(path)
+    lib.edge_fall_tracker_create.restype = ctypes.c_void_p
+    lib.edge_fall_tracker_create.argtypes = [ctypes.c_uint32]
+    lib.edge_fall_tracker_destroy.restype = None
+    lib.edge_fall_tracker_destroy.argtypes = [ctypes.c_void_p]
+    lib.edge_fall_tracker_reset.restype = None
+    lib.edge_fall_tracker_reset.argtypes = [ctypes.c_void_p]
+    lib.edge_fall_tracker_tracked.restype = ctypes.c_size_t
+    lib.edge_fall_tracker_tracked.argtypes = [ctypes.c_void_p]
+    lib.edge_fall_tracker_evaluate.restype = ctypes.c_int
+    lib.edge_fall_tracker_evaluate.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_size_t,
+        ctypes.c_size_t,
+        ctypes.c_int64,
+        ctypes.c_void_p,
+    ]
+    return lib
+
+
+class NativeFallTracker:
+    """以原生函式庫一次計算整幀特徵的 FallDetectionTracker。
+
+    追蹤狀態存放在以 slot 為索引的扁平陣列，關節點幾何以向量化迴圈
+    一次處理所有人員；判斷規則與數值（取到小數第三位）與 Python 版相同。
+    """
+
+    def __init__(self, capacity: int = 64, library: str | None = None) -> None:
+        path = library or os.getenv("FALL_FEATURES_LIBRARY") or str(_DEFAULT_LIBRARY)
+        self._lib = _load_library(path)
+        self._handle = self._lib.edge_fall_tracker_create(capacity)
+        self._features = np.empty(0, dtype=FALL_FEATURE_DTYPE)
+
+    def __del__(self) -> None:
+        handle = getattr(self, "_handle", None)
+        if handle:
+            self._lib.edge_fall_tracker_destroy(handle)
+            self._handle = None
+
+    def features_batch(
+        self,
+        pids: Sequence[int] | np.ndarray,
+        heights: Sequence[float] | np.ndarray,
+        keypoints: np.ndarray,
+        timestamp_ms: int,
+    ) -> np.ndarray:
+        """回傳 FALL_FEATURE_DTYPE 的特徵陣列（下一次呼叫前有效）。"""
+
+        ids = np.ascontiguousarray(pids, dtype=np.int64)
+        box_heights = np.ascontiguousarray(heights, dtype=np.float64)
+        kpts = np.ascontiguousarray(keypoints, dtype=np.float32)
+        count = len(ids)
+        if (
+            box_heights.shape != (count,)
+            or kpts.ndim != 3
+            or kpts.shape[0] != count
+            or kpts.shape[2] != 2
+        ):
+            raise ValueError(
+                f"Mismatched fall feature inputs: ids={ids.shape}, "
+                f"heights={box_heights.shape}, keypoints={kpts.shape}"
+            )
+        if len(self._features) < count:
+            self._features = np.empty(count, dtype=FALL_FEATURE_DTYPE)
+        out = self._features[:count]
+        ok = self._lib.edge_fall_tracker_evaluate(
+            self._handle,
+            ids.ctypes.data,
+            box_heights.ctypes.data,
+            kpts.ctypes.data,
+            count,
+            kpts.shape[1],
+            timestamp_ms,
+            out.ctypes.data,
         )
+        if not ok:
+            raise ValueError(f"Unsupported keypoint layout {kpts.shape}")
+        return out
+
+    def evaluate_batch(
+        self,
+        pids: Sequence[int] | np.ndarray,
+        heights: Sequence[float] | np.ndarray,
+        keypoints: np.ndarray,
+        timestamp_ms: int,
+    ) -> List[FallDetectionResult]:
+        """一次評估同一幀中的所有人員。"""
+
+        features = self.features_batch(pids, heights, keypoints, timestamp_ms)
+        return [
+            _build_result(int(pid), *row[:5], int(row[5]))
+            for pid, row in zip(pids, features.tolist())
+        ]
+
+    def evaluate(
+        self,
+        pid: int,
+        height: float,
+        keypoints: np.ndarray,
+        timestamp_ms: int,
+    ) -> FallDetectionResult:
+        """與 FallDetectionTracker.evaluate 相同的單人介面。"""
+
+        return self.evaluate_batch(
+            [pid], [height], np.asarray(keypoints)[np.newaxis], timestamp_ms
+        )[0]
+
+
+def create_fall_tracker() -> FallDetectionTracker | NativeFallTracker:
+    """優先使用原生特徵函式庫，無法載入時退回 Python 版。"""
+
+    try:
+        return NativeFallTracker()
+    except OSError as exc:
+        LOGGER.debug("Native fall features unavailable (%s); using Python tracker", exc)
+        return FallDetectionTracker()
@@ -2,13 +2,22 @@
 
 from __future__ import annotations
 
+import ctypes
+import functools
+import logging
+import os
 import threading
 import time
 from dataclasses import dataclass
-from typing import Dict, Iterable, List, Tuple
+from pathlib import Path
+from typing import Callable, Dict, Iterable, List, Optional, Tuple, TypeVar
 
 import numpy as np
 
+LOGGER = logging.getLogger(__name__)
+
+T = TypeVar("T")
+
 
 def _unix_time_ms() -> int:
     """Return the current Unix timestamp in milliseconds."""
@@ -63,3 +72,276 @@ class FrameHub:
 
         with self._lock:
             return list(self._frames.items())
+
+
+# 與 native/src/frame_bus/c_api.hpp 的 EdgeFrameInfo 及 ReadStatus 對應。
+_MAX_LABEL_LENGTH = 127
+_READ_OK = 0
+_READ_TOO_SMALL = 3
+
+_DEFAULT_LIBRARY = (
+    Path(__file__).resolve().parent.parent
+    / "native"
+    / "build"
+    / "src"
+    / "frame_bus"
+    / "libedge_frame_bus.so"
+)
+
+
+class _FrameInfo(ctypes.Structure):
+    _fields_ = [
+        ("height", ctypes.c_uint32),
+        ("width", ctypes.c_uint32),
+        ("channels", ctypes.c_uint32),
+        ("label_length", ctypes.c_uint32),
+        ("timestamp_ms", ctypes.c_int64),
+        ("sequence", ctypes.c_uint64),
+        ("label", ctypes.c_char * (_MAX_LABEL_LENGTH + 1)),
+    ]
+
+    def shape(self) -> Tuple[int, ...]:
+        if self.channels == 1:
+            return (self.height, self.width)
+        return (self.height, self.width, self.channels)
+
+    def decoded_label(self) -> str:
+        return self.label[: self.label_length].decode("utf-8", errors="replace")
+
+
+@functools.lru_cache(maxsize=None)
+def _load_library(path: str) -> ctypes.CDLL:
+    """載入 native frame bus 並宣告其 C ABI。"""
+
+    lib = ctypes.CDLL(path)
+    u8_ptr = ctypes.POINTER(ctypes.c_uint8)
+    signatures = {
+        "edge_frame_bus_create": (ctypes.c_void_p, [ctypes.c_char_p, ctypes.c_uint32]),
+        "edge_frame_bus_open": (ctypes.c_void_p, [ctypes.c_char_p]),
+        "edge_frame_bus_close": (None, [ctypes.c_void_p]),
+        "edge_frame_bus_unlink": (None, [ctypes.c_void_p]),
+        "edge_frame_bus_publish": (
+            ctypes.c_int,
+            [
+                ctypes.c_void_p,
+                ctypes.c_char_p,
+                ctypes.c_char_p,
+                u8_ptr,
+                ctypes.c_uint32,
+                ctypes.c_uint32,
+                ctypes.c_uint32,
+                ctypes.c_int64,
+            ],
+        ),
+        "edge_frame_bus_remove": (None, [ctypes.c_void_p, ctypes.c_char_p]),
+        "edge_frame_bus_streams": (
+            ctypes.c_size_t,
+            [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t],
+        ),
+        "edge_frame_bus_read": (
+            ctypes.c_int,
+            [
+                ctypes.c_void_p,
+                ctypes.c_char_p,
+                u8_ptr,
+                ctypes.c_size_t,
+                ctypes.POINTER(_FrameInfo),
+            ],
+        ),
+        "edge_frame_bus_acquire": (
+            ctypes.c_void_p,
+            [
+                ctypes.c_void_p,
+                ctypes.c_char_p,
+                ctypes.POINTER(_FrameInfo),
+                ctypes.POINTER(u8_ptr),
+            ],
+        ),
+        "edge_frame_bus_validate": (ctypes.c_int, [ctypes.c_void_p]),
+        "edge_frame_bus_release": (None, [ctypes.c_void_p]),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        func = getattr(lib, name)
+        func.restype = restype
+        func.argtypes = argtypes
+    return lib
+
+
+class SharedFrameHub:
+    """以 native 共享記憶體 frame bus 實作的 FrameHub。
+
+    每個串流的最新畫面存放在 POSIX shared memory 中以 seqlock 保護的三格
+    緩衝區，偵測、拼接與串流可以分成不同行程。``publish`` 與 ``snapshot``
+    在 native library 內釋放 GIL 後只複製一次；``read_view`` 則直接提供
+    共享格子的唯讀 view，完全不複製。建立時會移除發布行程已結束的串流。
+    """
+
+    def __init__(
+        self,
+        name: str,
+        max_streams: int = 16,
+        *,
+        create: bool = True,
+        library: str | None = None,
+    ) -> None:
+        path = library or os.getenv("FRAME_BUS_LIBRARY") or str(_DEFAULT_LIBRARY)
+        self._lib = _load_library(path)
+        encoded = name.encode("utf-8")
+        if create:
+            handle = self._lib.edge_frame_bus_create(encoded, max_streams)
+        else:
+            handle = self._lib.edge_frame_bus_open(encoded)
+        if not handle:
+            raise OSError(f"Unable to {'create' if create else 'open'} frame bus {name!r}")
+        self._handle = handle
+        self._name = name
+        self._close_lock = threading.Lock()
+        self._rejected: set[str] = set()
+        # 各串流上一次的畫面尺寸，讀取時用來預先配置緩衝區
+        self._shapes: Dict[str, Tuple[int, ...]] = {}
+
+    @property
+    def name(self) -> str:
+        return self._name
+
+    def publish(self, stream_id: str, label: str, frame: np.ndarray) -> None:
+        """寫入（或更新）指定串流的最新畫面。"""
+
+        # 已是連續記憶體的 uint8 畫面（常見情況）在這裡不會複製
+        frame_u8 = np.ascontiguousarray(frame, dtype=np.uint8)
+        if frame_u8.ndim == 2:
+            height, width = frame_u8.shape
+            channels = 1
+        elif frame_u8.ndim == 3:
+            height, width, channels = frame_u8.shape
+        else:
+            raise ValueError(f"Unsupported frame shape {frame_u8.shape}")
+        ok = self._lib.edge_frame_bus_publish(
+            self._handle,
+            stream_id.encode("utf-8"),
+            label.encode("utf-8"),
+            frame_u8.ctypes.data_as(ctypes.POINTER(ctypes.c_uint8)),
+            height,
+            width,
+            channels,
+            _unix_time_ms(),
+        )
+        if not ok and stream_id not in self._rejected:
+            self._rejected.add(stream_id)
+            LOGGER.warning(
+                "Frame bus %s rejected frames for %s (stream limit reached?)",
+                self._name,
+                stream_id,
+            )
+
+    def remove(self, stream_id: str) -> None:
+        """移除已停止串流的畫面。"""
+
+        self._lib.edge_frame_bus_remove(self._handle, stream_id.encode("utf-8"))
+        self._rejected.discard(stream_id)
+        self._shapes.pop(stream_id, None)
+
+    def stream_ids(self) -> List[str]:
+        """回傳目前 bus 上所有串流的 ID（已排序）。"""
+
+        size = 4096
+        while True:
+            buffer = ctypes.create_string_buffer(size)
+            required = self._lib.edge_frame_bus_streams(self._handle, buffer, size)
+            if required <= size:
+                break
+            size = required
+        joined = buffer.value.decode("utf-8", errors="replace")
+        return joined.split("\n") if joined else []
+
+    def read(self, stream_id: str) -> Optional[FramePayload]:
+        """複製串流的最新畫面，沒有畫面時回傳 None。"""
+
+        info = _FrameInfo()
+        frame = np.empty(self._shapes.get(stream_id, (0,)), dtype=np.uint8)
+        for _ in range(2):
+            status = self._lib.edge_frame_bus_read(
+                self._handle,
+                stream_id.encode("utf-8"),
+                frame.ctypes.data_as(ctypes.POINTER(ctypes.c_uint8)),
+                frame.nbytes,
+                ctypes.byref(info),
+            )
+            if status == _READ_TOO_SMALL:
+                # 串流解析度改變，依回報的尺寸重新配置後再讀一次
+                frame = np.empty(info.shape(), dtype=np.uint8)
+                continue
+            break
+        if status != _READ_OK:
+            return None
+        shape = info.shape()
+        self._shapes[stream_id] = shape
+        # 畫面變小時只填入依快取尺寸配置之緩衝區的前段
+        size = int(np.prod(shape))
+        return FramePayload(
+            stream_id=stream_id,
+            label=info.decoded_label(),
+            frame=frame.reshape(-1)[:size].reshape(shape),
+            timestamp_ms=info.timestamp_ms,
+        )
+
+    def read_view(
+        self,
+        stream_id: str,
+        consume: Callable[[FramePayload], T],
+        attempts: int = 3,
+    ) -> Optional[T]:
+        """以最新畫面的零複製 view 執行 ``consume``。
+
+        view 直接指向共享記憶體，不可帶出 ``consume`` 之外。若期間發布端
+        覆寫了該格，捨棄結果並以較新的畫面重新執行 ``consume``；沒有畫面
+        或每次嘗試都被覆寫時回傳 None。
+        """
+
+        encoded = stream_id.encode("utf-8")
+        for _ in range(attempts):
+            info = _FrameInfo()
+            data = ctypes.POINTER(ctypes.c_uint8)()
+            lease = self._lib.edge_frame_bus_acquire(
+                self._handle, encoded, ctypes.byref(info), ctypes.byref(data)
+            )
+            if not lease:
+                return None
+            try:
+                frame = np.ctypeslib.as_array(data, shape=info.shape())
+                frame.flags.writeable = False
+                result = consume(
+                    FramePayload(
+                        stream_id=stream_id,
+                        label=info.decoded_label(),
+                        frame=frame,
+                        timestamp_ms=info.timestamp_ms,
+                    )
+                )
+                if self._lib.edge_frame_bus_validate(lease):
+                    return result
+            finally:
+                self._lib.edge_frame_bus_release(lease)
+        return None
+
+    def snapshot(self) -> List[FramePayload]:
+        """回傳目前各串流畫面的副本，供拼接使用。"""
+
+        payloads = (self.read(stream_id) for stream_id in self.stream_ids())
+        return [payload for payload in payloads if payload is not None]
+
+    def items(self) -> Iterable[Tuple[str, FramePayload]]:
+        """主要供除錯使用的迭代介面。"""
+
+        return [(payload.stream_id, payload) for payload in self.snapshot()]
+
+    def close(self, unlink: bool = False) -> None:
+        """解除映射；``unlink`` 為 True 時一併刪除共享記憶體名稱。"""
+
+        with self._close_lock:
+            if not self._handle:
+                return
+            if unlink:
+                self._lib.edge_frame_bus_unlink(self._handle)
+            self._lib.edge_frame_bus_close(self._handle)
+            self._handle = None
@@ -2,6 +2,7 @@
 
 from __future__ import annotations
 
+import functools
 import threading
 import time
 from dataclasses import dataclass
@@ -10,7 +11,7 @@ from typing import List, Sequence
 import cv2
 import numpy as np
 
-from .frame_bus import FrameHub, FramePayload
+from .frame_bus import FrameHub, FramePayload, SharedFrameHub
 
 
 @dataclass(frozen=True)
@@ -26,7 +27,9 @@ class MosaicSettings:
 class MosaicComposer:
     """Background worker that composes a NxN mosaic from the latest frames."""
 
-    def __init__(self, frame_hub: FrameHub, settings: MosaicSettings) -> None:
+    def __init__(
+        self, frame_hub: FrameHub | SharedFrameHub, settings: MosaicSettings
+    ) -> None:
         self._frame_hub = frame_hub
         self._settings = settings
         self._stop_event = threading.Event()
@@ -71,8 +74,10 @@ class MosaicComposer:
         fps = max(self._settings.fps, 0.5)
         delay = 1.0 / fps
         while not self._stop_event.is_set():
-            frames = self._frame_hub.snapshot()
-            composed = self._compose(frames)
+            if isinstance(self._frame_hub, SharedFrameHub):
+                composed = self._compose_shared(self._frame_hub)
+            else:
+                composed = self._compose(self._frame_hub.snapshot())
             self._publish(composed)
             if delay > 0:
                 self._stop_event.wait(delay)
@@ -95,6 +100,55 @@ class MosaicComposer:
             return single
         return self._grid(trimmed)
 
+    def _compose_shared(self, hub: SharedFrameHub) -> np.ndarray:
+        """Compose straight from zero-copy views of the shared frame bus.
+
+        ``snapshot`` would first copy every full-size frame out of shared
+        memory; here each tile is resized straight from the view, so only
+        tile-sized data is written before it lands in the canvas.
+        """
+
+        stream_ids = hub.stream_ids()[: self._settings.max_tiles]
+        if not stream_ids:
+            return self._blank_canvas("Wait IPC connect.")
+
+        if len(stream_ids) == 1:
+            canvas = np.empty(
+                (self._settings.height, self._settings.width, 3), dtype=np.uint8
+            )
+            drawn = hub.read_view(
+                stream_ids[0], functools.partial(self._resize_into, canvas)
+            )
+            return canvas if drawn else self._blank_canvas("Wait IPC connect.")
+
+        grid_size = 2
+        tile_w = self._settings.width // grid_size
+        tile_h = self._settings.height // grid_size
+        canvas = np.empty((tile_h * grid_size, tile_w * grid_size, 3), dtype=np.uint8)
+        for idx in range(grid_size * grid_size):
+            row, col = divmod(idx, grid_size)
+            region = canvas[
+                row * tile_h : (row + 1) * tile_h, col * tile_w : (col + 1) * tile_w
+            ]
+            drawn = idx < len(stream_ids) and hub.read_view(
+                stream_ids[idx], functools.partial(self._resize_into, region)
+            )
+            if not drawn:
+                region[...] = self._blank_tile(tile_w, tile_h)
+        return canvas
+
+    def _resize_into(self, region: np.ndarray, payload: FramePayload) -> bool:
+        # payload.frame 指向共享記憶體，只能在此函式內讀取，結果必須寫入 region
+        frame = payload.frame
+        height, width = region.shape[:2]
+        if frame.shape[0] == height and frame.shape[1] == width:
+            region[...] = frame
+        else:
+            region[...] = cv2.resize(
+                frame, (width, height), interpolation=cv2.INTER_AREA
+            )
+        return True
+
     def _grid(self, frames: Sequence[FramePayload]) -> np.ndarray:
         grid_size = 2
         tile_w = self._settings.width // grid_size
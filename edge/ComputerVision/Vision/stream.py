@@ -17,9 +17,9 @@ from ultralytics import YOLO
 from .config import AppConfig
 from .db import DatabaseClient, IPCStreamConfig
 from .event_reporter import FallEventReporter
-from .frame_bus import FrameHub
+from .frame_bus import FrameHub, SharedFrameHub
 from .bednight import BedExitDetector
-from .fall_detector import FallDetectionTracker
+from .fall_detector import create_fall_tracker
 from .inactivity import InactivityDetector
 from .posture import classify_posture
 
@@ -41,7 +41,7 @@ class StreamWorker:
         self,
         app_config: AppConfig,
         stream: IPCStreamConfig,
-        frame_hub: FrameHub,
+        frame_hub: FrameHub | SharedFrameHub,
         db_client: DatabaseClient,
     ) -> None:
         self.app_config = app_config
@@ -176,7 +176,7 @@ class StreamWorker:
                     break
                 continue
 
-            fall_tracker = FallDetectionTracker()
+            fall_tracker = create_fall_tracker()
 
             generator = None
             try:
@@ -242,14 +242,26 @@ class StreamWorker:
                             else np.empty((0, 17, 2))
                         )
 
+                        # 同一幀共用一個時間戳，跌倒特徵一次算完所有人員
+                        now_ms = _unix_time_ms()
+                        count = min(len(ids), len(xyxy_all), len(keypoints_all))
+                        fall_detections = []
+                        if self.stream.fall_detection_enabled and count > 0:
+                            boxes_f64 = xyxy_all[:count].astype(np.float64)
+                            fall_detections = fall_tracker.evaluate_batch(
+                                ids[:count],
+                                boxes_f64[:, 3] - boxes_f64[:, 1],
+                                keypoints_all[:count],
+                                now_ms,
+                            )
+
                         for i, pid in enumerate(ids):
-                            if i >= len(xyxy_all) or i >= len(keypoints_all):
+                            if i >= count:
                                 continue
                             xyxy = xyxy_all[i]
                             kpt = keypoints_all[i]
                             x1, y1, x2, y2 = map(float, xyxy)
                             height = y2 - y1
-                            now_ms = _unix_time_ms()
                             int_pid = int(pid)
 
                             if self._inactivity_detector.is_enabled():
@@ -327,12 +339,7 @@ class StreamWorker:
 
                             # 跌倒辨識
                             if self.stream.fall_detection_enabled:
-                                detection = fall_tracker.evaluate(
-                                    pid,
-                                    height,
-                                    kpt,
-                                    now_ms,
-                                )
+                                detection = fall_detections[i]
 
                                 log_line = detection.log_line
                                 if self.app_config.debug:
@@ -0,0 +1,60 @@
+#include "fall_features/c_api.hpp"
+
+#include <span>
+#include <type_traits>
+
+using edge_vision::fall_features::FallFeatures;
+using edge_vision::fall_features::FallTracker;
+
+static_assert(std::is_standard_layout_v<FallFeatures>);
+static_assert(sizeof(FallFeatures) == 48);
+
+struct EdgeFallTracker {
+  FallTracker tracker;
+};
+
+extern "C" {
+
+EdgeFallTracker* edge_fall_tracker_create(uint32_t capacity) {
+  return new EdgeFallTracker{FallTracker(
+      capacity == 0 ? FallTracker::kDefaultCapacity : capacity)};
+}
+
+void edge_fall_tracker_destroy(EdgeFallTracker* tracker) {
+  delete tracker;
+}
+
+void edge_fall_tracker_reset(EdgeFallTracker* tracker) {
+  if (tracker) {
+    tracker->tracker.Reset();
+  }
+}
+
+size_t edge_fall_tracker_tracked(const EdgeFallTracker* tracker) {
+  return tracker ? tracker->tracker.tracked() : 0;
+}
+
+int edge_fall_tracker_evaluate(
+    EdgeFallTracker* tracker,
+    const int64_t* ids,
+    const double* box_heights,
+    const float* keypoints,
+    size_t count,
+    size_t keypoint_count,
+    int64_t timestamp_ms,
+    EdgeFallFeatures* out) {
+  if (!tracker || (count > 0 && (!ids || !box_heights || !out))) {
+    return 0;
+  }
+  return tracker->tracker.Evaluate(
+             std::span(ids, count),
+             std::span(box_heights, count),
+             keypoints,
+             keypoint_count,
+             timestamp_ms,
+             std::span(out, count))
+      ? 1
+      : 0;
+}
+
+} // extern "C"
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fall_features/fall_tracker.hpp"
+
+// 供 Python（ctypes）呼叫的 C ABI；結構須與 Vision/fall_detector.py
+// 中的 numpy dtype 保持一致
+
+extern "C" {
+
+struct EdgeFallTracker;
+using EdgeFallFeatures = edge_vision::fall_features::FallFeatures;
+
+EdgeFallTracker* edge_fall_tracker_create(uint32_t capacity);
+void edge_fall_tracker_destroy(EdgeFallTracker* tracker);
+void edge_fall_tracker_reset(EdgeFallTracker* tracker);
+size_t edge_fall_tracker_tracked(const EdgeFallTracker* tracker);
+
+// 計算一幀中 count 位人員的特徵：ids 與 box_heights 各 count 筆，
+// keypoints 為 count × keypoint_count × 2 的 float32 連續陣列，
+// 結果寫入 out[0..count)。成功回傳 1，參數不合法回傳 0
+int edge_fall_tracker_evaluate(
+    EdgeFallTracker* tracker,
+    const int64_t* ids,
+    const double* box_heights,
+    const float* keypoints,
+    size_t count,
+    size_t keypoint_count,
+    int64_t timestamp_ms,
+    EdgeFallFeatures* out);
+
+} // extern "C"
@@ -0,0 +1,279 @@
+#include "fall_features/fall_tracker.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+namespace edge_vision::fall_features {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+// 與 math.degrees 相同的換算常數
+constexpr double kRadToDeg = 180.0 / std::numbers::pi;
+// np.isclose(x, 0.0) 的 atol：座標兩軸都接近 0 的關節點視為未偵測到
+constexpr float kZeroTolerance = 1e-8f;
+
+// COCO 關節點索引
+constexpr size_t kNose = 0;
+constexpr size_t kLeftShoulder = 5;
+constexpr size_t kRightShoulder = 6;
+constexpr size_t kLeftHip = 11;
+constexpr size_t kRightHip = 12;
+constexpr size_t kLeftAnkle = 15;
+constexpr size_t kRightAnkle = 16;
+
+// 等同 Python 的 round(x, 3)：以精確的十進位轉換捨入。角速度是兩個
+// 三位小數相減後再除，常落在進位中點，nearbyint(x * 1000) 會差一位
+double Round3(double value) {
+  if (!std::isfinite(value)) {
+    return value;
+  }
+  char buffer[64];
+  const auto written = std::to_chars(
+      buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 3);
+  double rounded = value;
+  std::from_chars(buffer, written.ptr, rounded);
+  return rounded;
+}
+
+// 以位元運算取代短路求值，讓迴圈保持沒有分支
+float Valid(float x, float y) {
+  return static_cast<float>(
+      (std::fabs(x) > kZeroTolerance) | (std::fabs(y) > kZeroTolerance));
+}
+
+/**
+ * 所有人員的肩腰向量與頭踝距離。不含分支與函式呼叫（sqrt 需搭配
+ * -fno-math-errno），缺少的關節點以權重 0 排除，平均值與 numpy 一樣先
+ * 相加再除以有效點數（float32）。
+ */
+void ComputeGeometry(
+    const float* __restrict keypoints,
+    size_t stride,
+    size_t count,
+    float* __restrict body_dx,
+    float* __restrict body_dy,
+    float* __restrict head_ankle,
+    uint8_t* __restrict has_body,
+    uint8_t* __restrict has_head_ankle) {
+  for (size_t i = 0; i < count; ++i) {
+    const float* p = keypoints + i * stride;
+    const float nx = p[kNose * 2];
+    const float ny = p[kNose * 2 + 1];
+    const float lsx = p[kLeftShoulder * 2];
+    const float lsy = p[kLeftShoulder * 2 + 1];
+    const float rsx = p[kRightShoulder * 2];
+    const float rsy = p[kRightShoulder * 2 + 1];
+    const float lhx = p[kLeftHip * 2];
+    const float lhy = p[kLeftHip * 2 + 1];
+    const float rhx = p[kRightHip * 2];
+    const float rhy = p[kRightHip * 2 + 1];
+    const float lax = p[kLeftAnkle * 2];
+    const float lay = p[kLeftAnkle * 2 + 1];
+    const float rax = p[kRightAnkle * 2];
+    const float ray = p[kRightAnkle * 2 + 1];
+
+    const float w_nose = Valid(nx, ny);
+    const float w_ls = Valid(lsx, lsy);
+    const float w_rs = Valid(rsx, rsy);
+    const float w_lh = Valid(lhx, lhy);
+    const float w_rh = Valid(rhx, rhy);
+    const float w_la = Valid(lax, lay);
+    const float w_ra = Valid(rax, ray);
+
+    const float shoulders = w_ls + w_rs;
+    const float hips = w_lh + w_rh;
+    const float ankles = w_la + w_ra;
+    // 有效點數為 0 時以 1 代替，結果由旗標排除
+    const float shoulder_div = std::max(shoulders, 1.0f);
+    const float hip_div = std::max(hips, 1.0f);
+    const float ankle_div = std::max(ankles, 1.0f);
+
+    const float sx = (lsx * w_ls + rsx * w_rs) / shoulder_div;
+    const float sy = (lsy * w_ls + rsy * w_rs) / shoulder_div;
+    const float hx = (lhx * w_lh + rhx * w_rh) / hip_div;
+    const float hy = (lhy * w_lh + rhy * w_rh) / hip_div;
+    body_dx[i] = hx - sx;
+    body_dy[i] = hy - sy;
+    has_body[i] = (shoulders > 0.0f) & (hips > 0.0f);
+
+    const float ax = (lax * w_la + rax * w_ra) / ankle_div;
+    const float ay = (lay * w_la + ray * w_ra) / ankle_div;
+    const float vx = ax - nx;
+    const float vy = ay - ny;
+    head_ankle[i] = std::sqrt(vx * vx + vy * vy);
+    has_head_ankle[i] = (w_nose > 0.0f) & (ankles > 0.0f);
+  }
+}
+
+} // namespace
+
+int32_t InferLabel(
+    double tilt_deg, double height_ratio, double omega_deg_s, double box_rate) {
+  if (std::isnan(tilt_deg) || std::isnan(height_ratio) ||
+      std::isnan(omega_deg_s) || std::isnan(box_rate)) {
+    return 0;
+  }
+  const bool base_condition = tilt_deg > 55.0 && height_ratio > 1.1 &&
+      omega_deg_s > 80 && box_rate < -0.5;
+  const bool fast_collapse = omega_deg_s > 100 && box_rate < -0.2;
+  const bool fast_rotation = omega_deg_s > 170;
+  return base_condition || fast_collapse || fast_rotation ? 1 : 0;
+}
+
+FallTracker::FallTracker(uint32_t capacity) {
+  const size_t slots = std::max<uint32_t>(capacity, 1);
+  ids_.resize(slots);
+  used_.resize(slots);
+  last_frame_.resize(slots);
+  has_box_.resize(slots);
+  box_height_.resize(slots);
+  box_ts_.resize(slots);
+  tilt_.resize(slots, kNaN);
+  tilt_ts_.resize(slots);
+}
+
+void FallTracker::Grow() {
+  const size_t slots = ids_.size() * 2;
+  ids_.resize(slots);
+  used_.resize(slots);
+  last_frame_.resize(slots);
+  has_box_.resize(slots);
+  box_height_.resize(slots);
+  box_ts_.resize(slots);
+  tilt_.resize(slots, kNaN);
+  tilt_ts_.resize(slots);
+}
+
+uint32_t FallTracker::SlotFor(int64_t id) {
+  const size_t slots = ids_.size();
+  for (size_t s = 0; s < slots; ++s) {
+    if (used_[s] && ids_[s] == id) {
+      last_frame_[s] = frame_;
+      return static_cast<uint32_t>(s);
+    }
+  }
+
+  // 新 track：優先使用空的 slot，否則淘汰最久未出現者
+  size_t slot = 0;
+  for (size_t s = 0; s < slots; ++s) {
+    if (!used_[s]) {
+      slot = s;
+      break;
+    }
+    if (last_frame_[s] < last_frame_[slot]) {
+      slot = s;
+    }
+  }
+  if (used_[slot] && last_frame_[slot] == frame_) {
+    // 同一幀內的 track 數超過容量
+    slot = slots;
+    Grow();
+  }
+  ids_[slot] = id;
+  used_[slot] = 1;
+  last_frame_[slot] = frame_;
+  has_box_[slot] = 0;
+  tilt_[slot] = kNaN;
+  return static_cast<uint32_t>(slot);
+}
+
+bool FallTracker::Evaluate(
+    std::span<const int64_t> ids,
+    std::span<const double> box_heights,
+    const float* keypoints,
+    size_t keypoint_count,
+    int64_t timestamp_ms,
+    std::span<FallFeatures> out) {
+  const size_t count = ids.size();
+  if (keypoint_count < kMinKeypoints || box_heights.size() != count ||
+      out.size() != count || (count > 0 && keypoints == nullptr)) {
+    return false;
+  }
+
+  body_dx_.resize(count);
+  body_dy_.resize(count);
+  head_ankle_.resize(count);
+  has_body_.resize(count);
+  has_head_ankle_.resize(count);
+  ComputeGeometry(
+      keypoints,
+      keypoint_count * 2,
+      count,
+      body_dx_.data(),
+      body_dy_.data(),
+      head_ankle_.data(),
+      has_body_.data(),
+      has_head_ankle_.data());
+
+  // 依序套用 track 狀態；同一幀重複的 ID 與 Python 版一樣看到前一筆的結果
+  ++frame_;
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t slot = SlotFor(ids[i]);
+    const double height = box_heights[i];
+    FallFeatures& features = out[i];
+    features.reserved = 0;
+
+    features.box_ratio = 1.0;
+    features.box_rate = 0.0;
+    if (has_box_[slot] && box_height_[slot] > 0.0) {
+      const int64_t dt_ms = timestamp_ms - box_ts_[slot];
+      if (dt_ms > 0) {
+        const double ratio = height / std::max(box_height_[slot], 1e-6);
+        features.box_ratio = Round3(ratio);
+        features.box_rate = Round3((ratio - 1.0) / (dt_ms / 1000.0));
+      }
+    }
+
+    features.tilt_deg = kNaN;
+    if (has_body_[i]) {
+      const double angle = std::atan2(
+          static_cast<double>(body_dx_[i]),
+          static_cast<double>(body_dy_[i]) + 1e-9);
+      features.tilt_deg = Round3(std::fabs(angle * kRadToDeg));
+    }
+
+    if (std::isnan(features.tilt_deg)) {
+      features.omega_deg_s = kNaN;
+    } else if (std::isnan(tilt_[slot])) {
+      features.omega_deg_s = 0.0;
+    } else {
+      const int64_t dt_ms = timestamp_ms - tilt_ts_[slot];
+      features.omega_deg_s = dt_ms > 0
+          ? Round3(std::fabs(
+                (features.tilt_deg - tilt_[slot]) / (dt_ms / 1000.0)))
+          : 0.0;
+    }
+    tilt_[slot] = features.tilt_deg;
+    tilt_ts_[slot] = timestamp_ms;
+
+    features.height_ratio = has_head_ankle_[i]
+        ? Round3(static_cast<double>(head_ankle_[i]) / std::max(height, 1e-6))
+        : kNaN;
+
+    features.label_weak = InferLabel(
+        features.tilt_deg,
+        features.height_ratio,
+        features.omega_deg_s,
+        features.box_rate);
+
+    has_box_[slot] = 1;
+    box_height_[slot] = height;
+    box_ts_[slot] = timestamp_ms;
+  }
+  return true;
+}
+
+void FallTracker::Reset() {
+  std::ranges::fill(used_, 0);
+  frame_ = 0;
+}
+
+size_t FallTracker::tracked() const {
+  return static_cast<size_t>(std::ranges::count(used_, 1));
+}
+
+} // namespace edge_vision::fall_features
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace edge_vision::fall_features {
+
+// COCO 姿態的關節點數；至少需要到右腳踝（索引 16）
+inline constexpr size_t kMinKeypoints = 17;
+
+/**
+ * 單一人員在一幀中的跌倒特徵，欄位與 Vision/fall_detector.py 的除錯
+ * 輸出相同，數值同樣四捨五入到小數第三位。標準佈局，直接作為 C ABI
+ * 的輸出結構。
+ */
+struct FallFeatures {
+  double tilt_deg; // 肩腰向量相對垂直軸的傾角，缺關節點時為 NaN
+  double omega_deg_s; // 傾角的角速度
+  double box_ratio; // 框高相對上一幀的比例
+  double box_rate; // 框高比例的每秒變化率
+  double height_ratio; // 頭至腳踝距離與框高的比值，缺關節點時為 NaN
+  int32_t label_weak;
+  int32_t reserved;
+};
+
+// 與 fall_detector.infer_labels 相同的啟發式規則
+int32_t InferLabel(
+    double tilt_deg, double height_ratio, double omega_deg_s, double box_rate);
+
+/**
+ * FallDetectionTracker 的批次版本。每幀一次處理所有人員：先以不分支的
+ * structure-of-arrays 迴圈算出所有人的肩腰向量與頭踝距離（編譯器可
+ * 向量化），再依序套用各 track 的前一幀狀態。
+ *
+ * 狀態以 slot 為索引存放在平行的扁平陣列，track ID 以線性掃描對應到
+ * slot；slot 用完時淘汰最久未出現的 track，同一幀內的 track 超過容量則
+ * 擴充。
+ */
+class FallTracker {
+ public:
+  static constexpr uint32_t kDefaultCapacity = 64;
+
+  explicit FallTracker(uint32_t capacity = kDefaultCapacity);
+
+  // keypoints 為 ids.size() × keypoint_count × 2 的 float32（x, y）連續
+  // 陣列；keypoint_count 小於 kMinKeypoints 或長度不符時回傳 false
+  bool Evaluate(
+      std::span<const int64_t> ids,
+      std::span<const double> box_heights,
+      const float* keypoints,
+      size_t keypoint_count,
+      int64_t timestamp_ms,
+      std::span<FallFeatures> out);
+
+  void Reset();
+  size_t tracked() const;
+
+ private:
+  uint32_t SlotFor(int64_t id);
+  void Grow();
+
+  // 以 slot 為索引的 track 狀態
+  std::vector<int64_t> ids_;
+  std::vector<uint8_t> used_;
+  std::vector<uint64_t> last_frame_;
+  std::vector<uint8_t> has_box_;
+  std::vector<double> box_height_;
+  std::vector<int64_t> box_ts_;
+  // NaN 代表沒有前一幀的傾角
+  std::vector<double> tilt_;
+  std::vector<int64_t> tilt_ts_;
+  uint64_t frame_ = 0;
+
+  // 每幀的幾何暫存（structure of arrays），重複使用避免配置
+  std::vector<float> body_dx_;
+  std::vector<float> body_dy_;
+  std::vector<float> head_ankle_;
+  std::vector<uint8_t> has_body_;
+  std::vector<uint8_t> has_head_ankle_;
+};
+
+} // namespace edge_vision::fall_features
@@ -0,0 +1,160 @@
+#include "frame_bus/c_api.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using edge_vision::frame_bus::FrameBus;
+using edge_vision::frame_bus::FrameInfo;
+using edge_vision::frame_bus::FrameShape;
+using edge_vision::frame_bus::FrameView;
+
+struct EdgeFrameBus {
+  std::unique_ptr<FrameBus> bus;
+};
+
+struct EdgeFrameLease {
+  FrameView view;
+};
+
+namespace {
+
+void FillInfo(const FrameInfo& info, EdgeFrameInfo* out) {
+  if (!out) {
+    return;
+  }
+  out->height = info.shape.height;
+  out->width = info.shape.width;
+  out->channels = info.shape.channels;
+  out->timestamp_ms = info.timestamp_ms;
+  out->sequence = info.sequence;
+  const size_t length = std::min(info.label.size(), sizeof(out->label) - 1);
+  std::memcpy(out->label, info.label.data(), length);
+  out->label[length] = '\0';
+  out->label_length = static_cast<uint32_t>(length);
+}
+
+EdgeFrameBus* Wrap(std::unique_ptr<FrameBus> bus) {
+  if (!bus) {
+    return nullptr;
+  }
+  return new EdgeFrameBus{std::move(bus)};
+}
+
+} // namespace
+
+extern "C" {
+
+EdgeFrameBus* edge_frame_bus_create(const char* name, uint32_t max_streams) {
+  return name ? Wrap(FrameBus::Create(name, max_streams)) : nullptr;
+}
+
+EdgeFrameBus* edge_frame_bus_open(const char* name) {
+  return name ? Wrap(FrameBus::Open(name)) : nullptr;
+}
+
+void edge_frame_bus_close(EdgeFrameBus* bus) {
+  delete bus;
+}
+
+void edge_frame_bus_unlink(EdgeFrameBus* bus) {
+  if (bus) {
+    bus->bus->Unlink();
+  }
+}
+
+uint32_t edge_frame_bus_max_streams(const EdgeFrameBus* bus) {
+  return bus ? bus->bus->max_streams() : 0;
+}
+
+int edge_frame_bus_publish(
+    EdgeFrameBus* bus,
+    const char* stream_id,
+    const char* label,
+    const uint8_t* data,
+    uint32_t height,
+    uint32_t width,
+    uint32_t channels,
+    int64_t timestamp_ms) {
+  if (!bus || !stream_id) {
+    return 0;
+  }
+  return bus->bus->Publish(
+             stream_id,
+             label ? label : "",
+             data,
+             FrameShape{height, width, channels},
+             timestamp_ms)
+      ? 1
+      : 0;
+}
+
+void edge_frame_bus_remove(EdgeFrameBus* bus, const char* stream_id) {
+  if (bus && stream_id) {
+    bus->bus->Remove(stream_id);
+  }
+}
+
+size_t edge_frame_bus_streams(
+    const EdgeFrameBus* bus, char* out, size_t capacity) {
+  if (!bus) {
+    return 0;
+  }
+  std::string joined;
+  for (const auto& stream_id : bus->bus->Streams()) {
+    if (!joined.empty()) {
+      joined.push_back('\n');
+    }
+    joined.append(stream_id);
+  }
+  const size_t required = joined.size() + 1;
+  if (out && capacity >= required) {
+    std::memcpy(out, joined.c_str(), required);
+  }
+  return required;
+}
+
+int edge_frame_bus_read(
+    const EdgeFrameBus* bus,
+    const char* stream_id,
+    uint8_t* out,
+    size_t capacity,
+    EdgeFrameInfo* info) {
+  if (!bus || !stream_id) {
+    return static_cast<int>(edge_vision::frame_bus::ReadStatus::kNotFound);
+  }
+  FrameInfo frame_info;
+  const auto status =
+      bus->bus->ReadLatest(stream_id, out, capacity, &frame_info);
+  FillInfo(frame_info, info);
+  return static_cast<int>(status);
+}
+
+EdgeFrameLease* edge_frame_bus_acquire(
+    const EdgeFrameBus* bus,
+    const char* stream_id,
+    EdgeFrameInfo* info,
+    const uint8_t** data) {
+  if (!bus || !stream_id) {
+    return nullptr;
+  }
+  auto view = bus->bus->Acquire(stream_id);
+  if (!view) {
+    return nullptr;
+  }
+  FillInfo(view->info, info);
+  if (data) {
+    *data = view->data;
+  }
+  return new EdgeFrameLease{std::move(*view)};
+}
+
+int edge_frame_bus_validate(const EdgeFrameLease* lease) {
+  return lease && FrameBus::Validate(lease->view) ? 1 : 0;
+}
+
+void edge_frame_bus_release(EdgeFrameLease* lease) {
+  delete lease;
+}
+
+} // extern "C"
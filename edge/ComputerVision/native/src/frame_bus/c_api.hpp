@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "frame_bus/frame_bus.hpp"
+
+// 供 Python（ctypes）呼叫的 C ABI；結構與回傳值須與
+// Vision/frame_bus.py 中的定義保持一致
+
+extern "C" {
+
+struct EdgeFrameBus;
+struct EdgeFrameLease;
+
+struct EdgeFrameInfo {
+  uint32_t height;
+  uint32_t width;
+  uint32_t channels;
+  uint32_t label_length;
+  int64_t timestamp_ms;
+  uint64_t sequence;
+  char label[edge_vision::frame_bus::kMaxLabelLength + 1];
+};
+
+// 失敗時回傳 nullptr
+EdgeFrameBus* edge_frame_bus_create(const char* name, uint32_t max_streams);
+EdgeFrameBus* edge_frame_bus_open(const char* name);
+void edge_frame_bus_close(EdgeFrameBus* bus);
+void edge_frame_bus_unlink(EdgeFrameBus* bus);
+uint32_t edge_frame_bus_max_streams(const EdgeFrameBus* bus);
+
+// 成功回傳 1，失敗回傳 0
+int edge_frame_bus_publish(
+    EdgeFrameBus* bus,
+    const char* stream_id,
+    const char* label,
+    const uint8_t* data,
+    uint32_t height,
+    uint32_t width,
+    uint32_t channels,
+    int64_t timestamp_ms);
+void edge_frame_bus_remove(EdgeFrameBus* bus, const char* stream_id);
+
+// 以 '\n' 分隔的串流 ID 寫入 out（含結尾 '\0'），回傳所需的位元組數；
+// 大於 capacity 時 out 內容不完整，呼叫端應以回傳值重新配置
+size_t edge_frame_bus_streams(
+    const EdgeFrameBus* bus, char* out, size_t capacity);
+
+// 回傳 edge_vision::frame_bus::ReadStatus 的數值
+int edge_frame_bus_read(
+    const EdgeFrameBus* bus,
+    const char* stream_id,
+    uint8_t* out,
+    size_t capacity,
+    EdgeFrameInfo* info);
+
+// 零複製讀取；lease 存活期間 data 有效，使用完畢後以 validate 確認
+// 期間未被覆寫，再以 release 釋放。沒有畫面時回傳 nullptr
+EdgeFrameLease* edge_frame_bus_acquire(
+    const EdgeFrameBus* bus,
+    const char* stream_id,
+    EdgeFrameInfo* info,
+    const uint8_t** data);
+int edge_frame_bus_validate(const EdgeFrameLease* lease);
+void edge_frame_bus_release(EdgeFrameLease* lease);
+
+} // extern "C"
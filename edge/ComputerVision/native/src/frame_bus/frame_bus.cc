@@ -0,0 +1,766 @@
+#include "frame_bus/frame_bus.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace edge_vision::frame_bus {
+
+namespace {
+
+constexpr uint32_t kDirectoryMagic = 0x53554246; // "FBUS"
+constexpr uint32_t kSegmentMagic = 0x47534246; // "FBSG"
+constexpr uint32_t kLayoutVersion = 1;
+constexpr uint32_t kNoSlot = UINT32_MAX;
+constexpr size_t kCacheLine = 64;
+// 讀取端遇到寫入中的格子時的重試次數；發布端每格只寫一次，
+// 連續撞上代表畫面極大或發布頻率異常
+constexpr int kMaxReadAttempts = 8;
+// 另一個行程剛建立目錄、尚未寫入 magic 時的等待上限
+constexpr auto kInitWait = std::chrono::seconds(1);
+constexpr size_t kMaxNameLength = 200;
+
+enum EntryState : uint32_t {
+  kFree = 0,
+  kClaimed = 1, // 發布端正在建立或移除
+  kActive = 2,
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+constexpr size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+struct SlotHeader {
+  alignas(kCacheLine) std::atomic<uint64_t> seq;
+  uint32_t height;
+  uint32_t width;
+  uint32_t channels;
+  uint32_t label_length;
+  int64_t timestamp_ms;
+  uint64_t sequence;
+  char label[kMaxLabelLength + 1];
+};
+
+struct SegmentHeader {
+  std::atomic<uint32_t> magic;
+  uint32_t layout_version;
+  uint64_t capacity;
+  alignas(kCacheLine) std::atomic<uint32_t> latest;
+  std::atomic<uint64_t> published;
+  SlotHeader slots[kSlotCount];
+};
+
+constexpr size_t kSegmentDataOffset =
+    AlignUp(sizeof(SegmentHeader), kCacheLine);
+
+// 串流 ID 與標籤以 UTF-8 儲存，截斷時退回到完整字元的邊界
+size_t TruncateUtf8(std::string_view text, size_t limit) {
+  if (text.size() <= limit) {
+    return text.size();
+  }
+  size_t length = limit;
+  while (length > 0 &&
+         (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) {
+    --length;
+  }
+  return length;
+}
+
+std::optional<std::string> NormalizeName(std::string_view name) {
+  if (!name.empty() && name.front() == '/') {
+    name.remove_prefix(1);
+  }
+  if (name.empty() || name.size() > kMaxNameLength ||
+      name.find('/') != std::string_view::npos) {
+    return std::nullopt;
+  }
+  return "/" + std::string(name);
+}
+
+struct ProcessStat {
+  char state = '?';
+  // 開機後的 clock tick，/proc/<pid>/stat 第 22 欄
+  uint64_t start_time = 0;
+};
+
+std::optional<ProcessStat> ReadProcessStat(pid_t pid) {
+  std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+  std::string content;
+  std::getline(file, content);
+  // 第 2 欄的行程名稱可能含空白與括號，從最後一個 ')' 之後開始數
+  const auto name_end = content.rfind(')');
+  if (name_end == std::string::npos) {
+    return std::nullopt;
+  }
+  std::istringstream fields(content.substr(name_end + 1));
+  ProcessStat stat;
+  std::string field;
+  for (int column = 3; fields >> field; ++column) {
+    if (column == 3) {
+      stat.state = field.front();
+    } else if (column == 22) {
+      stat.start_time = std::strtoull(field.c_str(), nullptr, 10);
+      return stat;
+    }
+  }
+  return std::nullopt;
+}
+
+// pid 會被重用，因此除了行程存在之外還要比對啟動時間；已結束但尚未被
+// 回收的 zombie 也視為不存在
+bool IsProcessAlive(int32_t pid, uint64_t start_time) {
+  if (pid <= 0) {
+    return false;
+  }
+  if (kill(pid, 0) != 0 && errno == ESRCH) {
+    return false;
+  }
+  const auto stat = ReadProcessStat(pid);
+  if (!stat) {
+    return true;
+  }
+  return stat->state != 'Z' && stat->state != 'X' &&
+      (start_time == 0 || stat->start_time == start_time);
+}
+
+struct Mapping {
+  void* base = MAP_FAILED;
+  size_t size = 0;
+};
+
+// 映射已開啟的 fd；expected_size 為 0 時以檔案大小為準
+Mapping MapFd(int fd, bool writable, size_t expected_size) {
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    return {};
+  }
+  const auto size = static_cast<size_t>(st.st_size);
+  if (size == 0 || (expected_size != 0 && size < expected_size)) {
+    return {};
+  }
+  const int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+  void* base = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    return {};
+  }
+  return {base, size};
+}
+
+} // namespace
+
+/**
+ * 單一串流的資料區段：標頭之後依序放三格畫面，每格 capacity 位元組。
+ * 讀取端以 shared_ptr 持有，串流換區段或移除後仍可安全讀完手上的格子。
+ */
+class Segment {
+ public:
+  static std::shared_ptr<Segment> Create(
+      const std::string& name, size_t capacity) {
+    capacity = AlignUp(std::max<size_t>(capacity, 1), kCacheLine);
+    const size_t size = kSegmentDataOffset + capacity * kSlotCount;
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (fd < 0 && errno == EEXIST) {
+      // 前一個發布者異常結束留下的同名區段
+      shm_unlink(name.c_str());
+      fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+    }
+    if (fd < 0) {
+      return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      close(fd);
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+    const Mapping mapping = MapFd(fd, true, size);
+    close(fd);
+    if (mapping.base == MAP_FAILED) {
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+    auto* header = new (mapping.base) SegmentHeader{};
+    header->layout_version = kLayoutVersion;
+    header->capacity = capacity;
+    header->latest.store(kNoSlot, std::memory_order_relaxed);
+    header->published.store(0, std::memory_order_relaxed);
+    for (auto& slot : header->slots) {
+      slot.seq.store(0, std::memory_order_relaxed);
+    }
+    header->magic.store(kSegmentMagic, std::memory_order_release);
+    return std::shared_ptr<Segment>(new Segment(mapping.base, mapping.size));
+  }
+
+  static std::shared_ptr<const Segment> Open(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      return nullptr;
+    }
+    const Mapping mapping = MapFd(fd, false, kSegmentDataOffset);
+    close(fd);
+    if (mapping.base == MAP_FAILED) {
+      return nullptr;
+    }
+    std::shared_ptr<const Segment> segment(
+        new Segment(mapping.base, mapping.size));
+    const auto* header = segment->header();
+    if (header->magic.load(std::memory_order_acquire) != kSegmentMagic ||
+        header->layout_version != kLayoutVersion ||
+        kSegmentDataOffset + header->capacity * kSlotCount > mapping.size) {
+      return nullptr;
+    }
+    return segment;
+  }
+
+  ~Segment() { munmap(base_, size_); }
+
+  Segment(const Segment&) = delete;
+  Segment& operator=(const Segment&) = delete;
+
+  SegmentHeader* header() const { return static_cast<SegmentHeader*>(base_); }
+  size_t capacity() const { return header()->capacity; }
+
+  uint8_t* slot_data(uint32_t slot) const {
+    return static_cast<uint8_t*>(base_) + kSegmentDataOffset +
+        capacity() * slot;
+  }
+
+ private:
+  Segment(void* base, size_t size) : base_(base), size_(size) {}
+
+  void* base_;
+  size_t size_;
+};
+
+struct FrameBus::Entry {
+  // 保護 id_length、stream_id 與 epoch 的 seqlock；奇數代表修改中
+  alignas(kCacheLine) std::atomic<uint64_t> seq;
+  std::atomic<uint32_t> state;
+  uint32_t id_length;
+  // 資料區段的版本，每次換區段遞增，移除後重新建立也不歸零
+  std::atomic<uint64_t> epoch;
+  char stream_id[kMaxStreamIdLength + 1];
+  // 目前發布者的 pid 與啟動時間，持有 kClaimed 時寫入
+  std::atomic<int32_t> owner_pid;
+  std::atomic<uint64_t> owner_start_time;
+};
+
+struct FrameBus::Directory {
+  alignas(kCacheLine) std::atomic<uint32_t> magic;
+  uint32_t layout_version;
+  uint32_t max_streams;
+
+  Entry* entries() {
+    return reinterpret_cast<Entry*>(
+        reinterpret_cast<char*>(this) + AlignUp(sizeof(Directory), kCacheLine));
+  }
+
+  static size_t SizeFor(uint32_t max_streams) {
+    return AlignUp(sizeof(Directory), kCacheLine) +
+        sizeof(Entry) * max_streams;
+  }
+};
+
+std::unique_ptr<FrameBus> FrameBus::Create(
+    std::string_view name, uint32_t max_streams) {
+  const auto normalized = NormalizeName(name);
+  if (!normalized || max_streams == 0) {
+    return nullptr;
+  }
+  const size_t size = Directory::SizeFor(max_streams);
+  int fd = shm_open(normalized->c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+  if (fd >= 0) {
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      close(fd);
+      shm_unlink(normalized->c_str());
+      return nullptr;
+    }
+    const Mapping mapping = MapFd(fd, true, size);
+    close(fd);
+    if (mapping.base == MAP_FAILED) {
+      shm_unlink(normalized->c_str());
+      return nullptr;
+    }
+    auto* directory = new (mapping.base) Directory{};
+    directory->layout_version = kLayoutVersion;
+    directory->max_streams = max_streams;
+    for (uint32_t i = 0; i < max_streams; ++i) {
+      new (&directory->entries()[i]) Entry{};
+    }
+    directory->magic.store(kDirectoryMagic, std::memory_order_release);
+    return std::unique_ptr<FrameBus>(
+        new FrameBus(*normalized, mapping.base, mapping.size, true));
+  }
+  if (errno != EEXIST) {
+    return nullptr;
+  }
+
+  // 已存在：沿用既有的目錄（容量以先建立者為準）
+  fd = shm_open(normalized->c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    return nullptr;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + kInitWait;
+  Mapping mapping;
+  while (true) {
+    mapping = MapFd(fd, true, sizeof(Directory));
+    if (mapping.base != MAP_FAILED) {
+      const auto* directory = static_cast<const Directory*>(mapping.base);
+      if (directory->magic.load(std::memory_order_acquire) ==
+          kDirectoryMagic) {
+        break;
+      }
+      munmap(mapping.base, mapping.size);
+      mapping = {};
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      close(fd);
+      return nullptr;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  close(fd);
+  const auto* directory = static_cast<const Directory*>(mapping.base);
+  if (directory->layout_version != kLayoutVersion ||
+      Directory::SizeFor(directory->max_streams) > mapping.size) {
+    munmap(mapping.base, mapping.size);
+    return nullptr;
+  }
+  std::unique_ptr<FrameBus> bus(
+      new FrameBus(*normalized, mapping.base, mapping.size, true));
+  bus->ReapStaleEntries();
+  return bus;
+}
+
+std::unique_ptr<FrameBus> FrameBus::Open(std::string_view name) {
+  const auto normalized = NormalizeName(name);
+  if (!normalized) {
+    return nullptr;
+  }
+  const int fd = shm_open(normalized->c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return nullptr;
+  }
+  const Mapping mapping = MapFd(fd, false, sizeof(Directory));
+  close(fd);
+  if (mapping.base == MAP_FAILED) {
+    return nullptr;
+  }
+  const auto* directory = static_cast<const Directory*>(mapping.base);
+  if (directory->magic.load(std::memory_order_acquire) != kDirectoryMagic ||
+      directory->layout_version != kLayoutVersion ||
+      Directory::SizeFor(directory->max_streams) > mapping.size) {
+    munmap(mapping.base, mapping.size);
+    return nullptr;
+  }
+  return std::unique_ptr<FrameBus>(
+      new FrameBus(*normalized, mapping.base, mapping.size, false));
+}
+
+FrameBus::FrameBus(std::string name, void* base, size_t size, bool writable)
+    : name_(std::move(name)),
+      directory_(static_cast<Directory*>(base)),
+      directory_size_(size),
+      writable_(writable) {}
+
+FrameBus::~FrameBus() {
+  {
+    std::lock_guard lock(mutex_);
+    publishers_.clear();
+    readers_.clear();
+  }
+  munmap(directory_, directory_size_);
+}
+
+uint32_t FrameBus::max_streams() const {
+  return directory_->max_streams;
+}
+
+std::string FrameBus::SegmentName(uint32_t index, uint64_t epoch) const {
+  return name_ + "." + std::to_string(index) + "." + std::to_string(epoch);
+}
+
+std::optional<uint32_t> FrameBus::FindEntry(std::string_view stream_id) const {
+  for (uint32_t i = 0; i < directory_->max_streams; ++i) {
+    if (ReadEpoch(i, stream_id)) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<uint64_t> FrameBus::ReadEpoch(
+    uint32_t index, std::string_view stream_id) const {
+  const Entry& entry = directory_->entries()[index];
+  for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    if (entry.state.load(std::memory_order_acquire) != kActive) {
+      return std::nullopt;
+    }
+    const uint64_t before = entry.seq.load(std::memory_order_acquire);
+    if (before & 1) {
+      continue;
+    }
+    const bool matches = entry.id_length == stream_id.size() &&
+        std::memcmp(entry.stream_id, stream_id.data(), stream_id.size()) == 0;
+    const uint64_t epoch = entry.epoch.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.seq.load(std::memory_order_relaxed) == before) {
+      return matches ? std::optional(epoch) : std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
+
+std::shared_ptr<const Segment> FrameBus::ResolveSegment(
+    std::string_view stream_id) const {
+  for (uint32_t i = 0; i < directory_->max_streams; ++i) {
+    const auto epoch = ReadEpoch(i, stream_id);
+    if (!epoch) {
+      continue;
+    }
+    std::lock_guard lock(mutex_);
+    auto& reader = readers_[i];
+    if (!reader.segment || reader.epoch != *epoch) {
+      // 串流換了較大的區段或被重新建立，重新映射
+      reader.segment = Segment::Open(SegmentName(i, *epoch));
+      reader.epoch = *epoch;
+    }
+    return reader.segment;
+  }
+  return nullptr;
+}
+
+FrameBus::Publisher* FrameBus::EnsurePublisher(
+    std::string_view stream_id, size_t bytes) {
+  const std::string key(stream_id);
+  if (auto it = publishers_.find(key); it != publishers_.end()) {
+    if (bytes > it->second.segment->capacity() &&
+        !Reallocate(&it->second, bytes)) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  // 本行程第一次發布此串流：若目錄中已有同名項目（發布端重啟）則接手，
+  // 一律換新區段，避免沿用前一個行程寫到一半的格子
+  std::optional<uint32_t> index = FindEntry(stream_id);
+  if (index) {
+    uint32_t expected = kActive;
+    if (!directory_->entries()[*index].state.compare_exchange_strong(
+            expected, kClaimed, std::memory_order_acq_rel)) {
+      index.reset();
+    }
+  }
+  for (uint32_t i = 0; !index && i < directory_->max_streams; ++i) {
+    uint32_t expected = kFree;
+    if (directory_->entries()[i].state.compare_exchange_strong(
+            expected, kClaimed, std::memory_order_acq_rel)) {
+      index = i;
+    }
+  }
+  if (!index) {
+    return nullptr;
+  }
+
+  Entry& entry = directory_->entries()[*index];
+  const uint64_t seq = entry.seq.load(std::memory_order_relaxed);
+  entry.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  entry.id_length = static_cast<uint32_t>(stream_id.size());
+  std::memcpy(entry.stream_id, stream_id.data(), stream_id.size());
+  entry.stream_id[stream_id.size()] = '\0';
+  entry.seq.store(seq + 2, std::memory_order_release);
+  const pid_t pid = getpid();
+  entry.owner_pid.store(pid, std::memory_order_relaxed);
+  const auto stat = ReadProcessStat(pid);
+  entry.owner_start_time.store(
+      stat ? stat->start_time : 0, std::memory_order_relaxed);
+
+  Publisher publisher;
+  publisher.index = *index;
+  if (!Reallocate(&publisher, bytes)) {
+    entry.state.store(kFree, std::memory_order_release);
+    return nullptr;
+  }
+  entry.state.store(kActive, std::memory_order_release);
+  return &publishers_.emplace(key, std::move(publisher)).first->second;
+}
+
+bool FrameBus::Reallocate(Publisher* publisher, size_t bytes) {
+  Entry& entry = directory_->entries()[publisher->index];
+  const uint64_t old_epoch = entry.epoch.load(std::memory_order_relaxed);
+  const uint64_t new_epoch = old_epoch + 1;
+  auto segment =
+      Segment::Create(SegmentName(publisher->index, new_epoch), bytes);
+  if (!segment) {
+    return false;
+  }
+  if (publisher->segment) {
+    // 畫面變大換區段時延續已發布的格數，讀取端看到的 sequence 不會倒退
+    segment->header()->published.store(
+        publisher->segment->header()->published.load(
+            std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  }
+
+  const uint64_t seq = entry.seq.load(std::memory_order_relaxed);
+  entry.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  entry.epoch.store(new_epoch, std::memory_order_relaxed);
+  entry.seq.store(seq + 2, std::memory_order_release);
+
+  // 接手或擴充時舊區段的名稱已無人需要，已映射的讀取端不受影響
+  if (old_epoch != 0) {
+    shm_unlink(SegmentName(publisher->index, old_epoch).c_str());
+  }
+  publisher->segment = std::move(segment);
+  return true;
+}
+
+bool FrameBus::Publish(
+    std::string_view stream_id,
+    std::string_view label,
+    const uint8_t* data,
+    const FrameShape& shape,
+    int64_t timestamp_ms) {
+  const size_t bytes = shape.bytes();
+  if (!writable_ || data == nullptr || bytes == 0 || stream_id.empty() ||
+      stream_id.size() > kMaxStreamIdLength) {
+    return false;
+  }
+
+  std::shared_ptr<Segment> segment;
+  {
+    std::lock_guard lock(mutex_);
+    auto* publisher = EnsurePublisher(stream_id, bytes);
+    if (!publisher) {
+      return false;
+    }
+    segment = publisher->segment;
+  }
+
+  // 單一發布者：寫入最舊的一格，剛發布的那格至少保留到下下次發布
+  SegmentHeader* header = segment->header();
+  const uint32_t latest = header->latest.load(std::memory_order_relaxed);
+  const uint32_t next = latest == kNoSlot ? 0 : (latest + 1) % kSlotCount;
+  SlotHeader& slot = header->slots[next];
+  const uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+  slot.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const uint64_t sequence =
+      header->published.load(std::memory_order_relaxed) + 1;
+  slot.height = shape.height;
+  slot.width = shape.width;
+  slot.channels = shape.channels;
+  slot.timestamp_ms = timestamp_ms;
+  slot.sequence = sequence;
+  const size_t label_length = TruncateUtf8(label, kMaxLabelLength);
+  std::memcpy(slot.label, label.data(), label_length);
+  slot.label[label_length] = '\0';
+  slot.label_length = static_cast<uint32_t>(label_length);
+  std::memcpy(segment->slot_data(next), data, bytes);
+
+  slot.seq.store(seq + 2, std::memory_order_release);
+  header->latest.store(next, std::memory_order_release);
+  header->published.store(sequence, std::memory_order_release);
+  return true;
+}
+
+void FrameBus::Remove(std::string_view stream_id) {
+  if (!writable_) {
+    return;
+  }
+  std::lock_guard lock(mutex_);
+  publishers_.erase(std::string(stream_id));
+  const auto index = FindEntry(stream_id);
+  if (!index) {
+    return;
+  }
+  uint32_t expected = kActive;
+  if (directory_->entries()[*index].state.compare_exchange_strong(
+          expected, kClaimed, std::memory_order_acq_rel)) {
+    ReleaseEntry(*index);
+  }
+}
+
+void FrameBus::ReleaseEntry(uint32_t index) {
+  Entry& entry = directory_->entries()[index];
+  const uint64_t epoch = entry.epoch.load(std::memory_order_relaxed);
+  shm_unlink(SegmentName(index, epoch).c_str());
+  const uint64_t seq = entry.seq.load(std::memory_order_relaxed);
+  entry.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  entry.id_length = 0;
+  entry.stream_id[0] = '\0';
+  entry.seq.store(seq + 2, std::memory_order_release);
+  entry.owner_pid.store(0, std::memory_order_relaxed);
+  entry.state.store(kFree, std::memory_order_release);
+}
+
+void FrameBus::ReapStaleEntries() {
+  for (uint32_t i = 0; i < directory_->max_streams; ++i) {
+    Entry& entry = directory_->entries()[i];
+    const auto owner_alive = [&entry] {
+      return IsProcessAlive(
+          entry.owner_pid.load(std::memory_order_relaxed),
+          entry.owner_start_time.load(std::memory_order_relaxed));
+    };
+    if (entry.state.load(std::memory_order_acquire) != kActive ||
+        owner_alive()) {
+      continue;
+    }
+    uint32_t expected = kActive;
+    if (!entry.state.compare_exchange_strong(
+            expected, kClaimed, std::memory_order_acq_rel)) {
+      continue;
+    }
+    // 檢查後到搶下之間可能已有新的發布者接手，搶下後再確認一次
+    if (owner_alive()) {
+      entry.state.store(kActive, std::memory_order_release);
+      continue;
+    }
+    ReleaseEntry(i);
+  }
+}
+
+std::vector<std::string> FrameBus::Streams() const {
+  std::vector<std::string> streams;
+  for (uint32_t i = 0; i < directory_->max_streams; ++i) {
+    const Entry& entry = directory_->entries()[i];
+    for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+      if (entry.state.load(std::memory_order_acquire) != kActive) {
+        break;
+      }
+      const uint64_t before = entry.seq.load(std::memory_order_acquire);
+      if (before & 1) {
+        continue;
+      }
+      const size_t length =
+          std::min<size_t>(entry.id_length, kMaxStreamIdLength);
+      std::string id(entry.stream_id, length);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (entry.seq.load(std::memory_order_relaxed) == before) {
+        streams.push_back(std::move(id));
+        break;
+      }
+    }
+  }
+  std::ranges::sort(streams);
+  return streams;
+}
+
+ReadStatus FrameBus::ReadLatest(
+    std::string_view stream_id,
+    uint8_t* out,
+    size_t capacity,
+    FrameInfo* info) const {
+  for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    const auto segment = ResolveSegment(stream_id);
+    if (!segment) {
+      return ReadStatus::kNotFound;
+    }
+    const SegmentHeader* header = segment->header();
+    const uint32_t latest = header->latest.load(std::memory_order_acquire);
+    if (latest >= kSlotCount) {
+      return ReadStatus::kEmpty;
+    }
+    const SlotHeader& slot = header->slots[latest];
+    const uint64_t before = slot.seq.load(std::memory_order_acquire);
+    if (before & 1) {
+      continue;
+    }
+    FrameInfo local;
+    local.shape = {slot.height, slot.width, slot.channels};
+    local.timestamp_ms = slot.timestamp_ms;
+    local.sequence = slot.sequence;
+    local.label.assign(
+        slot.label, std::min<size_t>(slot.label_length, kMaxLabelLength));
+    const size_t bytes = local.shape.bytes();
+    const bool fits = bytes <= capacity && out != nullptr;
+    if (fits && bytes <= segment->capacity()) {
+      std::memcpy(out, segment->slot_data(latest), bytes);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != before ||
+        bytes > segment->capacity()) {
+      continue;
+    }
+    if (info) {
+      *info = std::move(local);
+    }
+    return fits ? ReadStatus::kOk : ReadStatus::kTooSmall;
+  }
+  return ReadStatus::kBusy;
+}
+
+std::optional<FrameView> FrameBus::Acquire(std::string_view stream_id) const {
+  for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    auto segment = ResolveSegment(stream_id);
+    if (!segment) {
+      return std::nullopt;
+    }
+    const SegmentHeader* header = segment->header();
+    const uint32_t latest = header->latest.load(std::memory_order_acquire);
+    if (latest >= kSlotCount) {
+      return std::nullopt;
+    }
+    const SlotHeader& slot = header->slots[latest];
+    FrameView view;
+    view.seq = slot.seq.load(std::memory_order_acquire);
+    if (view.seq & 1) {
+      continue;
+    }
+    view.slot = latest;
+    view.info.shape = {slot.height, slot.width, slot.channels};
+    view.info.timestamp_ms = slot.timestamp_ms;
+    view.info.sequence = slot.sequence;
+    view.info.label.assign(
+        slot.label, std::min<size_t>(slot.label_length, kMaxLabelLength));
+    view.data = segment->slot_data(latest);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != view.seq ||
+        view.info.shape.bytes() > segment->capacity()) {
+      continue;
+    }
+    view.segment = std::move(segment);
+    return view;
+  }
+  return std::nullopt;
+}
+
+bool FrameBus::Validate(const FrameView& view) {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return view.segment != nullptr &&
+      view.segment->header()->slots[view.slot].seq.load(
+          std::memory_order_relaxed) == view.seq;
+}
+
+void FrameBus::Unlink() {
+  for (uint32_t i = 0; i < directory_->max_streams; ++i) {
+    const Entry& entry = directory_->entries()[i];
+    if (entry.state.load(std::memory_order_acquire) == kActive) {
+      const uint64_t epoch = entry.epoch.load(std::memory_order_relaxed);
+      shm_unlink(SegmentName(i, epoch).c_str());
+    }
+  }
+  shm_unlink(name_.c_str());
+}
+
+} // namespace edge_vision::frame_bus
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace edge_vision::frame_bus {
+
+inline constexpr uint32_t kSlotCount = 3;
+inline constexpr size_t kMaxStreamIdLength = 255;
+inline constexpr size_t kMaxLabelLength = 127;
+
+struct FrameShape {
+  uint32_t height = 0;
+  uint32_t width = 0;
+  uint32_t channels = 0;
+
+  size_t bytes() const {
+    return static_cast<size_t>(height) * width * channels;
+  }
+};
+
+struct FrameInfo {
+  FrameShape shape;
+  int64_t timestamp_ms = 0;
+  // 此串流自建立以來發布的第幾格，可用來判斷是否為新畫面
+  uint64_t sequence = 0;
+  std::string label;
+};
+
+enum class ReadStatus {
+  kOk,
+  kNotFound, // 沒有這個串流
+  kEmpty, // 串流存在但尚未發布任何畫面
+  kTooSmall, // 輸出緩衝區不足，info 已填入所需的尺寸
+  kBusy, // 連續多次讀到正在被覆寫的格子
+};
+
+class Segment;
+
+/**
+ * 零複製讀取的結果。data 直接指向共享記憶體，持有期間對應的 mapping
+ * 不會被釋放；但發布端寫滿兩格後會回頭覆寫同一格，使用完畢後必須以
+ * FrameBus::Validate 確認期間沒有被覆寫，否則應捨棄結果重新讀取。
+ */
+struct FrameView {
+  const uint8_t* data = nullptr;
+  FrameInfo info;
+  uint32_t slot = 0;
+  uint64_t seq = 0;
+  std::shared_ptr<const Segment> segment;
+};
+
+/**
+ * 以 POSIX shared memory 實作的「每個串流只保留最新一格」的 frame bus，
+ * 取代 Python 端以 dict + lock 實作的 FrameHub，讓偵測、拼接與串流可以
+ * 分成不同行程。
+ *
+ * 共享記憶體分成兩種：以 name 命名的目錄區段記錄各串流的 ID 與目前的
+ * 資料區段版本；每個串流一個資料區段，內含三格（triple buffer），每格
+ * 以 seqlock 保護。發布端輪流寫入最舊的一格後才更新 latest，讀取端不需
+ * 任何鎖：讀到寫入中的格子（seq 為奇數或前後不一致）時重試。
+ *
+ * 每個串流同一時間只能有一個發布者；不同串流可以由不同執行緒或行程
+ * 發布。目錄記錄每個串流發布行程的 pid 與啟動時間，所有發布行程須位於
+ * 同一個 pid namespace。
+ */
+class FrameBus {
+ public:
+  // 建立目錄區段（已存在時沿用，發布端重啟不影響已連接的讀取端）。
+  // 沿用時會移除發布行程已結束的串流，避免前一次異常結束留下的畫面
+  // 一直停在最後一格
+  static std::unique_ptr<FrameBus> Create(
+      std::string_view name, uint32_t max_streams);
+  // 連接既有的目錄區段；不存在或格式不符時回傳 nullptr
+  static std::unique_ptr<FrameBus> Open(std::string_view name);
+
+  ~FrameBus();
+
+  FrameBus(const FrameBus&) = delete;
+  FrameBus& operator=(const FrameBus&) = delete;
+
+  // 寫入最新一格；串流不存在時自動建立，畫面變大時換成較大的資料區段。
+  // 串流數已滿或參數不合法時回傳 false
+  bool Publish(
+      std::string_view stream_id,
+      std::string_view label,
+      const uint8_t* data,
+      const FrameShape& shape,
+      int64_t timestamp_ms);
+
+  // 移除串流並刪除其資料區段名稱；已映射的讀取端在下次讀取時得知
+  void Remove(std::string_view stream_id);
+
+  // 目前所有串流的 ID（依字典序）
+  std::vector<std::string> Streams() const;
+
+  // 將最新一格複製到 out；複製期間不持有任何鎖
+  ReadStatus ReadLatest(
+      std::string_view stream_id,
+      uint8_t* out,
+      size_t capacity,
+      FrameInfo* info) const;
+
+  std::optional<FrameView> Acquire(std::string_view stream_id) const;
+  static bool Validate(const FrameView& view);
+
+  // 刪除目錄與所有資料區段的名稱；已映射者仍可使用到解除映射為止
+  void Unlink();
+
+  const std::string& name() const { return name_; }
+  uint32_t max_streams() const;
+
+ private:
+  struct Directory;
+  struct Entry;
+
+  struct Publisher {
+    uint32_t index = 0;
+    std::shared_ptr<Segment> segment;
+  };
+
+  struct Reader {
+    uint64_t epoch = 0;
+    std::shared_ptr<const Segment> segment;
+  };
+
+  FrameBus(std::string name, void* base, size_t size, bool writable);
+
+  // 讀取目錄中 stream_id 對應的欄位（seqlock），找不到時回傳 nullopt
+  std::optional<uint32_t> FindEntry(std::string_view stream_id) const;
+  std::optional<uint64_t> ReadEpoch(
+      uint32_t index, std::string_view stream_id) const;
+  std::shared_ptr<const Segment> ResolveSegment(
+      std::string_view stream_id) const;
+
+  // 移除發布行程已不存在的串流
+  void ReapStaleEntries();
+  // 刪除已被本行程標為 kClaimed 之項目的資料區段並釋放該項目
+  void ReleaseEntry(uint32_t index);
+
+  Publisher* EnsurePublisher(std::string_view stream_id, size_t bytes);
+  bool Reallocate(Publisher* publisher, size_t bytes);
+
+  std::string SegmentName(uint32_t index, uint64_t epoch) const;
+
+  const std::string name_;
+  Directory* directory_;
+  const size_t directory_size_;
+  const bool writable_;
+
+  // 只保護本行程的映射快取，不涉及共享記憶體的資料路徑
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Publisher> publishers_;
+  mutable std::unordered_map<uint32_t, Reader> readers_;
+};
+
+} // namespace edge_vision::frame_bus
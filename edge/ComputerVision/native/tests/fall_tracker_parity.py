@@ -0,0 +1,91 @@
+"""逐格比對 Python 與 native 跌倒追蹤器的輸出。
+
+以固定亂數種子產生多人、時有時無的關節點序列（含未偵測到的 0 座標與
+不規則的時間間隔），兩個追蹤器的 ``evaluate_batch`` 結果必須完全相同。
+
+    python3 native/tests/fall_tracker_parity.py \
+        --library native/build/src/fall_features/libedge_fall_features.so
+"""
+
+from __future__ import annotations
+
+import argparse
+import sys
+import time
+from pathlib import Path
+
+import numpy as np
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from Vision.fall_detector import FallDetectionTracker, NativeFallTracker  # noqa: E402
+
+_MAX_PEOPLE = 8
+_MAX_TRACK_ID = 20
+_MISSING_KEYPOINT_RATIO = 0.2
+
+
+def run_parity(library: str, frames: int, seed: int) -> int:
+    rng = np.random.default_rng(seed)
+    python_tracker = FallDetectionTracker()
+    native_tracker = NativeFallTracker(library=library)
+    timestamp_ms = 1_000_000
+    compared = mismatched = falls = 0
+    for frame in range(frames):
+        people = int(rng.integers(0, _MAX_PEOPLE))
+        pids = rng.choice(_MAX_TRACK_ID, people, replace=False)
+        keypoints = (rng.random((people, 17, 2)) * 600).astype(np.float32)
+        keypoints[rng.random((people, 17)) < _MISSING_KEYPOINT_RATIO] = 0
+        heights = rng.random(people) * 400 + 50
+        timestamp_ms += int(rng.integers(0, 80))
+
+        expected = python_tracker.evaluate_batch(pids, heights, keypoints, timestamp_ms)
+        actual = native_tracker.evaluate_batch(pids, heights, keypoints, timestamp_ms)
+        for pid, want, got in zip(pids, expected, actual):
+            compared += 1
+            falls += want.label_weak
+            if want != got:
+                mismatched += 1
+                if mismatched <= 5:
+                    print(f"frame {frame} pid {pid}:\n  python {want}\n  native {got}")
+
+    print(f"{mismatched} mismatches in {compared} results ({falls} falls)")
+    # 全部都不是跌倒時比對沒有意義
+    if compared == 0 or falls == 0:
+        print("input never triggered a fall; adjust the generator")
+        return 1
+    return 1 if mismatched else 0
+
+
+def run_benchmark(library: str, iterations: int = 2000) -> None:
+    rng = np.random.default_rng(0)
+    pids = np.arange(_MAX_PEOPLE)
+    keypoints = (rng.random((_MAX_PEOPLE, 17, 2)) * 600).astype(np.float32)
+    heights = rng.random(_MAX_PEOPLE) * 400 + 50
+    for name, tracker in (
+        ("python", FallDetectionTracker()),
+        ("native", NativeFallTracker(library=library)),
+    ):
+        started = time.perf_counter()
+        for k in range(iterations):
+            tracker.evaluate_batch(pids, heights, keypoints, k * 33)
+        elapsed = (time.perf_counter() - started) / iterations
+        print(f"{name}: {elapsed * 1e6:.1f} us per {_MAX_PEOPLE}-person frame")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--library", required=True, help="libedge_fall_features.so")
+    parser.add_argument("--frames", type=int, default=3000)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--benchmark", action="store_true")
+    args = parser.parse_args()
+
+    status = run_parity(args.library, args.frames, args.seed)
+    if args.benchmark:
+        run_benchmark(args.library)
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "frame_bus/frame_bus.hpp"
+
+using namespace edge_vision::frame_bus;
+
+namespace {
+
+constexpr FrameShape kSmall{720, 1280, 3};
+constexpr FrameShape kLarge{1080, 1920, 3};
+constexpr int kFrames = 2000;
+constexpr char kStream[] = "rtsp://cam1";
+
+// 每一格的所有位元組都是同一個值，讀到兩個不同的值就代表格子被撕裂
+bool IsUniform(const uint8_t* data, size_t bytes) {
+  return bytes == 0 || std::memcmp(data, data + 1, bytes - 1) == 0;
+}
+
+uint8_t FrameValue(int index) {
+  return static_cast<uint8_t>(index % 251);
+}
+
+// 在子行程中發布 frames 格；前半為 kSmall，後半改為 kLarge 以觸發換區段
+pid_t SpawnPublisher(const std::string& bus_name, int frames, int offset) {
+  const pid_t pid = ::fork();
+  if (pid != 0) {
+    return pid;
+  }
+  // 子行程不使用 gtest 的斷言，以結束碼回報
+  auto bus = FrameBus::Create(bus_name, 4);
+  if (!bus) {
+    ::_exit(2);
+  }
+  std::vector<uint8_t> frame(kLarge.bytes());
+  for (int i = 0; i < frames; ++i) {
+    const FrameShape& shape = i < frames / 2 ? kSmall : kLarge;
+    std::fill_n(frame.begin(), shape.bytes(), FrameValue(offset + i));
+    if (!bus->Publish(kStream, "相機一號", frame.data(), shape, i)) {
+      ::_exit(3);
+    }
+  }
+  ::_exit(0);
+}
+
+int WaitExitCode(pid_t pid) {
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+class FrameBusTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    name_ = "edge-frame-bus-test-" + std::to_string(::getpid());
+    bus_ = FrameBus::Create(name_, 4);
+    ASSERT_NE(bus_, nullptr);
+  }
+
+  void TearDown() override {
+    if (bus_) {
+      bus_->Unlink();
+    }
+  }
+
+  std::string name_;
+  std::unique_ptr<FrameBus> bus_;
+};
+
+} // namespace
+
+TEST_F(FrameBusTest, OpenRequiresExistingBus) {
+  EXPECT_EQ(FrameBus::Open(name_ + "-missing"), nullptr);
+  auto reader = FrameBus::Open(name_);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->max_streams(), 4u);
+  EXPECT_TRUE(reader->Streams().empty());
+}
+
+TEST_F(FrameBusTest, CrossProcessReadsAreNeverTorn) {
+  auto reader = FrameBus::Open(name_);
+  ASSERT_NE(reader, nullptr);
+  const pid_t publisher = SpawnPublisher(name_, kFrames, 0);
+  ASSERT_GT(publisher, 0);
+
+  std::vector<uint8_t> buffer(kLarge.bytes());
+  int copies = 0;
+  int views = 0;
+  int torn = 0;
+  int pid_status = 0;
+  while (::waitpid(publisher, &pid_status, WNOHANG) == 0) {
+    FrameInfo info;
+    if (reader->ReadLatest(kStream, buffer.data(), buffer.size(), &info) ==
+        ReadStatus::kOk) {
+      ++copies;
+      torn += !IsUniform(buffer.data(), info.shape.bytes());
+    }
+    // 零複製讀取：只有 Validate 成功時內容才算數
+    if (const auto view = reader->Acquire(kStream)) {
+      const bool uniform = IsUniform(view->data, view->info.shape.bytes());
+      if (FrameBus::Validate(*view)) {
+        ++views;
+        torn += !uniform;
+      }
+    }
+  }
+  ASSERT_TRUE(WIFEXITED(pid_status));
+  ASSERT_EQ(WEXITSTATUS(pid_status), 0);
+  EXPECT_EQ(torn, 0);
+  EXPECT_GT(copies + views, 0);
+
+  // 發布端結束後最新一格仍可讀，且已換成較大的區段
+  FrameInfo info;
+  ASSERT_EQ(
+      reader->ReadLatest(kStream, buffer.data(), buffer.size(), &info),
+      ReadStatus::kOk);
+  EXPECT_EQ(info.shape.height, kLarge.height);
+  EXPECT_EQ(info.shape.width, kLarge.width);
+  EXPECT_EQ(info.sequence, static_cast<uint64_t>(kFrames));
+  EXPECT_EQ(info.label, "相機一號");
+  EXPECT_EQ(buffer[0], FrameValue(kFrames - 1));
+  EXPECT_TRUE(IsUniform(buffer.data(), info.shape.bytes()));
+}
+
+TEST_F(FrameBusTest, ReaderFollowsPublisherRestart) {
+  auto reader = FrameBus::Open(name_);
+  ASSERT_NE(reader, nullptr);
+  ASSERT_EQ(WaitExitCode(SpawnPublisher(name_, 2, 10)), 0);
+  FrameInfo info;
+  std::vector<uint8_t> buffer(kLarge.bytes());
+  ASSERT_EQ(
+      reader->ReadLatest(kStream, buffer.data(), buffer.size(), &info),
+      ReadStatus::kOk);
+  EXPECT_EQ(buffer[0], FrameValue(11));
+
+  // 新的發布行程接手同一個串流，已連接的讀取端不需重新開啟
+  ASSERT_EQ(WaitExitCode(SpawnPublisher(name_, 2, 20)), 0);
+  ASSERT_EQ(
+      reader->ReadLatest(kStream, buffer.data(), buffer.size(), &info),
+      ReadStatus::kOk);
+  EXPECT_EQ(buffer[0], FrameValue(21));
+  EXPECT_EQ(reader->Streams(), std::vector<std::string>{kStream});
+}
+
+TEST_F(FrameBusTest, CreateDropsStreamsOfExitedPublishers) {
+  // 本行程發布的串流仍在執行，不受影響
+  const std::vector<uint8_t> frame(kSmall.bytes(), 7);
+  ASSERT_TRUE(bus_->Publish("rtsp://live", "", frame.data(), kSmall, 0));
+  const pid_t publisher = SpawnPublisher(name_, 2, 0);
+  ASSERT_GT(publisher, 0);
+  // 等子行程結束但不回收：異常結束、尚未被回收的發布者也要視為已結束
+  siginfo_t exited{};
+  ASSERT_EQ(::waitid(P_PID, publisher, &exited, WEXITED | WNOWAIT), 0);
+
+  auto reader = FrameBus::Open(name_);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(
+      reader->Streams(), (std::vector<std::string>{kStream, "rtsp://live"}));
+
+  // 重新啟動：沿用既有目錄時移除前一次留下的串流
+  auto restarted = FrameBus::Create(name_, 4);
+  ASSERT_NE(restarted, nullptr);
+  EXPECT_EQ(reader->Streams(), std::vector<std::string>{"rtsp://live"});
+  std::vector<uint8_t> buffer(kLarge.bytes());
+  EXPECT_EQ(
+      reader->ReadLatest(kStream, buffer.data(), buffer.size(), nullptr),
+      ReadStatus::kNotFound);
+  EXPECT_EQ(
+      reader->ReadLatest("rtsp://live", buffer.data(), buffer.size(), nullptr),
+      ReadStatus::kOk);
+  EXPECT_EQ(WaitExitCode(publisher), 0);
+}
+
+TEST_F(FrameBusTest, SmallBufferReportsRequiredShape) {
+  const std::vector<uint8_t> frame(kSmall.bytes(), 7);
+  ASSERT_TRUE(bus_->Publish(kStream, "", frame.data(), kSmall, 0));
+  auto reader = FrameBus::Open(name_);
+  ASSERT_NE(reader, nullptr);
+
+  std::vector<uint8_t> buffer(16);
+  FrameInfo info;
+  EXPECT_EQ(
+      reader->ReadLatest(kStream, buffer.data(), buffer.size(), &info),
+      ReadStatus::kTooSmall);
+  EXPECT_EQ(info.shape.bytes(), kSmall.bytes());
+  EXPECT_EQ(
+      reader->ReadLatest("rtsp://missing", buffer.data(), 16, &info),
+      ReadStatus::kNotFound);
+}
+
+TEST_F(FrameBusTest, RemoveIsSeenByMappedReaders) {
+  const std::vector<uint8_t> frame(kSmall.bytes(), 7);
+  ASSERT_TRUE(bus_->Publish(kStream, "", frame.data(), kSmall, 0));
+  auto reader = FrameBus::Open(name_);
+  ASSERT_NE(reader, nullptr);
+  // 先讀一次，讓讀取端映射資料區段
+  ASSERT_TRUE(reader->Acquire(kStream).has_value());
+
+  bus_->Remove(kStream);
+  EXPECT_TRUE(reader->Streams().empty());
+  EXPECT_FALSE(reader->Acquire(kStream).has_value());
+  std::vector<uint8_t> buffer(kSmall.bytes());
+  EXPECT_EQ(
+      reader->ReadLatest(kStream, buffer.data(), buffer.size(), nullptr),
+      ReadStatus::kNotFound);
+}
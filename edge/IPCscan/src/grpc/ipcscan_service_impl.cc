@@ -0,0 +1,132 @@
+#include "grpc/ipcscan_service_impl.hpp"
+
+#include <atomic>
+#include <string>
+
+#include "scan/subnet.hpp"
+#include "util/logging.hpp"
+
+namespace ipcscan::grpcservice {
+
+namespace {
+
+ipcscan::grpc::ScanEvent::Kind ToProtoKind(scan::ScanEventKind kind) {
+  switch (kind) {
+    case scan::ScanEventKind::kFound:
+      return ipcscan::grpc::ScanEvent::DEVICE_FOUND;
+    case scan::ScanEventKind::kUpdated:
+      return ipcscan::grpc::ScanEvent::DEVICE_UPDATED;
+    case scan::ScanEventKind::kLost:
+      return ipcscan::grpc::ScanEvent::DEVICE_LOST;
+  }
+  return ipcscan::grpc::ScanEvent::KIND_UNSPECIFIED;
+}
+
+const char* DeviceCategory(const scan::DeviceInfo& device) {
+  return device.IsCamera() ? "IPC" : "General";
+}
+
+} // namespace
+
+void IpcScanServiceGrpc::FillProtoDevice(
+    const scan::DeviceInfo& device, ipcscan::grpc::Device* proto_device) {
+  proto_device->set_ip(scan::FormatIpv4(device.address));
+  proto_device->set_mac(device.mac);
+  proto_device->set_name(DeviceCategory(device));
+  proto_device->set_onvif(device.onvif);
+  for (const auto& xaddr : device.xaddrs) {
+    proto_device->add_xaddrs(xaddr);
+  }
+  for (const auto port : device.open_ports) {
+    proto_device->add_open_ports(port);
+  }
+  proto_device->set_friendly_name(scan::ScopeValue(device.scopes, "name"));
+  proto_device->set_hardware(scan::ScopeValue(device.scopes, "hardware"));
+}
+
+IpcScanServiceGrpc::IpcScanServiceGrpc(scan::ScannerConfig config)
+    : scanner_(std::move(config)) {}
+
+::grpc::Status IpcScanServiceGrpc::Scan(
+    ::grpc::ServerContext* /*context*/,
+    const ipcscan::grpc::ScanRequest* /*request*/,
+    ipcscan::grpc::ScanResponse* response) {
+  LogInfo("收到 Scan 請求");
+  const auto summary = scanner_.Scan({}, [](auto, const auto&) {});
+  if (!summary.ok) {
+    return {::grpc::StatusCode::UNAVAILABLE, "無法取得掃描範圍"};
+  }
+
+  // IP 與 MAC 皆由本服務格式化，不含需跳脫的字元
+  std::string json = "[";
+  for (const auto& device : scanner_.Devices()) {
+    if (json.size() > 1) {
+      json += ',';
+    }
+    json += R"({"ip":")";
+    json += scan::FormatIpv4(device.address);
+    json += R"(","mac":")";
+    json += device.mac;
+    json += R"(","name":")";
+    json += DeviceCategory(device);
+    json += R"("})";
+  }
+  json += ']';
+  response->set_result(std::move(json));
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status IpcScanServiceGrpc::ScanStream(
+    ::grpc::ServerContext* context,
+    const ipcscan::grpc::ScanStreamRequest* request,
+    ::grpc::ServerWriter<ipcscan::grpc::ScanEvent>* writer) {
+  LogInfoFormat(
+      "收到 ScanStream 請求: interface={} cidr={} full={}",
+      request->interface_name(),
+      request->cidr(),
+      request->full_rescan());
+
+  scan::ScanOptions options;
+  options.interface_name = request->interface_name();
+  options.cidr = request->cidr();
+  options.full_rescan = request->full_rescan();
+  options.connect_timeout =
+      std::chrono::milliseconds(request->connect_timeout_ms());
+
+  // 客戶端斷線或寫入失敗時中止掃描
+  std::atomic<bool> canceled{false};
+  ipcscan::grpc::ScanEvent event;
+  const auto summary = scanner_.Scan(
+      options,
+      [&](scan::ScanEventKind kind, const scan::DeviceInfo& device) {
+        if (canceled.load(std::memory_order_relaxed)) {
+          return;
+        }
+        event.Clear();
+        event.set_kind(ToProtoKind(kind));
+        FillProtoDevice(device, event.mutable_device());
+        if (context->IsCancelled() || !writer->Write(event)) {
+          canceled.store(true, std::memory_order_relaxed);
+        }
+      },
+      &canceled);
+
+  if (canceled.load()) {
+    return {::grpc::StatusCode::CANCELLED, "掃描已取消"};
+  }
+  if (!summary.ok) {
+    return {::grpc::StatusCode::INVALID_ARGUMENT, "無法取得掃描範圍"};
+  }
+
+  event.Clear();
+  event.set_kind(ipcscan::grpc::ScanEvent::SCAN_COMPLETE);
+  auto* proto_summary = event.mutable_summary();
+  proto_summary->set_hosts_probed(static_cast<uint32_t>(summary.hosts_probed));
+  proto_summary->set_devices(static_cast<uint32_t>(summary.devices));
+  proto_summary->set_elapsed_ms(static_cast<uint32_t>(summary.elapsed.count()));
+  proto_summary->set_full_sweep(summary.full_sweep);
+  writer->Write(event);
+  return ::grpc::Status::OK;
+}
+
+} // namespace ipcscan::grpcservice
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include "ipcscan.grpc.pb.h"
+#include "scan/scanner.hpp"
+
+namespace ipcscan::grpcservice {
+
+class IpcScanServiceGrpc final : public ipcscan::grpc::IPCScanService::Service {
+ public:
+  explicit IpcScanServiceGrpc(scan::ScannerConfig config = {});
+  ~IpcScanServiceGrpc() override = default;
+
+  // 相容舊版：掃描完成後以 JSON 陣列回傳 [{ip, mac, name}]
+  ::grpc::Status Scan(
+      ::grpc::ServerContext* context,
+      const ipcscan::grpc::ScanRequest* request,
+      ipcscan::grpc::ScanResponse* response) override;
+
+  ::grpc::Status ScanStream(
+      ::grpc::ServerContext* context,
+      const ipcscan::grpc::ScanStreamRequest* request,
+      ::grpc::ServerWriter<ipcscan::grpc::ScanEvent>* writer) override;
+
+ private:
+  static void FillProtoDevice(
+      const scan::DeviceInfo& device, ipcscan::grpc::Device* proto_device);
+
+  scan::IpcScanner scanner_;
+};
+
+} // namespace ipcscan::grpcservice
@@ -0,0 +1,26 @@
+#include <memory>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+
+#include "grpc/ipcscan_service_impl.hpp"
+#include "util/logging.hpp"
+
+int main() {
+  std::string server_address = "0.0.0.0:20001";
+
+  ipcscan::grpcservice::IpcScanServiceGrpc service{};
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
+  builder.RegisterService(&service);
+
+  const auto server = builder.BuildAndStart();
+  if (!server) {
+    LogError("無法啟動 gRPC 伺服器");
+    return 1;
+  }
+
+  LogInfoFormat("IPC 掃描服務啟動於 {}", server_address);
+  server->Wait();
+  return 0;
+}
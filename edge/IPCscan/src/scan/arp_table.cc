@@ -0,0 +1,55 @@
+#include "scan/arp_table.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+#include "scan/subnet.hpp"
+
+namespace ipcscan::scan {
+
+namespace {
+
+// ATF_COM：項目已完成解析
+constexpr unsigned kArpComplete = 0x2;
+
+} // namespace
+
+std::unordered_map<uint32_t, std::string> ReadArpTable(
+    const std::string& interface_name) {
+  std::unordered_map<uint32_t, std::string> table;
+  std::ifstream arp("/proc/net/arp");
+  std::string line;
+  std::getline(arp, line); // 標題列
+  while (std::getline(arp, line)) {
+    std::istringstream fields(line);
+    std::string ip;
+    std::string hw_type;
+    std::string flags;
+    std::string mac;
+    std::string mask;
+    std::string device;
+    if (!(fields >> ip >> hw_type >> flags >> mac >> mask >> device)) {
+      continue;
+    }
+    if (!interface_name.empty() && device != interface_name) {
+      continue;
+    }
+    if ((std::stoul(flags, nullptr, 16) & kArpComplete) == 0 ||
+        mac == "00:00:00:00:00:00") {
+      continue;
+    }
+    const auto address = ParseIpv4(ip);
+    if (!address) {
+      continue;
+    }
+    std::ranges::transform(mac, mac.begin(), [](unsigned char ch) {
+      return static_cast<char>(std::toupper(ch));
+    });
+    table.emplace(*address, std::move(mac));
+  }
+  return table;
+}
+
+} // namespace ipcscan::scan
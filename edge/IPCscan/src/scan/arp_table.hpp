@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace ipcscan::scan {
+
+// 讀取 /proc/net/arp 中已解析的項目：IPv4（host byte order）-> MAC
+// （大寫，以冒號分隔）。interface_name 為空時不過濾介面
+std::unordered_map<uint32_t, std::string> ReadArpTable(
+    const std::string& interface_name);
+
+} // namespace ipcscan::scan
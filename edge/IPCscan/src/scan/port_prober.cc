@@ -0,0 +1,200 @@
+#include "scan/port_prober.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "util/logging.hpp"
+
+namespace ipcscan::scan {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Outcome { kOpen, kRefused, kNoResponse };
+
+struct HostState {
+  uint32_t remaining = 0;
+  bool reachable = false;
+  std::vector<uint16_t> open_ports;
+};
+
+struct Slot {
+  int fd = -1;
+  size_t task = 0;
+  Clock::time_point deadline;
+};
+
+Outcome ClassifyError(int error) {
+  if (error == 0) {
+    return Outcome::kOpen;
+  }
+  // RST 代表主機存在但連接埠未開啟
+  return error == ECONNREFUSED ? Outcome::kRefused : Outcome::kNoResponse;
+}
+
+void CloseWithReset(int fd) {
+  // 直接送出 RST，不在攝影機上留下半開或 TIME_WAIT 連線
+  const linger reset{1, 0};
+  ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+  ::close(fd);
+}
+
+} // namespace
+
+size_t ProbeHosts(
+    std::span<const uint32_t> hosts,
+    const ProbeOptions& options,
+    const std::function<void(const HostProbeResult&)>& on_host,
+    const std::atomic<bool>* cancel) {
+  const size_t port_count = options.ports.size();
+  const size_t task_count = hosts.size() * port_count;
+  if (task_count == 0) {
+    return 0;
+  }
+
+  const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0) {
+    LogErrorFormat("epoll_create1 失敗: {}", std::strerror(errno));
+    return 0;
+  }
+
+  std::vector<HostState> states(hosts.size());
+  for (auto& state : states) {
+    state.remaining = static_cast<uint32_t>(port_count);
+  }
+  std::vector<Slot> slots(std::max<size_t>(options.max_inflight, 1));
+  std::vector<uint32_t> free_slots(slots.size());
+  for (uint32_t i = 0; i < free_slots.size(); ++i) {
+    free_slots[i] = static_cast<uint32_t>(free_slots.size() - 1 - i);
+  }
+
+  auto finish = [&](size_t task, Outcome outcome) {
+    const size_t host = task / port_count;
+    auto& state = states[host];
+    if (outcome != Outcome::kNoResponse) {
+      state.reachable = true;
+    }
+    if (outcome == Outcome::kOpen) {
+      state.open_ports.push_back(options.ports[task % port_count]);
+    }
+    if (--state.remaining == 0 && state.reachable) {
+      std::ranges::sort(state.open_ports);
+      on_host(HostProbeResult{hosts[host], std::move(state.open_ports)});
+    }
+  };
+
+  auto release = [&](uint32_t index, Outcome outcome) {
+    auto& slot = slots[index];
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, slot.fd, nullptr);
+    CloseWithReset(slot.fd);
+    slot.fd = -1;
+    free_slots.push_back(index);
+    finish(slot.task, outcome);
+  };
+
+  // 回傳 false 代表 fd 已用盡，需等待進行中的連線結束
+  auto start = [&](size_t task) {
+    const int fd =
+        ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      return false;
+    }
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_addr.s_addr = htonl(hosts[task / port_count]);
+    target.sin_port = htons(options.ports[task % port_count]);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&target), sizeof(target)) ==
+        0) {
+      CloseWithReset(fd);
+      finish(task, Outcome::kOpen);
+      return true;
+    }
+    if (errno != EINPROGRESS) {
+      const int error = errno;
+      ::close(fd);
+      finish(task, ClassifyError(error));
+      return true;
+    }
+    const uint32_t index = free_slots.back();
+    free_slots.pop_back();
+    slots[index] = Slot{fd, task, Clock::now() + options.connect_timeout};
+    epoll_event event{};
+    event.events = EPOLLOUT;
+    event.data.u32 = index;
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    return true;
+  };
+
+  std::array<epoll_event, 64> events;
+  size_t next_task = 0;
+  while (true) {
+    if (cancel && cancel->load(std::memory_order_relaxed)) {
+      break;
+    }
+    while (next_task < task_count && !free_slots.empty()) {
+      if (!start(next_task)) {
+        break;
+      }
+      ++next_task;
+    }
+    if (free_slots.size() == slots.size()) {
+      if (next_task >= task_count) {
+        break;
+      }
+      // 沒有進行中的連線卻無法建立 socket，放棄剩餘的主機
+      LogErrorFormat("無法建立 socket: {}", std::strerror(errno));
+      break;
+    }
+
+    auto nearest = Clock::time_point::max();
+    for (const auto& slot : slots) {
+      if (slot.fd >= 0) {
+        nearest = std::min(nearest, slot.deadline);
+      }
+    }
+    const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        nearest - Clock::now());
+    const int ready = ::epoll_wait(
+        epoll_fd,
+        events.data(),
+        static_cast<int>(events.size()),
+        static_cast<int>(std::max<int64_t>(wait.count() + 1, 0)));
+    if (ready < 0 && errno != EINTR) {
+      LogErrorFormat("epoll_wait 失敗: {}", std::strerror(errno));
+      break;
+    }
+    for (int i = 0; i < ready; ++i) {
+      const uint32_t index = events[i].data.u32;
+      int error = 0;
+      socklen_t length = sizeof(error);
+      ::getsockopt(slots[index].fd, SOL_SOCKET, SO_ERROR, &error, &length);
+      release(index, ClassifyError(error));
+    }
+
+    const auto now = Clock::now();
+    for (uint32_t index = 0; index < slots.size(); ++index) {
+      if (slots[index].fd >= 0 && slots[index].deadline <= now) {
+        release(index, Outcome::kNoResponse);
+      }
+    }
+  }
+
+  for (auto& slot : slots) {
+    if (slot.fd >= 0) {
+      CloseWithReset(slot.fd);
+    }
+  }
+  ::close(epoll_fd);
+  return std::min(next_task / port_count, hosts.size());
+}
+
+} // namespace ipcscan::scan
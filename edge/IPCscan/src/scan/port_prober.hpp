@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace ipcscan::scan {
+
+struct ProbeOptions {
+  // RTSP 與 HTTP（ONVIF/網頁管理介面）
+  std::vector<uint16_t> ports{554, 80};
+  // 每個連線的逾時；同一網段內有回應的主機通常在數毫秒內完成握手
+  std::chrono::milliseconds connect_timeout{400};
+  // 同時進行中的連線上限
+  size_t max_inflight = 256;
+};
+
+struct HostProbeResult {
+  uint32_t address = 0;
+  std::vector<uint16_t> open_ports;
+};
+
+/**
+ * 以非阻塞 connect 搭配 epoll 同時探測多台主機的多個連接埠。只要任一
+ * 連接埠完成握手或回覆 RST，該主機即視為存在；所有連接埠都有結果後
+ * 呼叫一次 on_host。沒有回應的主機不會觸發回呼。回傳實際探測的主機數。
+ */
+size_t ProbeHosts(
+    std::span<const uint32_t> hosts,
+    const ProbeOptions& options,
+    const std::function<void(const HostProbeResult&)>& on_host,
+    const std::atomic<bool>* cancel = nullptr);
+
+} // namespace ipcscan::scan
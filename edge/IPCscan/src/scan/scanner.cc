@@ -0,0 +1,201 @@
+#include "scan/scanner.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+#include "scan/arp_table.hpp"
+#include "scan/subnet.hpp"
+#include "util/logging.hpp"
+
+namespace ipcscan::scan {
+
+namespace {
+
+constexpr uint16_t kRtspPort = 554;
+
+} // namespace
+
+bool DeviceInfo::IsCamera() const {
+  return onvif || std::ranges::find(open_ports, kRtspPort) != open_ports.end();
+}
+
+IpcScanner::IpcScanner(ScannerConfig config) : config_(std::move(config)) {}
+
+std::vector<DeviceInfo> IpcScanner::Devices() const {
+  std::lock_guard lock(cache_mutex_);
+  std::vector<DeviceInfo> devices;
+  devices.reserve(devices_.size());
+  for (const auto& [address, device] : devices_) {
+    devices.push_back(device);
+  }
+  return devices;
+}
+
+ScanSummary IpcScanner::Scan(
+    const ScanOptions& options,
+    const EventCallback& on_event,
+    const std::atomic<bool>* cancel) {
+  using Clock = std::chrono::steady_clock;
+  std::lock_guard scan_lock(scan_mutex_);
+  const auto started = Clock::now();
+  ScanSummary summary;
+
+  const auto subnet = options.cidr.empty()
+      ? DetectSubnet(options.interface_name)
+      : ParseCidr(options.cidr);
+  if (!subnet) {
+    LogWarnFormat(
+        "無法取得掃描範圍 (interface={}, cidr={})",
+        options.interface_name,
+        options.cidr);
+    return summary;
+  }
+  const std::string scope = subnet->ToCidr();
+
+  // 本次掃描以快取為起點，結束後整批寫回
+  std::map<uint32_t, DeviceInfo> previous;
+  bool full_sweep = options.full_rescan;
+  {
+    std::lock_guard lock(cache_mutex_);
+    if (cache_scope_ != scope) {
+      devices_.clear();
+      cache_scope_ = scope;
+      full_sweep = true;
+    }
+    if (devices_.empty() ||
+        started - last_full_sweep_ >= config_.full_sweep_interval) {
+      full_sweep = true;
+    }
+    previous = devices_;
+  }
+  summary.full_sweep = full_sweep;
+
+  std::mutex merge_mutex;
+  std::map<uint32_t, DeviceInfo> current;
+  auto arp = ReadArpTable(subnet->interface_name);
+
+  // 合併一筆結果並回報與快取相比的變動
+  auto merge = [&](uint32_t address, auto&& update) {
+    std::lock_guard lock(merge_mutex);
+    auto [it, inserted] = current.try_emplace(address);
+    DeviceInfo& device = it->second;
+    if (inserted) {
+      device.address = address;
+      if (auto cached = previous.find(address); cached != previous.end()) {
+        // 保留上次的 ONVIF 資訊，避免 probe 遺失時被誤判為一般裝置
+        device.onvif = cached->second.onvif;
+        device.xaddrs = cached->second.xaddrs;
+        device.scopes = cached->second.scopes;
+        device.mac = cached->second.mac;
+      }
+      if (auto mac = arp.find(address); mac != arp.end()) {
+        device.mac = mac->second;
+      }
+    }
+    update(device);
+    const auto cached = previous.find(address);
+    if (cached == previous.end()) {
+      on_event(ScanEventKind::kFound, device);
+      previous.emplace(address, device);
+    } else if (!(cached->second == device)) {
+      on_event(ScanEventKind::kUpdated, device);
+      cached->second = device;
+    }
+  };
+
+  // 先送出快取內容，讓呼叫端立即有結果
+  for (const auto& [address, device] : previous) {
+    on_event(ScanEventKind::kFound, device);
+  }
+
+  std::vector<uint32_t> targets;
+  if (full_sweep) {
+    targets = subnet->Hosts();
+  } else {
+    for (const auto& [address, device] : previous) {
+      targets.push_back(address);
+    }
+  }
+
+  DiscoveryOptions discovery = config_.discovery;
+  if (options.cidr.empty()) {
+    discovery.interface_address = subnet->local;
+  }
+  // 連接埠探測結束後通知 discovery 不必等滿整個視窗
+  std::atomic<bool> sweep_done{false};
+  std::jthread discovery_thread([&] {
+    DiscoverOnvif(
+        discovery,
+        [&](const OnvifDevice& found) {
+          merge(found.address, [&](DeviceInfo& device) {
+            device.onvif = true;
+            device.xaddrs = found.xaddrs;
+            device.scopes = found.scopes;
+          });
+        },
+        cancel,
+        &sweep_done);
+  });
+
+  ProbeOptions probe = config_.probe;
+  if (options.connect_timeout.count() > 0) {
+    probe.connect_timeout = options.connect_timeout;
+  }
+  summary.hosts_probed = ProbeHosts(
+      targets,
+      probe,
+      [&](const HostProbeResult& result) {
+        merge(result.address, [&](DeviceInfo& device) {
+          device.open_ports = result.open_ports;
+        });
+      },
+      cancel);
+  sweep_done.store(true, std::memory_order_relaxed);
+  discovery_thread.join();
+
+  if (cancel && cancel->load()) {
+    // 取消的掃描結果不完整，不更新快取
+    return summary;
+  }
+
+  // 連線過程中新增的 ARP 項目
+  arp = ReadArpTable(subnet->interface_name);
+  for (auto& [address, device] : current) {
+    if (auto mac = arp.find(address);
+        mac != arp.end() && device.mac != mac->second) {
+      merge(address, [&](DeviceInfo& updated) { updated.mac = mac->second; });
+    }
+  }
+
+  // 本次沒有任何回應的已知裝置視為離線
+  for (const auto& [address, device] : previous) {
+    if (!current.contains(address)) {
+      on_event(ScanEventKind::kLost, device);
+    }
+  }
+
+  {
+    std::lock_guard lock(cache_mutex_);
+    devices_ = current;
+    if (full_sweep) {
+      last_full_sweep_ = started;
+    }
+  }
+
+  summary.ok = true;
+  summary.devices = current.size();
+  summary.elapsed =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          Clock::now() - started);
+  LogInfoFormat(
+      "掃描 {} 完成：探測 {} 台主機，找到 {} 台裝置，耗時 {} ms{}",
+      scope,
+      summary.hosts_probed,
+      summary.devices,
+      summary.elapsed.count(),
+      full_sweep ? "" : "（增量）");
+  return summary;
+}
+
+} // namespace ipcscan::scan
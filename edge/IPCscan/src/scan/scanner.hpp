@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "scan/port_prober.hpp"
+#include "scan/ws_discovery.hpp"
+
+namespace ipcscan::scan {
+
+struct DeviceInfo {
+  uint32_t address = 0;
+  std::string mac;
+  bool onvif = false;
+  std::vector<std::string> xaddrs;
+  std::vector<std::string> scopes;
+  std::vector<uint16_t> open_ports;
+
+  // 有回應 ONVIF 或開放 RTSP 埠即視為攝影機
+  bool IsCamera() const;
+  bool operator==(const DeviceInfo&) const = default;
+};
+
+enum class ScanEventKind { kFound, kUpdated, kLost };
+
+struct ScanOptions {
+  std::string interface_name;
+  // 非空時優先於 interface_name
+  std::string cidr;
+  bool full_rescan = false;
+  // 0 使用 ScannerConfig 的預設值
+  std::chrono::milliseconds connect_timeout{0};
+};
+
+struct ScanSummary {
+  bool ok = false;
+  size_t hosts_probed = 0;
+  size_t devices = 0;
+  std::chrono::milliseconds elapsed{0};
+  bool full_sweep = false;
+};
+
+struct ScannerConfig {
+  ProbeOptions probe;
+  DiscoveryOptions discovery;
+  // 超過此時間未做完整掃描時，下一次掃描改為完整掃描
+  std::chrono::seconds full_sweep_interval{300};
+};
+
+/**
+ * 子網路攝影機掃描器。WS-Discovery 與 TCP 連接埠探測同時進行，結果
+ * 會快取；快取有效時只重新確認已知裝置並以 WS-Discovery 找新的 ONVIF
+ * 裝置，定期或指定時才重掃整個子網路。同一時間只執行一次掃描，其餘
+ * 呼叫端排隊後通常會直接命中剛更新的快取。
+ */
+class IpcScanner {
+ public:
+  // 回呼於掃描執行緒之間序列化呼叫
+  using EventCallback =
+      std::function<void(ScanEventKind kind, const DeviceInfo& device)>;
+
+  explicit IpcScanner(ScannerConfig config = {});
+
+  ScanSummary Scan(
+      const ScanOptions& options,
+      const EventCallback& on_event,
+      const std::atomic<bool>* cancel = nullptr);
+
+  // 最近一次掃描完成後的裝置列表（依 IP 排序）
+  std::vector<DeviceInfo> Devices() const;
+
+ private:
+  ScannerConfig config_;
+  std::mutex scan_mutex_;
+  mutable std::mutex cache_mutex_;
+  // 快取對應的子網路，子網路改變時清空
+  std::string cache_scope_;
+  std::map<uint32_t, DeviceInfo> devices_;
+  std::chrono::steady_clock::time_point last_full_sweep_{};
+};
+
+} // namespace ipcscan::scan
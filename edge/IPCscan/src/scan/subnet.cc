@@ -0,0 +1,147 @@
+#include "scan/subnet.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <fstream>
+#include <memory>
+
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+
+namespace ipcscan::scan {
+
+namespace {
+
+uint32_t PrefixMask(int prefix_length) {
+  return prefix_length == 0 ? 0U : 0xFFFFFFFFu << (32 - prefix_length);
+}
+
+// 從 /proc/net/route 找出預設路由所在的介面
+std::string DefaultRouteInterface() {
+  std::ifstream routes("/proc/net/route");
+  std::string line;
+  std::getline(routes, line); // 標題列
+  while (std::getline(routes, line)) {
+    const auto tab = line.find('\t');
+    if (tab == std::string::npos) {
+      continue;
+    }
+    const auto destination = line.substr(tab + 1, 8);
+    if (destination == "00000000") {
+      return line.substr(0, tab);
+    }
+  }
+  return {};
+}
+
+} // namespace
+
+std::vector<uint32_t> Ipv4Subnet::Hosts() const {
+  std::vector<uint32_t> hosts;
+  if (prefix_length >= 32) {
+    return hosts;
+  }
+  const int prefix = std::max(prefix_length, kMinScanPrefix);
+  const uint32_t mask = PrefixMask(prefix);
+  const uint32_t first = local & mask;
+  const uint32_t last = first | ~mask;
+  if (prefix == 31) {
+    for (uint32_t address : {first, last}) {
+      if (address != local) {
+        hosts.push_back(address);
+      }
+    }
+    return hosts;
+  }
+  hosts.reserve(last - first - 1);
+  for (uint32_t address = first + 1; address < last; ++address) {
+    if (address != local) {
+      hosts.push_back(address);
+    }
+  }
+  return hosts;
+}
+
+std::string Ipv4Subnet::ToCidr() const {
+  return FormatIpv4(network) + '/' + std::to_string(prefix_length);
+}
+
+std::string FormatIpv4(uint32_t address) {
+  const in_addr value{htonl(address)};
+  char text[INET_ADDRSTRLEN] = {};
+  ::inet_ntop(AF_INET, &value, text, sizeof(text));
+  return text;
+}
+
+std::optional<uint32_t> ParseIpv4(std::string_view text) {
+  char buffer[INET_ADDRSTRLEN] = {};
+  if (text.empty() || text.size() >= sizeof(buffer)) {
+    return std::nullopt;
+  }
+  text.copy(buffer, text.size());
+  in_addr value{};
+  if (::inet_pton(AF_INET, buffer, &value) != 1) {
+    return std::nullopt;
+  }
+  return ntohl(value.s_addr);
+}
+
+std::optional<Ipv4Subnet> ParseCidr(std::string_view cidr) {
+  const auto slash = cidr.find('/');
+  const auto address = ParseIpv4(cidr.substr(0, slash));
+  if (!address) {
+    return std::nullopt;
+  }
+  int prefix_length = 32;
+  if (slash != std::string_view::npos) {
+    const auto digits = cidr.substr(slash + 1);
+    const auto [end, ec] = std::from_chars(
+        digits.data(), digits.data() + digits.size(), prefix_length);
+    if (ec != std::errc{} || end != digits.data() + digits.size() ||
+        prefix_length < 0 || prefix_length > 32) {
+      return std::nullopt;
+    }
+  }
+  Ipv4Subnet subnet;
+  subnet.local = *address;
+  subnet.prefix_length = prefix_length;
+  subnet.network = *address & PrefixMask(prefix_length);
+  return subnet;
+}
+
+std::optional<Ipv4Subnet> DetectSubnet(const std::string& interface_name) {
+  const std::string target =
+      interface_name.empty() ? DefaultRouteInterface() : interface_name;
+
+  ifaddrs* raw = nullptr;
+  if (::getifaddrs(&raw) != 0) {
+    return std::nullopt;
+  }
+  std::unique_ptr<ifaddrs, decltype(&::freeifaddrs)> list(raw, ::freeifaddrs);
+  for (const ifaddrs* it = list.get(); it; it = it->ifa_next) {
+    if (!it->ifa_addr || !it->ifa_netmask ||
+        it->ifa_addr->sa_family != AF_INET) {
+      continue;
+    }
+    if (target.empty() ? (it->ifa_flags & IFF_LOOPBACK) != 0
+                       : target != it->ifa_name) {
+      continue;
+    }
+    const uint32_t address = ntohl(
+        reinterpret_cast<const sockaddr_in*>(it->ifa_addr)->sin_addr.s_addr);
+    const uint32_t mask = ntohl(
+        reinterpret_cast<const sockaddr_in*>(it->ifa_netmask)
+            ->sin_addr.s_addr);
+    Ipv4Subnet subnet;
+    subnet.interface_name = it->ifa_name;
+    subnet.local = address;
+    subnet.network = address & mask;
+    subnet.prefix_length = std::popcount(mask);
+    return subnet;
+  }
+  return std::nullopt;
+}
+
+} // namespace ipcscan::scan
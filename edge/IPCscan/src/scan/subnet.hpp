@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ipcscan::scan {
+
+// 單次掃描最多涵蓋的範圍（/22，1022 台主機）；更大的子網路只掃描本機
+// 所在的 /22
+inline constexpr int kMinScanPrefix = 22;
+
+struct Ipv4Subnet {
+  std::string interface_name;
+  // 以下位址皆為 host byte order
+  uint32_t local = 0;
+  uint32_t network = 0;
+  int prefix_length = 32;
+
+  // 可掃描的主機位址，排除網路位址、廣播位址與本機
+  std::vector<uint32_t> Hosts() const;
+  std::string ToCidr() const;
+};
+
+std::string FormatIpv4(uint32_t address);
+std::optional<uint32_t> ParseIpv4(std::string_view text);
+
+// 解析 "a.b.c.d/n"，local 設為 a.b.c.d
+std::optional<Ipv4Subnet> ParseCidr(std::string_view cidr);
+
+// 讀取介面的 IPv4 位址與遮罩；interface_name 為空時使用預設路由所在介面
+std::optional<Ipv4Subnet> DetectSubnet(const std::string& interface_name);
+
+} // namespace ipcscan::scan
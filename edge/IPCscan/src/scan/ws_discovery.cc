@@ -0,0 +1,250 @@
+#include "scan/ws_discovery.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <random>
+#include <string_view>
+#include <unordered_set>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "util/logging.hpp"
+
+namespace ipcscan::scan {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 等待 finish 時重新檢查的間隔
+constexpr std::chrono::milliseconds kFinishPollInterval{10};
+
+constexpr std::string_view kProbeTemplate =
+    R"(<?xml version="1.0" encoding="UTF-8"?>)"
+    R"(<e:Envelope xmlns:e="http://www.w3.org/2003/05/soap-envelope")"
+    R"( xmlns:w="http://schemas.xmlsoap.org/ws/2004/08/addressing")"
+    R"( xmlns:d="http://schemas.xmlsoap.org/ws/2005/04/discovery")"
+    R"( xmlns:dn="http://www.onvif.org/ver10/network/wsdl">)"
+    R"(<e:Header><w:MessageID>uuid:{}</w:MessageID>)"
+    R"(<w:To e:mustUnderstand="true">)"
+    R"(urn:schemas-xmlsoap-org:ws:2005:04:discovery</w:To>)"
+    R"(<w:Action e:mustUnderstand="true">)"
+    R"(http://schemas.xmlsoap.org/ws/2005/04/discovery/Probe</w:Action>)"
+    R"(</e:Header><e:Body><d:Probe><d:Types>dn:NetworkVideoTransmitter)"
+    R"(</d:Types></d:Probe></e:Body></e:Envelope>)";
+
+std::string RandomUuid() {
+  std::random_device device;
+  std::array<uint32_t, 4> words{device(), device(), device(), device()};
+  // RFC 4122 version 4
+  words[1] = (words[1] & 0xFFFF0FFFu) | 0x00004000u;
+  words[2] = (words[2] & 0x3FFFFFFFu) | 0x80000000u;
+  return std::format(
+      "{:08x}-{:04x}-{:04x}-{:04x}-{:04x}{:08x}",
+      words[0],
+      words[1] >> 16,
+      words[1] & 0xFFFF,
+      words[2] >> 16,
+      words[2] & 0xFFFF,
+      words[3]);
+}
+
+// 取出第一個本地名稱為 name 的元素內容，忽略 namespace prefix
+std::string_view ElementText(std::string_view xml, std::string_view name) {
+  size_t pos = 0;
+  while ((pos = xml.find(name, pos)) != std::string_view::npos) {
+    const size_t end_of_name = pos + name.size();
+    const bool starts_tag = pos > 0 &&
+        (xml[pos - 1] == '<' || (xml[pos - 1] == ':' && pos >= 2));
+    if (!starts_tag || end_of_name >= xml.size() ||
+        (xml[end_of_name] != '>' && xml[end_of_name] != ' ')) {
+      pos = end_of_name;
+      continue;
+    }
+    if (xml[pos - 1] == ':') {
+      // 確認 prefix 之前是 '<' 而不是 '</'
+      const size_t open = xml.rfind('<', pos);
+      if (open == std::string_view::npos || xml[open + 1] == '/') {
+        pos = end_of_name;
+        continue;
+      }
+    }
+    const size_t content = xml.find('>', end_of_name);
+    if (content == std::string_view::npos) {
+      return {};
+    }
+    const size_t close = xml.find("</", content);
+    if (close == std::string_view::npos) {
+      return {};
+    }
+    return xml.substr(content + 1, close - content - 1);
+  }
+  return {};
+}
+
+std::vector<std::string> SplitSpaces(std::string_view text) {
+  std::vector<std::string> items;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    const size_t begin = text.find_first_not_of(" \t\r\n", pos);
+    if (begin == std::string_view::npos) {
+      break;
+    }
+    const size_t end = text.find_first_of(" \t\r\n", begin);
+    items.emplace_back(text.substr(begin, end - begin));
+    pos = end == std::string_view::npos ? text.size() : end;
+  }
+  return items;
+}
+
+} // namespace
+
+std::string ScopeValue(
+    const std::vector<std::string>& scopes, std::string_view category) {
+  constexpr std::string_view kPrefix = "onvif://www.onvif.org/";
+  for (const auto& scope : scopes) {
+    std::string_view view = scope;
+    if (!view.starts_with(kPrefix)) {
+      continue;
+    }
+    view.remove_prefix(kPrefix.size());
+    if (view.starts_with(category) && view.size() > category.size() &&
+        view[category.size()] == '/') {
+      view.remove_prefix(category.size() + 1);
+      std::string value(view);
+      // scope 內的空白以 %20 編碼
+      for (size_t pos; (pos = value.find("%20")) != std::string::npos;) {
+        value.replace(pos, 3, " ");
+      }
+      return value;
+    }
+  }
+  return {};
+}
+
+void DiscoverOnvif(
+    const DiscoveryOptions& options,
+    const std::function<void(const OnvifDevice&)>& on_device,
+    const std::atomic<bool>* cancel,
+    const std::atomic<bool>* finish) {
+  const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    LogErrorFormat("無法建立 WS-Discovery socket: {}", std::strerror(errno));
+    return;
+  }
+  if (options.interface_address != 0) {
+    const in_addr local{htonl(options.interface_address)};
+    ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local));
+  }
+  const unsigned char ttl = 1;
+  ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+
+  sockaddr_in destination{};
+  destination.sin_family = AF_INET;
+  destination.sin_port = htons(options.port);
+  const int parsed = ::inet_pton(
+      AF_INET, options.destination.c_str(), &destination.sin_addr);
+  if (parsed != 1) {
+    LogErrorFormat("WS-Discovery 目的位址錯誤: {}", options.destination);
+    ::close(fd);
+    return;
+  }
+
+  const std::string message_id = RandomUuid();
+  const std::string probe = std::vformat(
+      kProbeTemplate, std::make_format_args(message_id));
+
+  const int probe_count = std::max(options.probe_count, 1);
+  const auto started = Clock::now();
+  const auto deadline = started + options.window;
+  int probes_sent = 0;
+  auto next_probe = started;
+  // 最後一個 probe 送出後可提前結束的時間點
+  auto settled = deadline;
+
+  std::unordered_set<uint32_t> seen;
+  std::array<char, 8192> buffer;
+  while (true) {
+    if (cancel && cancel->load(std::memory_order_relaxed)) {
+      break;
+    }
+    auto now = Clock::now();
+    if (now >= deadline) {
+      break;
+    }
+    if (finish && now >= settled &&
+        finish->load(std::memory_order_relaxed)) {
+      break;
+    }
+    if (probes_sent < probe_count && now >= next_probe) {
+      if (::sendto(
+              fd,
+              probe.data(),
+              probe.size(),
+              0,
+              reinterpret_cast<sockaddr*>(&destination),
+              sizeof(destination)) < 0) {
+        LogWarnFormat("WS-Discovery probe 送出失敗: {}", std::strerror(errno));
+      }
+      ++probes_sent;
+      next_probe = now + options.probe_interval;
+      if (probes_sent == probe_count) {
+        settled = now + options.reply_grace;
+      }
+    }
+
+    auto wake = deadline;
+    if (probes_sent < probe_count) {
+      wake = std::min(wake, next_probe);
+    } else if (finish) {
+      wake = std::min(wake, std::max(settled, now + kFinishPollInterval));
+    }
+    const auto wait =
+        std::chrono::duration_cast<std::chrono::milliseconds>(wake - now);
+    pollfd entry{fd, POLLIN, 0};
+    const int ready =
+        ::poll(&entry, 1, static_cast<int>(std::max<int64_t>(wait.count(), 0)));
+    if (ready <= 0) {
+      continue;
+    }
+
+    sockaddr_in source{};
+    socklen_t source_length = sizeof(source);
+    const ssize_t received = ::recvfrom(
+        fd,
+        buffer.data(),
+        buffer.size(),
+        0,
+        reinterpret_cast<sockaddr*>(&source),
+        &source_length);
+    if (received <= 0) {
+      continue;
+    }
+    const std::string_view xml(buffer.data(), static_cast<size_t>(received));
+    // 只接受回覆本次 probe 的 ProbeMatch
+    if (xml.find("ProbeMatch") == std::string_view::npos ||
+        ElementText(xml, "RelatesTo").find(message_id) ==
+            std::string_view::npos) {
+      continue;
+    }
+    const uint32_t address = ntohl(source.sin_addr.s_addr);
+    if (!seen.insert(address).second) {
+      continue;
+    }
+    OnvifDevice device;
+    device.address = address;
+    device.xaddrs = SplitSpaces(ElementText(xml, "XAddrs"));
+    device.scopes = SplitSpaces(ElementText(xml, "Scopes"));
+    on_device(device);
+  }
+  ::close(fd);
+}
+
+} // namespace ipcscan::scan
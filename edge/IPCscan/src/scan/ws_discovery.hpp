@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ipcscan::scan {
+
+struct DiscoveryOptions {
+  // 等待 ProbeMatch 的最長時間
+  std::chrono::milliseconds window{1000};
+  // UDP 可能遺失，重送的 probe 次數與間隔
+  int probe_count = 2;
+  std::chrono::milliseconds probe_interval{100};
+  // 裝置回覆前會隨機延遲（WS-Discovery APP_MAX_DELAY 為 500 ms），最後
+  // 一個 probe 送出後至少等待這麼久才可提前結束
+  std::chrono::milliseconds reply_grace{500};
+  // 送出 multicast 的本機位址（host byte order），0 由 kernel 決定
+  uint32_t interface_address = 0;
+  // 預設為 WS-Discovery multicast 群組，測試時可改為單播位址
+  std::string destination = "239.255.255.250";
+  uint16_t port = 3702;
+};
+
+struct OnvifDevice {
+  uint32_t address = 0;
+  std::vector<std::string> xaddrs;
+  std::vector<std::string> scopes;
+};
+
+/**
+ * 送出 ONVIF WS-Discovery Probe（Types = NetworkVideoTransmitter），
+ * 在視窗時間內收集 ProbeMatch。同一來源位址只回呼一次。finish 設為
+ * true 後，只要所有 probe 都已送出且已等待 reply_grace 就提前結束，
+ * 不必等滿整個視窗。
+ */
+void DiscoverOnvif(
+    const DiscoveryOptions& options,
+    const std::function<void(const OnvifDevice&)>& on_device,
+    const std::atomic<bool>* cancel = nullptr,
+    const std::atomic<bool>* finish = nullptr);
+
+// 從 ONVIF scope（例如 onvif://www.onvif.org/name/Camera）取出指定類別的值
+std::string ScopeValue(
+    const std::vector<std::string>& scopes, std::string_view category);
+
+} // namespace ipcscan::scan
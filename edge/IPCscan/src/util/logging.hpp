@@ -0,0 +1,72 @@
+#pragma once
+
+#include <format>
+#include <string>
+#include <string_view>
+
+enum class LogLevel { Info, Warn, Error, Debug };
+
+#if defined(NDEBUG)
+constexpr bool kDebugLogsEnabled = false;
+#else
+constexpr bool kDebugLogsEnabled = true;
+#endif
+
+// 執行期的最低輸出等級（Debug < Info < Warn < Error）；預設在 debug
+// build 為 Debug、release build 為 Info，可由環境變數
+// LOG_LEVEL=debug|info|warn|error 覆寫。服務本身只在啟動時讀取
+// LOG_LEVEL，沒有執行期調整的入口；SetMinLogLevel 供測試與嵌入此程式庫
+// 的程式使用。非 debug build 中 Debug 一律不輸出
+void SetMinLogLevel(LogLevel level);
+bool LogLevelEnabled(LogLevel level);
+
+// 將訊息放入佇列後立即返回，由背景執行緒批次寫出；佇列滿時丟棄訊息並
+// 計數，不會阻塞呼叫端
+void LogMessage(LogLevel level, std::string_view message);
+
+// 等待目前佇列中的訊息全部寫出
+void FlushLogs();
+
+void LogInfo(std::string_view message);
+void LogWarn(std::string_view message);
+void LogError(std::string_view message);
+void LogDebug(std::string_view message);
+
+template <typename... Args>
+void LogFormat(LogLevel level, std::string_view fmt, Args&&... args) {
+  if (!LogLevelEnabled(level)) {
+    return;
+  }
+  // 每個執行緒重複使用同一個緩衝區，穩態下不需配置記憶體
+  thread_local std::string buffer;
+  buffer.clear();
+  try {
+    std::vformat_to(
+        std::back_inserter(buffer), fmt, std::make_format_args(args...));
+  } catch (...) {
+    buffer = "[format-error]";
+  }
+  LogMessage(level, buffer);
+}
+
+template <typename... Args>
+void LogInfoFormat(std::string_view fmt, Args&&... args) {
+  LogFormat(LogLevel::Info, fmt, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+void LogWarnFormat(std::string_view fmt, Args&&... args) {
+  LogFormat(LogLevel::Warn, fmt, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+void LogErrorFormat(std::string_view fmt, Args&&... args) {
+  LogFormat(LogLevel::Error, fmt, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+void LogDebugFormat(std::string_view fmt, Args&&... args) {
+  if constexpr (kDebugLogsEnabled) {
+    LogFormat(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+  }
+}
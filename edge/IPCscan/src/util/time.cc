@@ -0,0 +1,65 @@
+#include "time.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace {
+
+constexpr size_t kSecondsPrefixLength = 19; // "YYYY-MM-DDTHH:MM:SS"
+constexpr std::time_t kUtcOffsetSeconds = 8 * 60 * 60;
+
+void WriteDigits(char* out, int value, int width) {
+  for (int i = width - 1; i >= 0; --i) {
+    out[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+} // namespace
+
+void FormatIsoTimestamp(std::chrono::system_clock::time_point time, char* out) {
+  using clock = std::chrono::system_clock;
+  thread_local std::time_t cached_second = -1;
+  thread_local char cached_prefix[kSecondsPrefixLength];
+
+  const auto since_epoch = time.time_since_epoch();
+  const auto seconds =
+      std::chrono::floor<std::chrono::seconds>(since_epoch);
+  const auto millis =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          since_epoch - seconds)
+          .count();
+  const std::time_t second = clock::to_time_t(clock::time_point(seconds));
+
+  if (second != cached_second) {
+    const std::time_t local = second + kUtcOffsetSeconds;
+    std::tm tm_time{};
+    gmtime_r(&local, &tm_time);
+    char* p = cached_prefix;
+    WriteDigits(p, tm_time.tm_year + 1900, 4);
+    p[4] = '-';
+    WriteDigits(p + 5, tm_time.tm_mon + 1, 2);
+    p[7] = '-';
+    WriteDigits(p + 8, tm_time.tm_mday, 2);
+    p[10] = 'T';
+    WriteDigits(p + 11, tm_time.tm_hour, 2);
+    p[13] = ':';
+    WriteDigits(p + 14, tm_time.tm_min, 2);
+    p[16] = ':';
+    WriteDigits(p + 17, tm_time.tm_sec, 2);
+    cached_second = second;
+  }
+
+  std::memcpy(out, cached_prefix, kSecondsPrefixLength);
+  out[kSecondsPrefixLength] = '.';
+  WriteDigits(out + kSecondsPrefixLength + 1, static_cast<int>(millis), 3);
+  std::memcpy(out + kSecondsPrefixLength + 4, "+08:00", 6);
+}
+
+std::string CurrentIsoTimestamp() {
+  std::string text(kIsoTimestampLength, '\0');
+  FormatIsoTimestamp(std::chrono::system_clock::now(), text.data());
+  return text;
+}
@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "scan/scanner.hpp"
+#include "scan/subnet.hpp"
+#include "scan/ws_discovery.hpp"
+
+using namespace ipcscan::scan;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 127.0.0.0/8 整段都在 lo 上，不同位址可代表不同主機
+constexpr std::string_view kCameraHost = "127.0.0.7";
+constexpr std::string_view kOnvifHost = "127.0.0.9";
+
+sockaddr_in Loopback(std::string_view host, uint16_t port) {
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  ::inet_pton(AF_INET, std::string(host).c_str(), &address.sin_addr);
+  return address;
+}
+
+uint16_t BoundPort(int fd) {
+  sockaddr_in address{};
+  socklen_t length = sizeof(address);
+  ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+  return ntohs(address.sin_port);
+}
+
+// 只 listen 不 accept：kernel 會替 backlog 完成握手，足以代表開放的埠
+class TcpListener {
+ public:
+  explicit TcpListener(std::string_view host) {
+    fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const sockaddr_in address = Loopback(host, 0);
+    const auto* raw = reinterpret_cast<const sockaddr*>(&address);
+    if (::bind(fd_, raw, sizeof(address)) != 0 || ::listen(fd_, 64) != 0) {
+      ADD_FAILURE() << "無法建立 TCP listener";
+    }
+    port_ = BoundPort(fd_);
+  }
+  ~TcpListener() {
+    ::close(fd_);
+  }
+
+  uint16_t port() const {
+    return port_;
+  }
+
+ private:
+  int fd_ = -1;
+  uint16_t port_ = 0;
+};
+
+// 單播 WS-Discovery responder，收到 Probe 後延遲 reply_delay 回覆 ProbeMatch
+class OnvifResponder {
+ public:
+  OnvifResponder(
+      std::string_view host,
+      std::chrono::milliseconds reply_delay = 0ms,
+      bool relate_to_probe = true)
+      : reply_delay_(reply_delay), relate_to_probe_(relate_to_probe) {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    const sockaddr_in address = Loopback(host, 0);
+    const auto* raw = reinterpret_cast<const sockaddr*>(&address);
+    if (::bind(fd_, raw, sizeof(address)) != 0) {
+      ADD_FAILURE() << "無法建立 UDP responder";
+    }
+    port_ = BoundPort(fd_);
+    thread_ = std::jthread([this](std::stop_token stop) { Serve(stop); });
+  }
+  ~OnvifResponder() {
+    thread_.request_stop();
+    thread_.join();
+    ::close(fd_);
+  }
+
+  uint16_t port() const {
+    return port_;
+  }
+
+  int probes() const {
+    return probes_.load();
+  }
+
+ private:
+  void Serve(std::stop_token stop) {
+    std::array<char, 8192> buffer;
+    while (!stop.stop_requested()) {
+      pollfd entry{fd_, POLLIN, 0};
+      if (::poll(&entry, 1, 10) <= 0) {
+        continue;
+      }
+      sockaddr_in source{};
+      socklen_t source_length = sizeof(source);
+      const ssize_t received = ::recvfrom(
+          fd_,
+          buffer.data(),
+          buffer.size(),
+          0,
+          reinterpret_cast<sockaddr*>(&source),
+          &source_length);
+      if (received <= 0) {
+        continue;
+      }
+      ++probes_;
+      const std::string_view probe(
+          buffer.data(), static_cast<size_t>(received));
+      const size_t begin = probe.find("<w:MessageID>");
+      const size_t end = probe.find("</w:MessageID>");
+      if (begin == std::string_view::npos || end == std::string_view::npos) {
+        continue;
+      }
+      const std::string message_id(
+          relate_to_probe_ ? probe.substr(begin + 13, end - begin - 13)
+                           : std::string_view("uuid:unrelated"));
+      const std::string reply =
+          "<e:Envelope xmlns:e=\"http://www.w3.org/2003/05/soap-envelope\""
+          " xmlns:w=\"http://schemas.xmlsoap.org/ws/2004/08/addressing\""
+          " xmlns:d=\"http://schemas.xmlsoap.org/ws/2005/04/discovery\">"
+          "<e:Header><w:RelatesTo>" +
+          message_id +
+          "</w:RelatesTo></e:Header><e:Body><d:ProbeMatches><d:ProbeMatch>"
+          "<d:Scopes>onvif://www.onvif.org/name/Lobby%20Cam"
+          " onvif://www.onvif.org/hardware/IPC-100</d:Scopes>"
+          "<d:XAddrs>http://127.0.0.9/onvif/device_service</d:XAddrs>"
+          "</d:ProbeMatch></d:ProbeMatches></e:Body></e:Envelope>";
+      std::this_thread::sleep_for(reply_delay_);
+      ::sendto(
+          fd_,
+          reply.data(),
+          reply.size(),
+          0,
+          reinterpret_cast<const sockaddr*>(&source),
+          source_length);
+    }
+  }
+
+  std::chrono::milliseconds reply_delay_;
+  bool relate_to_probe_;
+  int fd_ = -1;
+  uint16_t port_ = 0;
+  std::atomic<int> probes_{0};
+  std::jthread thread_;
+};
+
+DiscoveryOptions ResponderOptions(const OnvifResponder& responder) {
+  DiscoveryOptions options;
+  options.destination = std::string(kOnvifHost);
+  options.port = responder.port();
+  return options;
+}
+
+std::chrono::milliseconds Since(Clock::time_point started) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      Clock::now() - started);
+}
+
+} // namespace
+
+TEST(WsDiscovery, ReportsEachResponderOnce) {
+  OnvifResponder responder(kOnvifHost);
+  DiscoveryOptions options = ResponderOptions(responder);
+  options.window = 600ms;
+
+  std::vector<OnvifDevice> devices;
+  DiscoverOnvif(
+      options, [&](const OnvifDevice& device) { devices.push_back(device); });
+
+  EXPECT_EQ(responder.probes(), options.probe_count);
+  ASSERT_EQ(devices.size(), 1u);
+  EXPECT_EQ(FormatIpv4(devices[0].address), kOnvifHost);
+  ASSERT_EQ(devices[0].xaddrs.size(), 1u);
+  EXPECT_EQ(devices[0].xaddrs[0], "http://127.0.0.9/onvif/device_service");
+  EXPECT_EQ(ScopeValue(devices[0].scopes, "name"), "Lobby Cam");
+  EXPECT_EQ(ScopeValue(devices[0].scopes, "hardware"), "IPC-100");
+}
+
+TEST(WsDiscovery, IgnoresRepliesToOtherProbes) {
+  OnvifResponder responder(kOnvifHost, 0ms, /*relate_to_probe=*/false);
+  DiscoveryOptions options = ResponderOptions(responder);
+  options.window = 300ms;
+
+  int found = 0;
+  DiscoverOnvif(options, [&](const OnvifDevice&) { ++found; });
+  EXPECT_GT(responder.probes(), 0);
+  EXPECT_EQ(found, 0);
+}
+
+TEST(WsDiscovery, FinishEndsAfterReplyGraceInsteadOfWindow) {
+  // 回覆延遲 150 ms，仍在 reply_grace 之內，不可因提前結束而遺漏
+  OnvifResponder responder(kOnvifHost, 150ms);
+  DiscoveryOptions options = ResponderOptions(responder);
+  options.window = 5s;
+  options.probe_interval = 50ms;
+  options.reply_grace = 300ms;
+  const std::atomic<bool> finish{true};
+
+  int found = 0;
+  const auto started = Clock::now();
+  DiscoverOnvif(
+      options, [&](const OnvifDevice&) { ++found; }, nullptr, &finish);
+  const auto elapsed = Since(started);
+
+  EXPECT_EQ(found, 1);
+  EXPECT_GE(elapsed, options.probe_interval + options.reply_grace);
+  EXPECT_LT(elapsed, 2s);
+}
+
+TEST(WsDiscovery, WaitsForFinishAfterReplyGrace) {
+  OnvifResponder responder(kOnvifHost);
+  DiscoveryOptions options = ResponderOptions(responder);
+  options.window = 5s;
+  options.reply_grace = 100ms;
+  std::atomic<bool> finish{false};
+
+  const auto started = Clock::now();
+  std::jthread finisher([&] {
+    std::this_thread::sleep_for(600ms);
+    finish.store(true);
+  });
+  DiscoverOnvif(options, [](const OnvifDevice&) {}, nullptr, &finish);
+  const auto elapsed = Since(started);
+
+  EXPECT_GE(elapsed, 600ms);
+  EXPECT_LT(elapsed, 2s);
+}
+
+TEST(IpcScanner, ScansLoopbackStandIns) {
+  TcpListener camera(kCameraHost);
+  OnvifResponder responder(kOnvifHost);
+
+  ScannerConfig config;
+  config.probe.ports = {camera.port()};
+  config.discovery = ResponderOptions(responder);
+  config.discovery.window = 5s;
+  IpcScanner scanner(config);
+
+  ScanOptions options;
+  options.cidr = "127.0.0.1/28";
+  std::map<uint32_t, DeviceInfo> found;
+  const auto started = Clock::now();
+  const ScanSummary summary = scanner.Scan(
+      options, [&](ScanEventKind kind, const DeviceInfo& device) {
+        if (kind != ScanEventKind::kLost) {
+          found[device.address] = device;
+        }
+      });
+  const auto elapsed = Since(started);
+
+  ASSERT_TRUE(summary.ok);
+  EXPECT_TRUE(summary.full_sweep);
+  // .0、.15 與本機 .1 以外的 13 台
+  EXPECT_EQ(summary.hosts_probed, 13u);
+  // 連接埠探測很快結束，discovery 在 reply_grace 後就應收尾
+  EXPECT_LT(elapsed, 2s);
+
+  const uint32_t camera_address = *ParseIpv4(kCameraHost);
+  ASSERT_TRUE(found.contains(camera_address));
+  EXPECT_EQ(
+      found[camera_address].open_ports,
+      std::vector<uint16_t>{camera.port()});
+
+  const uint32_t onvif_address = *ParseIpv4(kOnvifHost);
+  ASSERT_TRUE(found.contains(onvif_address));
+  EXPECT_TRUE(found[onvif_address].onvif);
+  EXPECT_TRUE(found[onvif_address].IsCamera());
+  EXPECT_EQ(ScopeValue(found[onvif_address].scopes, "name"), "Lobby Cam");
+
+  // 第二次掃描命中快取，只重新確認已知裝置
+  const ScanSummary rescan =
+      scanner.Scan(options, [](ScanEventKind, const DeviceInfo&) {});
+  ASSERT_TRUE(rescan.ok);
+  EXPECT_FALSE(rescan.full_sweep);
+  EXPECT_EQ(rescan.hosts_probed, summary.devices);
+  EXPECT_EQ(scanner.Devices().size(), summary.devices);
+}
+
+TEST(IpcScanner, CancelledScanKeepsCache) {
+  OnvifResponder responder(kOnvifHost);
+  ScannerConfig config;
+  config.discovery = ResponderOptions(responder);
+  IpcScanner scanner(config);
+
+  ScanOptions options;
+  options.cidr = "127.0.0.1/28";
+  const std::atomic<bool> cancel{true};
+  const ScanSummary summary = scanner.Scan(
+      options, [](ScanEventKind, const DeviceInfo&) {}, &cancel);
+  EXPECT_FALSE(summary.ok);
+  EXPECT_TRUE(scanner.Devices().empty());
+}
@@ -1,9 +1,287 @@
 #include "grpc/network_service_impl.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "process/subprocess.hpp"
 #include "util/logging.hpp"
 
 namespace iptool::grpcservice {
 
+namespace {
+
+// 同步呼叫等待設定套用的上限（nmcli modify + connection up 的逾時總和
+// 再加上排隊時間）
+constexpr std::chrono::seconds kApplyWaitTimeout{150};
+// 限制單次診斷的執行時間，避免佔用執行器過久
+constexpr uint32_t kMaxDiagnosticAttempts = 20;
+constexpr std::chrono::milliseconds kMaxDiagnosticTimeout{5000};
+
+iptool::OperationState ToProtoState(::OperationState state) {
+  switch (state) {
+    case ::OperationState::kPending:
+      return iptool::OPERATION_STATE_PENDING;
+    case ::OperationState::kRunning:
+      return iptool::OPERATION_STATE_RUNNING;
+    case ::OperationState::kSucceeded:
+      return iptool::OPERATION_STATE_SUCCEEDED;
+    case ::OperationState::kFailed:
+      return iptool::OPERATION_STATE_FAILED;
+    case ::OperationState::kAborted:
+      return iptool::OPERATION_STATE_ABORTED;
+  }
+  return iptool::OPERATION_STATE_UNSPECIFIED;
+}
+
+OperationResult ApplyTarget(const NetworkConfigData& target) {
+  if (target.mode == iptool::NETWORK_MODE_DHCP) {
+    return ::NetworkService::SwitchToDhcp(target.interface_name);
+  }
+  return ::NetworkService::SetManualConfig(target);
+}
+
+void AppendChangedFields(
+    const NetworkConfigData* previous,
+    const NetworkConfigData& current,
+    iptool::NetworkConfigEvent* event) {
+  auto check = [&](const char* name, auto member) {
+    if (!previous || previous->*member != current.*member) {
+      event->add_changed_fields(name);
+    }
+  };
+  check("interface_name", &NetworkConfigData::interface_name);
+  check("ip_address", &NetworkConfigData::ip_address);
+  check("subnet_mask", &NetworkConfigData::subnet_mask);
+  check("gateway", &NetworkConfigData::gateway);
+  check("dns", &NetworkConfigData::dns);
+  check("mode", &NetworkConfigData::mode);
+  check("link_up", &NetworkConfigData::link_up);
+}
+
+void FillProtoRate(const ::LinkRate& rate, iptool::LinkRate* proto_rate) {
+  proto_rate->set_timestamp_ms(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          rate.time.time_since_epoch())
+          .count());
+  proto_rate->set_rx_bps(rate.rx_bps);
+  proto_rate->set_tx_bps(rate.tx_bps);
+  proto_rate->set_rx_pps(rate.rx_pps);
+  proto_rate->set_tx_pps(rate.tx_pps);
+  proto_rate->set_rx_dropped(rate.rx_dropped);
+  proto_rate->set_tx_dropped(rate.tx_dropped);
+  proto_rate->set_rx_errors(rate.rx_errors);
+  proto_rate->set_tx_errors(rate.tx_errors);
+}
+
+iptool::ProbeKind ToProtoKind(::ProbeKind kind) {
+  switch (kind) {
+    case ::ProbeKind::kGateway:
+      return iptool::PROBE_KIND_GATEWAY;
+    case ::ProbeKind::kDns:
+      return iptool::PROBE_KIND_DNS;
+    case ::ProbeKind::kCamera:
+      return iptool::PROBE_KIND_CAMERA;
+  }
+  return iptool::PROBE_KIND_UNSPECIFIED;
+}
+
+void FillProbeResult(const ProbeStats& stats, iptool::ProbeResult* result) {
+  result->set_kind(ToProtoKind(stats.target.kind));
+  result->set_target(
+      std::format("{}:{}", stats.target.host, stats.target.port));
+  result->set_sent(stats.sent);
+  result->set_received(stats.received);
+  result->set_loss(stats.loss_ratio());
+  result->set_min_ms(stats.min_ms);
+  result->set_avg_ms(stats.avg_ms);
+  result->set_max_ms(stats.max_ms);
+  result->set_arp_resolved(stats.arp_resolved);
+  result->set_error(stats.error);
+}
+
+// 解析 host[:port] 清單並加入 targets；遇到格式錯誤時回傳該項目
+std::optional<std::string> AppendEndpoints(
+    const google::protobuf::RepeatedPtrField<std::string>& endpoints,
+    ::ProbeKind kind,
+    uint16_t default_port,
+    std::vector<ProbeTarget>* targets) {
+  for (const auto& endpoint : endpoints) {
+    auto target = ParseProbeEndpoint(endpoint, kind, default_port);
+    if (!target) {
+      return endpoint;
+    }
+    targets->push_back(std::move(*target));
+  }
+  return std::nullopt;
+}
+
+void FillHistogram(
+    const std::string& name,
+    const util::LatencyHistogram& histogram,
+    iptool::LatencyHistogram* proto) {
+  const auto snapshot = histogram.Read();
+  proto->set_name(name);
+  proto->set_count(snapshot.count);
+  proto->set_sum_ms(snapshot.sum_ms);
+  proto->set_max_ms(snapshot.max_ms);
+  proto->set_p50_ms(snapshot.Percentile(0.5));
+  proto->set_p90_ms(snapshot.Percentile(0.9));
+  proto->set_p99_ms(snapshot.Percentile(0.99));
+  for (size_t i = 0; i < snapshot.buckets.size(); ++i) {
+    proto->add_bucket_upper_ms(util::LatencyHistogram::BucketUpperMs(i));
+    proto->add_bucket_counts(snapshot.buckets[i]);
+  }
+}
+
+// 將操作的最終狀態寫入 UpdateNetworkConfig / SwitchToDhcp 的回應
+template <typename Response>
+void FillOperationResult(
+    uint64_t id,
+    const std::optional<OperationStatus>& status,
+    Response* response) {
+  response->set_operation_id(id);
+  if (!status) {
+    response->set_success(false);
+    response->set_message("找不到指定的操作");
+    return;
+  }
+  if (!status->finished()) {
+    response->set_success(false);
+    response->set_message("操作仍在執行中，請以 operation_id 查詢結果");
+    return;
+  }
+  response->set_success(status->result.success);
+  response->set_message(status->result.message);
+}
+
+void FillOperationStatus(
+    const OperationStatus& status,
+    iptool::GetOperationStatusResponse* response) {
+  response->set_operation_id(status.id);
+  response->set_interface_name(status.interface_name);
+  response->set_state(ToProtoState(status.state));
+  response->set_success(status.result.success);
+  response->set_message(status.result.message);
+  response->set_merged_into(status.merged_into);
+}
+
+} // namespace
+
+/**
+ * WatchNetworkConfig 的串流 reactor。訂閱快取的變動通知，同一時間只有
+ * 一個寫入進行中；寫入期間累積的變動在寫入完成後合併成一筆最新快照
+ * 送出。初次載入若需執行 nmcli 會交給執行器，以參考計數確保工作結束前
+ * reactor 不會被釋放。
+ */
+class NetworkServiceGrpc::ConfigWatcher final
+    : public grpc::ServerWriteReactor<iptool::NetworkConfigEvent> {
+ public:
+  ConfigWatcher(NetworkServiceGrpc* service, std::string interface_name)
+      : service_(service), interface_name_(std::move(interface_name)) {
+    subscription_ = service_->cache_.Subscribe(
+        [this](const std::string& name) {
+          if (name == interface_name_) {
+            SendLatest();
+          }
+        });
+    if (service_->cache_.Peek(interface_name_)) {
+      SendLatest();
+      return;
+    }
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    const bool submitted = service_->executor_.TrySubmit([this] {
+      // 其他呼叫可能已先載入而不再觸發通知，成功時主動送出一次
+      if (service_->cache_.Get(interface_name_)) {
+        SendLatest();
+      } else {
+        FinishOnce({grpc::StatusCode::NOT_FOUND, "無法取得指定介面的設定"});
+      }
+      Release();
+    });
+    if (!submitted) {
+      refs_.fetch_sub(1, std::memory_order_relaxed);
+      FinishOnce({grpc::StatusCode::RESOURCE_EXHAUSTED, "系統忙碌中，請稍後再試"});
+    }
+  }
+
+  void OnWriteDone(bool ok) override {
+    {
+      std::lock_guard lock(mutex_);
+      writing_ = false;
+    }
+    if (!ok) {
+      FinishOnce(grpc::Status::OK);
+      return;
+    }
+    SendLatest();
+  }
+
+  void OnCancel() override { FinishOnce(grpc::Status::OK); }
+
+  void OnDone() override {
+    LogInfoFormat("WatchNetworkConfig 結束: {}", interface_name_);
+    // Unsubscribe 回傳後不會再有通知進入 SendLatest
+    service_->cache_.Unsubscribe(subscription_);
+    Release();
+  }
+
+ private:
+  void SendLatest() {
+    std::lock_guard lock(mutex_);
+    if (finished_ || writing_) {
+      // 寫入完成後 OnWriteDone 會再次檢查最新版本
+      return;
+    }
+    auto snapshot = service_->cache_.Peek(interface_name_);
+    if (!snapshot || snapshot->version <= sent_version_) {
+      return;
+    }
+    event_.Clear();
+    FillProtoConfig(snapshot->config, event_.mutable_config());
+    AppendChangedFields(
+        previous_ ? &*previous_ : nullptr, snapshot->config, &event_);
+    event_.set_version(snapshot->version);
+    sent_version_ = snapshot->version;
+    previous_ = std::move(snapshot->config);
+    writing_ = true;
+    StartWrite(&event_);
+  }
+
+  void FinishOnce(grpc::Status status) {
+    {
+      std::lock_guard lock(mutex_);
+      if (finished_) {
+        return;
+      }
+      finished_ = true;
+    }
+    Finish(std::move(status));
+  }
+
+  void Release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  NetworkServiceGrpc* service_;
+  const std::string interface_name_;
+  uint64_t subscription_ = 0;
+  // OnDone 與初次載入的工作各持有一份
+  std::atomic<int> refs_{1};
+  std::mutex mutex_;
+  bool writing_ = false;
+  bool finished_ = false;
+  uint64_t sent_version_ = 0;
+  std::optional<NetworkConfigData> previous_;
+  iptool::NetworkConfigEvent event_;
+};
+
 void NetworkServiceGrpc::FillProtoConfig(
     const NetworkConfigData& data, iptool::NetworkConfig* proto_config) {
   proto_config->set_interface_name(data.interface_name);
@@ -12,34 +290,165 @@ void NetworkServiceGrpc::FillProtoConfig(
   proto_config->set_gateway(data.gateway);
   proto_config->set_dns(data.dns);
   proto_config->set_mode(data.mode);
+  proto_config->set_link_up(data.link_up);
 }
 
-NetworkServiceGrpc::NetworkServiceGrpc() = default;
+NetworkServiceGrpc::NetworkServiceGrpc(ServiceOptions options)
+    : link_stats_(options.link_stats),
+      executor_(options.worker_threads, options.worker_queue),
+      operations_(ApplyTarget, [this](const std::string& interface_name) {
+        // 失敗時設定也可能已部分套用，一律重新讀取
+        cache_.Reload(interface_name);
+      }) {
+  cache_.Start();
+  link_stats_.Start();
+}
+
+std::shared_ptr<UnaryCall> NetworkServiceGrpc::StartCall(
+    std::string_view method) {
+  return UnaryCall::Start(&rpc_latency_.Get(method));
+}
+
+template <typename Request, typename Response, typename Handler>
+grpc::ServerUnaryReactor* NetworkServiceGrpc::Offload(
+    const std::shared_ptr<UnaryCall>& call,
+    const Request& request,
+    Response* response,
+    Handler handler) {
+  auto task = [call, request, response, handler = std::move(handler)] {
+    if (call->cancelled().load(std::memory_order_relaxed)) {
+      return;
+    }
+    // 用戶端取消或 deadline 到期時終止此工作中的 nmcli
+    iptool::process::ScopedCancellation scope(&call->cancelled());
+    Response local;
+    const grpc::Status status = handler(request, &local, call->cancelled());
+    call->Complete([&] {
+      response->Swap(&local);
+      return status;
+    });
+  };
+  if (!executor_.TrySubmit(std::move(task))) {
+    call->Complete(
+        {grpc::StatusCode::RESOURCE_EXHAUSTED, "系統忙碌中，請稍後再試"});
+  }
+  return call->reactor();
+}
 
-grpc::Status NetworkServiceGrpc::GetNetworkConfig(
-    grpc::ServerContext* /*context*/,
+template <typename Response>
+void NetworkServiceGrpc::SubmitOperation(
+    const std::shared_ptr<UnaryCall>& call,
+    NetworkConfigData target,
+    bool no_wait,
+    Response* response,
+    std::vector<ProbeTarget> diagnostics) {
+  // 等待結果的呼叫端取消時，佇列可略過或中止這次套用；旗標的生命期
+  // 由 call 維持
+  NetworkOperationQueue::CancelFlag cancel;
+  if (!no_wait) {
+    cancel = NetworkOperationQueue::CancelFlag(call, &call->cancelled());
+  }
+  const uint64_t id = operations_.Submit(std::move(target), std::move(cancel));
+  if (no_wait) {
+    call->Complete([&] {
+      response->set_operation_id(id);
+      response->set_success(true);
+      response->set_message("已排入佇列");
+      return grpc::Status::OK;
+    });
+    return;
+  }
+
+  call->CompleteAt(
+      std::chrono::system_clock::now() + kApplyWaitTimeout, [id, response] {
+        FillOperationResult(id, std::nullopt, response);
+        response->set_message("操作仍在執行中，請以 operation_id 查詢結果");
+        return grpc::Status::OK;
+      });
+  operations_.NotifyWhenDone(
+      id,
+      [this, call, id, response, diagnostics = std::move(diagnostics)](
+          const std::optional<OperationStatus>& status) {
+        auto complete = [call, id, response, status](
+                            const std::vector<ProbeStats>& results) {
+          call->Complete([&] {
+            FillOperationResult(id, status, response);
+            if constexpr (requires(Response* r) { r->add_diagnostics(); }) {
+              for (const auto& stats : results) {
+                FillProbeResult(stats, response->add_diagnostics());
+              }
+            }
+            return grpc::Status::OK;
+          });
+        };
+        if (!status || !status->result.success || diagnostics.empty()) {
+          complete({});
+          return;
+        }
+        // 確認新設定下 gateway、DNS 與攝影機實際可達
+        auto probe = [call, diagnostics, complete] {
+          complete(RunPathDiagnostics(
+              diagnostics, DiagnosticsOptions{}, [&call] {
+                return call->cancelled().load(std::memory_order_relaxed);
+              }));
+        };
+        const bool submitted = executor_.TrySubmit(std::move(probe));
+        if (!submitted) {
+          LogWarn("執行器忙碌，略過套用後的路徑診斷");
+          complete({});
+        }
+      });
+}
+
+grpc::ServerUnaryReactor* NetworkServiceGrpc::GetNetworkConfig(
+    grpc::CallbackServerContext* /*context*/,
     const iptool::GetNetworkConfigRequest* request,
     iptool::GetNetworkConfigResponse* response) {
   LogInfoFormat("收到 GetNetworkConfig 請求: {}", request->interface_name());
-  auto config = ::NetworkService::GetNetworkConfig(request->interface_name());
-  if (!config) {
-    return {grpc::StatusCode::NOT_FOUND, "無法取得指定介面的設定"};
+  auto call = StartCall("GetNetworkConfig");
+  if (auto snapshot = cache_.Peek(request->interface_name())) {
+    call->Complete([&] {
+      FillProtoConfig(snapshot->config, response->mutable_config());
+      return grpc::Status::OK;
+    });
+    return call->reactor();
   }
-  FillProtoConfig(*config, response->mutable_config());
-  return grpc::Status::OK;
+  // 快取未命中需要執行 nmcli，交給執行器
+  return Offload(
+      call,
+      *request,
+      response,
+      [this](
+          const iptool::GetNetworkConfigRequest& request,
+          iptool::GetNetworkConfigResponse* response,
+          const std::atomic<bool>& /*cancelled*/) -> grpc::Status {
+        auto snapshot = cache_.Get(request.interface_name());
+        if (!snapshot) {
+          return {grpc::StatusCode::NOT_FOUND, "無法取得指定介面的設定"};
+        }
+        FillProtoConfig(snapshot->config, response->mutable_config());
+        return grpc::Status::OK;
+      });
 }
 
-grpc::Status NetworkServiceGrpc::UpdateNetworkConfig(
-    grpc::ServerContext* /*context*/,
+grpc::ServerUnaryReactor* NetworkServiceGrpc::UpdateNetworkConfig(
+    grpc::CallbackServerContext* /*context*/,
     const iptool::UpdateNetworkConfigRequest* request,
     iptool::UpdateNetworkConfigResponse* response) {
   const auto& input = request->config();
   LogInfoFormat("收到 UpdateNetworkConfig 請求: {}", input.interface_name());
+  auto call = StartCall("UpdateNetworkConfig");
+  auto reject = [&](std::string message) {
+    call->Complete([&] {
+      response->set_success(false);
+      response->set_message(std::move(message));
+      return grpc::Status::OK;
+    });
+    return call->reactor();
+  };
 
   if (input.mode() != iptool::NETWORK_MODE_MANUAL) {
-    response->set_success(false);
-    response->set_message("請指定 NETWORK_MODE_MANUAL");
-    return grpc::Status::OK;
+    return reject("請指定 NETWORK_MODE_MANUAL");
   }
 
   NetworkConfigData config;
@@ -50,21 +459,284 @@ grpc::Status NetworkServiceGrpc::UpdateNetworkConfig(
   config.dns = input.dns();
   config.mode = input.mode();
 
-  auto result = ::NetworkService::SetManualConfig(config);
-  response->set_success(result.success);
-  response->set_message(result.message);
-  return grpc::Status::OK;
+  // 格式錯誤的請求不進入佇列，避免取代其他尚未執行的有效設定
+  const auto validation = ::NetworkService::ValidateManualConfig(config);
+  if (!validation.success) {
+    return reject(validation.message);
+  }
+
+  std::vector<ProbeTarget> diagnostic_targets;
+  if (request->run_diagnostics() && !request->no_wait()) {
+    diagnostic_targets = BuildConfigTargets(config.gateway, config.dns);
+    if (auto invalid = AppendEndpoints(
+            request->camera_endpoints(),
+            ::ProbeKind::kCamera,
+            kDefaultCameraPort,
+            &diagnostic_targets)) {
+      return reject(std::format("攝影機端點格式錯誤: {}", *invalid));
+    }
+  }
+
+  SubmitOperation(
+      call,
+      std::move(config),
+      request->no_wait(),
+      response,
+      std::move(diagnostic_targets));
+  return call->reactor();
 }
 
-grpc::Status NetworkServiceGrpc::SwitchToDhcp(
-    grpc::ServerContext* /*context*/,
+grpc::ServerUnaryReactor* NetworkServiceGrpc::SwitchToDhcp(
+    grpc::CallbackServerContext* /*context*/,
     const iptool::SwitchToDhcpRequest* request,
     iptool::SwitchToDhcpResponse* response) {
   LogInfoFormat("收到 SwitchToDhcp 請求: {}", request->interface_name());
-  auto result = ::NetworkService::SwitchToDhcp(request->interface_name());
-  response->set_success(result.success);
-  response->set_message(result.message);
-  return grpc::Status::OK;
+  auto call = StartCall("SwitchToDhcp");
+  if (request->interface_name().empty()) {
+    call->Complete([&] {
+      response->set_success(false);
+      response->set_message("介面名稱不得為空");
+      return grpc::Status::OK;
+    });
+    return call->reactor();
+  }
+  NetworkConfigData target;
+  target.interface_name = request->interface_name();
+  target.mode = iptool::NETWORK_MODE_DHCP;
+  SubmitOperation(call, std::move(target), request->no_wait(), response);
+  return call->reactor();
+}
+
+grpc::ServerUnaryReactor* NetworkServiceGrpc::GetOperationStatus(
+    grpc::CallbackServerContext* /*context*/,
+    const iptool::GetOperationStatusRequest* request,
+    iptool::GetOperationStatusResponse* response) {
+  auto call = StartCall("GetOperationStatus");
+  const uint64_t id = request->operation_id();
+  const auto status = operations_.Status(id);
+  if (!status) {
+    call->Complete({grpc::StatusCode::NOT_FOUND, "找不到指定的操作"});
+    return call->reactor();
+  }
+  if (status->finished() || request->wait_timeout_ms() == 0) {
+    call->Complete([&] {
+      FillOperationStatus(*status, response);
+      return grpc::Status::OK;
+    });
+    return call->reactor();
+  }
+
+  // 等待期間不佔用執行緒：逾時以 alarm 回覆當下狀態，完成時由佇列通知
+  call->CompleteAt(
+      std::chrono::system_clock::now() +
+          std::chrono::milliseconds(request->wait_timeout_ms()),
+      [this, id, response]() -> grpc::Status {
+        const auto current = operations_.Status(id);
+        if (!current) {
+          return {grpc::StatusCode::NOT_FOUND, "找不到指定的操作"};
+        }
+        FillOperationStatus(*current, response);
+        return grpc::Status::OK;
+      });
+  operations_.NotifyWhenDone(
+      id, [call, response](const std::optional<OperationStatus>& done) {
+        call->Complete([&]() -> grpc::Status {
+          if (!done) {
+            return {grpc::StatusCode::NOT_FOUND, "找不到指定的操作"};
+          }
+          FillOperationStatus(*done, response);
+          return grpc::Status::OK;
+        });
+      });
+  return call->reactor();
+}
+
+grpc::ServerUnaryReactor* NetworkServiceGrpc::GetLinkStats(
+    grpc::CallbackServerContext* /*context*/,
+    const iptool::GetLinkStatsRequest* request,
+    iptool::GetLinkStatsResponse* response) {
+  auto call = StartCall("GetLinkStats");
+  const auto snapshots =
+      link_stats_.Get(request->interface_name(), request->history_limit());
+  if (snapshots.empty() && !request->interface_name().empty()) {
+    call->Complete(
+        {grpc::StatusCode::NOT_FOUND, "找不到指定介面的流量統計"});
+    return call->reactor();
+  }
+  const auto interval_ms = static_cast<uint32_t>(
+      link_stats_.options().sample_interval.count());
+  for (const auto& snapshot : snapshots) {
+    auto* link = response->add_links();
+    link->set_interface_name(snapshot.interface_name);
+    link->set_link_up(snapshot.link_up);
+    link->set_speed_mbps(snapshot.speed_mbps);
+    link->set_duplex(snapshot.duplex);
+    link->set_sample_interval_ms(interval_ms);
+    auto* counters = link->mutable_counters();
+    counters->set_rx_bytes(snapshot.counters.rx_bytes);
+    counters->set_tx_bytes(snapshot.counters.tx_bytes);
+    counters->set_rx_packets(snapshot.counters.rx_packets);
+    counters->set_tx_packets(snapshot.counters.tx_packets);
+    counters->set_rx_dropped(snapshot.counters.rx_dropped);
+    counters->set_tx_dropped(snapshot.counters.tx_dropped);
+    counters->set_rx_errors(snapshot.counters.rx_errors);
+    counters->set_tx_errors(snapshot.counters.tx_errors);
+    for (const auto& rate : snapshot.history) {
+      FillProtoRate(rate, link->add_history());
+    }
+    if (snapshot.history.empty()) {
+      continue;
+    }
+    const auto& current = snapshot.history.back();
+    FillProtoRate(current, link->mutable_current());
+    if (snapshot.speed_mbps > 0) {
+      const double capacity = snapshot.speed_mbps * 1e6;
+      link->set_rx_utilization(std::min(current.rx_bps / capacity, 1.0));
+      link->set_tx_utilization(std::min(current.tx_bps / capacity, 1.0));
+    }
+  }
+  call->Complete(grpc::Status::OK);
+  return call->reactor();
+}
+
+grpc::ServerUnaryReactor* NetworkServiceGrpc::RunDiagnostics(
+    grpc::CallbackServerContext* /*context*/,
+    const iptool::RunDiagnosticsRequest* request,
+    iptool::RunDiagnosticsResponse* response) {
+  LogInfoFormat("收到 RunDiagnostics 請求: {}", request->interface_name());
+  // 探測與可能的 nmcli 讀取都會阻塞，整段交給執行器
+  return Offload(
+      StartCall("RunDiagnostics"),
+      *request,
+      response,
+      [this](
+          const iptool::RunDiagnosticsRequest& request,
+          iptool::RunDiagnosticsResponse* response,
+          const std::atomic<bool>& cancelled) -> grpc::Status {
+        // 未在請求中指定的 gateway 與 dns 取自介面目前的設定
+        std::string gateway = request.gateway();
+        std::string config_dns;
+        if (!request.interface_name().empty() &&
+            (gateway.empty() || request.dns_servers().empty())) {
+          const auto snapshot = cache_.Get(request.interface_name());
+          if (!snapshot) {
+            return {grpc::StatusCode::NOT_FOUND, "無法取得指定介面的設定"};
+          }
+          if (gateway.empty()) {
+            gateway = snapshot->config.gateway;
+          }
+          config_dns = snapshot->config.dns;
+        }
+
+        std::vector<ProbeTarget> targets;
+        if (!gateway.empty()) {
+          auto target = ParseProbeEndpoint(
+              gateway, ::ProbeKind::kGateway, kDefaultGatewayProbePort);
+          if (!target) {
+            return {grpc::StatusCode::INVALID_ARGUMENT, "gateway 格式錯誤"};
+          }
+          targets.push_back(std::move(*target));
+        }
+        if (request.dns_servers().empty()) {
+          auto dns_targets = BuildConfigTargets({}, config_dns);
+          targets.insert(targets.end(), dns_targets.begin(), dns_targets.end());
+        } else if (auto invalid = AppendEndpoints(
+                       request.dns_servers(),
+                       ::ProbeKind::kDns,
+                       kDefaultDnsPort,
+                       &targets)) {
+          return {
+              grpc::StatusCode::INVALID_ARGUMENT,
+              std::format("dns 伺服器格式錯誤: {}", *invalid)};
+        }
+        if (auto invalid = AppendEndpoints(
+                request.camera_endpoints(),
+                ::ProbeKind::kCamera,
+                kDefaultCameraPort,
+                &targets)) {
+          return {
+              grpc::StatusCode::INVALID_ARGUMENT,
+              std::format("攝影機端點格式錯誤: {}", *invalid)};
+        }
+        if (targets.empty()) {
+          return {grpc::StatusCode::INVALID_ARGUMENT, "沒有可探測的目標"};
+        }
+
+        DiagnosticsOptions options;
+        if (request.attempts() > 0) {
+          options.attempts =
+              std::min(request.attempts(), kMaxDiagnosticAttempts);
+        }
+        if (request.timeout_ms() > 0) {
+          options.timeout = std::min(
+              std::chrono::milliseconds(request.timeout_ms()),
+              kMaxDiagnosticTimeout);
+        }
+        if (!request.dns_query_name().empty()) {
+          options.dns_query_name = request.dns_query_name();
+        }
+
+        const auto results = RunPathDiagnostics(targets, options, [&cancelled] {
+          return cancelled.load(std::memory_order_relaxed);
+        });
+        if (cancelled.load(std::memory_order_relaxed)) {
+          return {grpc::StatusCode::CANCELLED, "診斷已取消"};
+        }
+        size_t unreachable = 0;
+        for (const auto& stats : results) {
+          FillProbeResult(stats, response->add_results());
+          if (!stats.reachable()) {
+            ++unreachable;
+          }
+        }
+        response->set_success(unreachable == 0);
+        response->set_message(
+            unreachable == 0 ? "所有目標皆可達"
+                             : std::format("{} 個目標無回應", unreachable));
+        return grpc::Status::OK;
+      });
+}
+
+grpc::ServerUnaryReactor* NetworkServiceGrpc::GetServiceStats(
+    grpc::CallbackServerContext* /*context*/,
+    const iptool::GetServiceStatsRequest* request,
+    iptool::GetServiceStatsResponse* response) {
+  auto call = StartCall("GetServiceStats");
+  call->Complete([&] {
+    auto& subprocesses = iptool::process::SubprocessLatencies();
+    rpc_latency_.ForEach(
+        [&](
+            const std::string& name,
+            const util::LatencyHistogram& histogram) {
+          FillHistogram(name, histogram, response->add_rpcs());
+        });
+    subprocesses.ForEach(
+        [&](
+            const std::string& name,
+            const util::LatencyHistogram& histogram) {
+          FillHistogram(name, histogram, response->add_subprocesses());
+        });
+    const auto stats = executor_.stats();
+    auto* executor = response->mutable_executor();
+    executor->set_threads(stats.threads);
+    executor->set_queued(stats.queued);
+    executor->set_active(stats.active);
+    executor->set_rejected(stats.rejected);
+    if (request->reset()) {
+      rpc_latency_.Reset();
+      subprocesses.Reset();
+    }
+    return grpc::Status::OK;
+  });
+  return call->reactor();
+}
+
+grpc::ServerWriteReactor<iptool::NetworkConfigEvent>*
+NetworkServiceGrpc::WatchNetworkConfig(
+    grpc::CallbackServerContext* /*context*/,
+    const iptool::WatchNetworkConfigRequest* request) {
+  LogInfoFormat("收到 WatchNetworkConfig 請求: {}", request->interface_name());
+  return new ConfigWatcher(this, request->interface_name());
 }
 
 } // namespace iptool::grpcservice
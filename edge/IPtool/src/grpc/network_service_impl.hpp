@@ -1,35 +1,118 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
 #include <grpcpp/grpcpp.h>
 
+#include "grpc/unary_call.hpp"
 #include "iptool.grpc.pb.h"
+#include "network/config_cache.hpp"
+#include "network/link_stats.hpp"
 #include "network/network_service.hpp"
+#include "network/operation_queue.hpp"
+#include "network/path_diagnostics.hpp"
+#include "util/bounded_executor.hpp"
+#include "util/latency_histogram.hpp"
 
 namespace iptool::grpcservice {
 
-class NetworkServiceGrpc final : public iptool::NetworkService::Service {
+struct ServiceOptions {
+  LinkStatsOptions link_stats;
+  // 執行 nmcli、網路探測等阻塞工作的執行緒數與等待佇列長度
+  uint32_t worker_threads = 2;
+  uint32_t worker_queue = 16;
+};
+
+/**
+ * 以 callback API 實作的 NetworkService。gRPC 執行緒只處理記憶體內的
+ * 查詢與排程，會阻塞的工作交給有界的執行器，等待設定套用則以佇列的
+ * 完成通知回覆，不佔用任何執行緒。用戶端取消或 deadline 到期時，執行中
+ * 的子行程會一併被終止。
+ */
+class NetworkServiceGrpc final
+    : public iptool::NetworkService::CallbackService {
  public:
-  explicit NetworkServiceGrpc();
+  explicit NetworkServiceGrpc(ServiceOptions options = {});
   ~NetworkServiceGrpc() override = default;
 
-  grpc::Status GetNetworkConfig(
-      grpc::ServerContext* context,
+  grpc::ServerUnaryReactor* GetNetworkConfig(
+      grpc::CallbackServerContext* context,
       const iptool::GetNetworkConfigRequest* request,
       iptool::GetNetworkConfigResponse* response) override;
 
-  grpc::Status UpdateNetworkConfig(
-      grpc::ServerContext* context,
+  grpc::ServerUnaryReactor* UpdateNetworkConfig(
+      grpc::CallbackServerContext* context,
       const iptool::UpdateNetworkConfigRequest* request,
       iptool::UpdateNetworkConfigResponse* response) override;
 
-  grpc::Status SwitchToDhcp(
-      grpc::ServerContext* context,
+  grpc::ServerUnaryReactor* SwitchToDhcp(
+      grpc::CallbackServerContext* context,
       const iptool::SwitchToDhcpRequest* request,
       iptool::SwitchToDhcpResponse* response) override;
 
+  grpc::ServerUnaryReactor* GetOperationStatus(
+      grpc::CallbackServerContext* context,
+      const iptool::GetOperationStatusRequest* request,
+      iptool::GetOperationStatusResponse* response) override;
+
+  grpc::ServerUnaryReactor* GetLinkStats(
+      grpc::CallbackServerContext* context,
+      const iptool::GetLinkStatsRequest* request,
+      iptool::GetLinkStatsResponse* response) override;
+
+  grpc::ServerUnaryReactor* RunDiagnostics(
+      grpc::CallbackServerContext* context,
+      const iptool::RunDiagnosticsRequest* request,
+      iptool::RunDiagnosticsResponse* response) override;
+
+  grpc::ServerUnaryReactor* GetServiceStats(
+      grpc::CallbackServerContext* context,
+      const iptool::GetServiceStatsRequest* request,
+      iptool::GetServiceStatsResponse* response) override;
+
+  grpc::ServerWriteReactor<iptool::NetworkConfigEvent>* WatchNetworkConfig(
+      grpc::CallbackServerContext* context,
+      const iptool::WatchNetworkConfigRequest* request) override;
+
  private:
+  class ConfigWatcher;
+
   static void FillProtoConfig(
       const NetworkConfigData& data, iptool::NetworkConfig* proto_config);
+
+  std::shared_ptr<UnaryCall> StartCall(std::string_view method);
+
+  // 在執行器上以 request 的複本執行 handler，結果先寫入私有的回應，
+  // 完成時才交換進 gRPC 的回應；佇列已滿時回覆 RESOURCE_EXHAUSTED
+  template <typename Request, typename Response, typename Handler>
+  grpc::ServerUnaryReactor* Offload(
+      const std::shared_ptr<UnaryCall>& call,
+      const Request& request,
+      Response* response,
+      Handler handler);
+
+  // 排入設定佇列；no_wait 時立即回覆操作 ID，否則在套用完成後回覆，
+  // diagnostics 非空時套用成功後再執行路徑診斷
+  template <typename Response>
+  void SubmitOperation(
+      const std::shared_ptr<UnaryCall>& call,
+      NetworkConfigData target,
+      bool no_wait,
+      Response* response,
+      std::vector<ProbeTarget> diagnostics = {});
+
+  util::LatencyRegistry rpc_latency_;
+  LinkStatsSampler link_stats_;
+  NetworkConfigCache cache_;
+  // 執行器的工作只使用 cache_；宣告於 operations_ 之前，佇列完成通知
+  // 排入的診斷工作在佇列結束前都能提交
+  util::BoundedExecutor executor_;
+  // 最後宣告：解構時先等待佇列執行緒結束
+  NetworkOperationQueue operations_;
 };
 
 } // namespace iptool::grpcservice
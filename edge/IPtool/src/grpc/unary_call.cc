@@ -0,0 +1,71 @@
+#include "grpc/unary_call.hpp"
+
+namespace iptool::grpcservice {
+
+class UnaryCall::Reactor final : public grpc::ServerUnaryReactor {
+ public:
+  explicit Reactor(std::shared_ptr<UnaryCall> call) : call_(std::move(call)) {}
+
+  void OnCancel() override {
+    call_->cancelled_.store(true, std::memory_order_relaxed);
+    call_->Complete(grpc::Status::CANCELLED);
+  }
+
+  void OnDone() override { delete this; }
+
+ private:
+  // reactor 存活期間保持 UnaryCall 有效
+  std::shared_ptr<UnaryCall> call_;
+};
+
+UnaryCall::UnaryCall(util::LatencyHistogram* latency)
+    : latency_(latency), started_(std::chrono::steady_clock::now()) {}
+
+std::shared_ptr<UnaryCall> UnaryCall::Start(util::LatencyHistogram* latency) {
+  std::shared_ptr<UnaryCall> call(new UnaryCall(latency));
+  call->reactor_ = new Reactor(call);
+  return call;
+}
+
+grpc::ServerUnaryReactor* UnaryCall::reactor() const {
+  return reactor_;
+}
+
+bool UnaryCall::Complete(const Fill& fill) {
+  grpc::Status status;
+  {
+    std::lock_guard lock(mutex_);
+    if (finished_) {
+      return false;
+    }
+    status = fill();
+    finished_ = true;
+  }
+  if (latency_) {
+    latency_->Record(std::chrono::steady_clock::now() - started_);
+  }
+  // Finish 之後 reactor 可能隨時被 OnDone 釋放，不再使用 reactor_
+  reactor_->Finish(status);
+  return true;
+}
+
+void UnaryCall::CompleteAt(
+    std::chrono::system_clock::time_point deadline, Fill fill) {
+  std::weak_ptr<UnaryCall> weak = weak_from_this();
+  std::lock_guard lock(mutex_);
+  if (finished_) {
+    return;
+  }
+  alarm_.emplace();
+  alarm_->Set(deadline, [weak, fill = std::move(fill)](bool fired) {
+    // UnaryCall 解構時 alarm 會被取消，fired 為 false
+    if (!fired) {
+      return;
+    }
+    if (auto call = weak.lock()) {
+      call->Complete(fill);
+    }
+  });
+}
+
+} // namespace iptool::grpcservice
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <grpcpp/alarm.h>
+#include <grpcpp/grpcpp.h>
+
+#include "util/latency_histogram.hpp"
+
+namespace iptool::grpcservice {
+
+/**
+ * callback API 下單次 unary RPC 的完成狀態。回應可能由 gRPC 執行緒、
+ * 背景執行器或設定佇列的執行緒完成，用戶端取消（含 deadline 到期）也
+ * 隨時可能發生；Complete 保證只有第一個完成者寫入回應並呼叫 Finish，
+ * 之後的嘗試直接忽略，不會碰觸已由 gRPC 釋放的 request/response。
+ */
+class UnaryCall : public std::enable_shared_from_this<UnaryCall> {
+ public:
+  using Fill = std::function<grpc::Status()>;
+
+  // 建立 reactor 並開始計時；handler 必須回傳 reactor()
+  static std::shared_ptr<UnaryCall> Start(util::LatencyHistogram* latency);
+
+  UnaryCall(const UnaryCall&) = delete;
+  UnaryCall& operator=(const UnaryCall&) = delete;
+
+  grpc::ServerUnaryReactor* reactor() const;
+
+  // 用戶端取消或 deadline 到期後為 true，可交給 ScopedCancellation
+  const std::atomic<bool>& cancelled() const { return cancelled_; }
+
+  // 尚未完成時在持有鎖的情況下呼叫 fill 填入回應並 Finish；
+  // 已完成時不呼叫 fill，回傳 false
+  bool Complete(const Fill& fill);
+
+  bool Complete(grpc::Status status) {
+    return Complete([&] { return status; });
+  }
+
+  // 在 deadline 時以 fill 完成（若尚未完成），用於等待的上限
+  void CompleteAt(std::chrono::system_clock::time_point deadline, Fill fill);
+
+ private:
+  class Reactor;
+
+  explicit UnaryCall(util::LatencyHistogram* latency);
+
+  Reactor* reactor_ = nullptr;
+  util::LatencyHistogram* latency_;
+  const std::chrono::steady_clock::time_point started_;
+  std::atomic<bool> cancelled_{false};
+  std::mutex mutex_;
+  bool finished_ = false;
+  std::optional<grpc::Alarm> alarm_;
+};
+
+} // namespace iptool::grpcservice
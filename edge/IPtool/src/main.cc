@@ -1,17 +1,60 @@
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <print>
 #include <string>
+#include <string_view>
 
 #include <grpcpp/grpcpp.h>
 
 #include "grpc/network_service_impl.hpp"
 #include "util/logging.hpp"
 
+namespace {
+
+// 讀取正整數環境變數；未設定或格式錯誤時回傳 fallback
+template <typename T>
+T ReadPositiveEnv(const char* name, T fallback) {
+  const char* raw = std::getenv(name);
+  if (!raw) {
+    return fallback;
+  }
+  const std::string_view text(raw);
+  T value{};
+  const auto [ptr, ec] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  if (ec != std::errc{} || ptr != text.data() + text.size() || value <= 0) {
+    LogWarnFormat("忽略無效的環境變數 {}={}", name, text);
+    return fallback;
+  }
+  return value;
+}
+
+} // namespace
+
 int main(int argc, char* argv[]) {
   std::string server_address = "0.0.0.0:20002";
 
-  iptool::grpcservice::NetworkServiceGrpc service{};
+  iptool::grpcservice::ServiceOptions options;
+  auto& link_stats = options.link_stats;
+  link_stats.sample_interval = std::chrono::milliseconds(
+      ReadPositiveEnv<int64_t>(
+          "IPTOOL_STATS_INTERVAL_MS", link_stats.sample_interval.count()));
+  link_stats.history_size =
+      ReadPositiveEnv<size_t>("IPTOOL_STATS_HISTORY", link_stats.history_size);
+  options.worker_threads = ReadPositiveEnv<uint32_t>(
+      "IPTOOL_WORKER_THREADS", options.worker_threads);
+  options.worker_queue =
+      ReadPositiveEnv<uint32_t>("IPTOOL_WORKER_QUEUE", options.worker_queue);
+
+  iptool::grpcservice::NetworkServiceGrpc service{options};
   grpc::ServerBuilder builder;
+  // 限制 gRPC 本身的執行緒數；callback API 下此上限為近似值
+  grpc::ResourceQuota quota("iptool");
+  quota.SetMaxThreads(ReadPositiveEnv<int>("IPTOOL_GRPC_MAX_THREADS", 4));
+  builder.SetResourceQuota(quota);
   builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
   builder.RegisterService(&service);
 
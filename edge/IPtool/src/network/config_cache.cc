@@ -0,0 +1,194 @@
+#include "network/config_cache.hpp"
+
+#include <algorithm>
+
+#include <net/if.h>
+
+#include "util/logging.hpp"
+
+NetworkConfigCache::NetworkConfigCache()
+    : monitor_([this](const std::vector<int>& indexes, bool full_resync) {
+        OnKernelEvent(indexes, full_resync);
+      }) {}
+
+void NetworkConfigCache::Start() {
+  if (!monitor_.Start()) {
+    LogWarn("netlink 監聽啟動失敗，網路設定快取只會在套用設定後更新");
+  }
+}
+
+std::optional<NetworkConfigCache::Snapshot> NetworkConfigCache::Get(
+    const std::string& interface_name) {
+  {
+    std::lock_guard lock(mutex_);
+    if (auto it = entries_.find(interface_name); it != entries_.end()) {
+      return Snapshot{it->second.config, it->second.version};
+    }
+  }
+  auto config = NetworkService::GetNetworkConfig(interface_name);
+  if (!config) {
+    return std::nullopt;
+  }
+  return Store(interface_name, std::move(*config));
+}
+
+void NetworkConfigCache::Reload(const std::string& interface_name) {
+  auto config = NetworkService::GetNetworkConfig(interface_name);
+  if (!config) {
+    LogWarnFormat("重新讀取介面 {} 設定失敗", interface_name);
+    return;
+  }
+  Store(interface_name, std::move(*config));
+}
+
+std::optional<NetworkConfigCache::Snapshot> NetworkConfigCache::Peek(
+    const std::string& interface_name) const {
+  std::lock_guard lock(mutex_);
+  if (auto it = entries_.find(interface_name); it != entries_.end()) {
+    return Snapshot{it->second.config, it->second.version};
+  }
+  return std::nullopt;
+}
+
+uint64_t NetworkConfigCache::Subscribe(Listener listener) {
+  auto subscription = std::make_shared<Subscription>();
+  subscription->listener = std::move(listener);
+  std::lock_guard lock(listeners_mutex_);
+  const uint64_t id = ++next_listener_id_;
+  listeners_.emplace(id, std::move(subscription));
+  return id;
+}
+
+void NetworkConfigCache::Unsubscribe(uint64_t id) {
+  std::shared_ptr<Subscription> subscription;
+  {
+    std::lock_guard lock(listeners_mutex_);
+    auto it = listeners_.find(id);
+    if (it == listeners_.end()) {
+      return;
+    }
+    subscription = std::move(it->second);
+    listeners_.erase(it);
+  }
+  // 等待其他執行緒上進行中的呼叫結束
+  std::lock_guard calling(subscription->calling);
+  subscription->active = false;
+}
+
+NetworkConfigCache::Snapshot NetworkConfigCache::Store(
+    const std::string& interface_name, NetworkConfigData config) {
+  const int index =
+      static_cast<int>(::if_nametoindex(interface_name.c_str()));
+  Snapshot snapshot;
+  bool changed = false;
+  {
+    std::lock_guard lock(mutex_);
+    auto& entry = entries_[interface_name];
+    entry.index = index;
+    if (entry.version == 0 || !(entry.config == config)) {
+      entry.config = std::move(config);
+      entry.version = ++next_version_;
+      changed = true;
+    }
+    snapshot = Snapshot{entry.config, entry.version};
+  }
+  if (changed) {
+    NotifyListeners(interface_name);
+  }
+  return snapshot;
+}
+
+void NetworkConfigCache::MergeKernelState(
+    const std::string& interface_name, const NetworkConfigData& kernel) {
+  {
+    std::lock_guard lock(mutex_);
+    auto it = entries_.find(interface_name);
+    if (it == entries_.end()) {
+      return;
+    }
+    NetworkConfigData& config = it->second.config;
+    if (config.ip_address == kernel.ip_address &&
+        config.subnet_mask == kernel.subnet_mask &&
+        config.gateway == kernel.gateway && config.link_up == kernel.link_up) {
+      return;
+    }
+    config.ip_address = kernel.ip_address;
+    config.subnet_mask = kernel.subnet_mask;
+    config.gateway = kernel.gateway;
+    config.link_up = kernel.link_up;
+    it->second.version = ++next_version_;
+  }
+  NotifyListeners(interface_name);
+}
+
+void NetworkConfigCache::StoreIfVersion(
+    const std::string& interface_name,
+    NetworkConfigData config,
+    uint64_t expected_version) {
+  {
+    std::lock_guard lock(mutex_);
+    auto it = entries_.find(interface_name);
+    if (it == entries_.end() || it->second.version != expected_version ||
+        it->second.config == config) {
+      return;
+    }
+    it->second.config = std::move(config);
+    it->second.version = ++next_version_;
+  }
+  NotifyListeners(interface_name);
+}
+
+void NetworkConfigCache::NotifyListeners(const std::string& interface_name) {
+  std::vector<std::shared_ptr<Subscription>> subscriptions;
+  {
+    std::lock_guard lock(listeners_mutex_);
+    subscriptions.reserve(listeners_.size());
+    for (const auto& [id, subscription] : listeners_) {
+      subscriptions.push_back(subscription);
+    }
+  }
+  for (const auto& subscription : subscriptions) {
+    std::lock_guard calling(subscription->calling);
+    if (subscription->active) {
+      subscription->listener(interface_name);
+    }
+  }
+}
+
+void NetworkConfigCache::OnKernelEvent(
+    const std::vector<int>& indexes, bool full_resync) {
+  // 先在鎖內複製需要更新的項目與版本，讀取 kernel 狀態時不持有鎖；
+  // 寫回時只合併 kernel 欄位或確認版本未變，不會蓋掉期間的 Reload
+  struct Target {
+    NetworkConfigData config;
+    uint64_t version = 0;
+  };
+  std::vector<Target> targets;
+  {
+    std::lock_guard lock(mutex_);
+    for (const auto& [name, entry] : entries_) {
+      if (full_resync || std::ranges::find(indexes, entry.index) !=
+              indexes.end()) {
+        targets.push_back(Target{entry.config, entry.version});
+      }
+    }
+  }
+
+  for (auto& [config, version] : targets) {
+    const std::string name = config.interface_name;
+    if (NetworkService::RefreshKernelState(&config)) {
+      MergeKernelState(name, config);
+      continue;
+    }
+    // 介面失去 IPv4 位址或已移除，改走完整讀取
+    if (auto reloaded = NetworkService::GetNetworkConfig(name)) {
+      StoreIfVersion(name, std::move(*reloaded), version);
+    } else {
+      config.ip_address.clear();
+      config.subnet_mask.clear();
+      config.gateway.clear();
+      config.link_up = false;
+      MergeKernelState(name, config);
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "network/netlink_monitor.hpp"
+#include "network/network_service.hpp"
+
+/**
+ * 各介面網路設定的記憶體快照。查詢直接回傳快照；只有在收到 netlink
+ * 事件或 IPtool 自行套用設定後才重新讀取，讀取結果有變動時遞增版本並
+ * 通知訂閱者。
+ */
+class NetworkConfigCache {
+ public:
+  struct Snapshot {
+    NetworkConfigData config;
+    uint64_t version = 0;
+  };
+
+  NetworkConfigCache();
+  ~NetworkConfigCache() = default;
+  NetworkConfigCache(const NetworkConfigCache&) = delete;
+  NetworkConfigCache& operator=(const NetworkConfigCache&) = delete;
+
+  // 啟動 netlink 監聽；失敗時快取仍可用，但只會在 Reload 時更新
+  void Start();
+
+  // 回傳快照；尚未載入的介面會先完整讀取一次（可能執行 nmcli）
+  std::optional<Snapshot> Get(const std::string& interface_name);
+
+  // 只回傳已載入的快照，不會阻塞
+  std::optional<Snapshot> Peek(const std::string& interface_name) const;
+
+  // 完整重新讀取（含 nmcli），用於 IPtool 自行套用設定之後
+  void Reload(const std::string& interface_name);
+
+  // 介面版本遞增後，在更新的執行緒上（不持有快取的鎖）呼叫 listener；
+  // Unsubscribe 回傳後保證不會再被呼叫。listener 內可以訂閱或取消訂閱
+  // （包含取消自己）
+  using Listener = std::function<void(const std::string& interface_name)>;
+  uint64_t Subscribe(Listener listener);
+  void Unsubscribe(uint64_t id);
+
+ private:
+  struct Entry {
+    int index = 0;
+    NetworkConfigData config;
+    uint64_t version = 0;
+  };
+
+  // calling 在每次呼叫 listener 期間持有，Unsubscribe 藉此等待進行中的
+  // 呼叫結束；recursive_mutex 讓 listener 在回呼內取消自己時不會卡住
+  struct Subscription {
+    Listener listener;
+    std::recursive_mutex calling;
+    bool active = true;
+  };
+
+  void OnKernelEvent(const std::vector<int>& indexes, bool full_resync);
+  // 寫入新設定，內容有變動時遞增版本並通知訂閱者
+  Snapshot Store(const std::string& interface_name, NetworkConfigData config);
+  // 只合併 kernel 管理的欄位（位址、遮罩、閘道、連線狀態），mode 與 dns
+  // 維持快取中的值，避免覆蓋同時發生的 Reload
+  void MergeKernelState(
+      const std::string& interface_name, const NetworkConfigData& kernel);
+  // 項目版本仍為 expected_version 時才寫入，否則代表期間已有較新的讀取
+  void StoreIfVersion(
+      const std::string& interface_name,
+      NetworkConfigData config,
+      uint64_t expected_version);
+  void NotifyListeners(const std::string& interface_name);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  uint64_t next_version_ = 0;
+  // 只保護 listeners_ 本身；通知時先複製清單，呼叫 listener 時不持有
+  std::mutex listeners_mutex_;
+  std::map<uint64_t, std::shared_ptr<Subscription>> listeners_;
+  uint64_t next_listener_id_ = 0;
+  iptool::netlink::NetlinkMonitor monitor_;
+};
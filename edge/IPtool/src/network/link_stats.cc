@@ -0,0 +1,205 @@
+#include "network/link_stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "util/logging.hpp"
+
+namespace {
+
+// 讀取 /sys/class/net/<name>/<attribute> 的第一行
+std::string ReadSysfsAttribute(
+    const std::string& interface_name, std::string_view attribute) {
+  std::string path = "/sys/class/net/";
+  path += interface_name;
+  path += '/';
+  path += attribute;
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return {};
+  }
+  std::array<char, 64> buffer{};
+  ssize_t n = 0;
+  do {
+    n = ::read(fd, buffer.data(), buffer.size());
+  } while (n < 0 && errno == EINTR);
+  ::close(fd);
+  if (n <= 0) {
+    // 介面 down 時 speed 會回傳 EINVAL
+    return {};
+  }
+  std::string_view text(buffer.data(), static_cast<size_t>(n));
+  return std::string(text.substr(0, text.find('\n')));
+}
+
+int ParseSpeed(const std::string& text) {
+  int speed = -1;
+  const auto [end, ec] =
+      std::from_chars(text.data(), text.data() + text.size(), speed);
+  if (ec != std::errc{} || speed <= 0) {
+    return -1;
+  }
+  return speed;
+}
+
+// 計數器因介面重建而歸零時，增量以 0 計
+uint64_t Delta(uint64_t current, uint64_t previous) {
+  return current >= previous ? current - previous : 0;
+}
+
+} // namespace
+
+LinkStatsSampler::LinkStatsSampler(LinkStatsOptions options)
+    : options_(options) {
+  options_.history_size = std::max<size_t>(options_.history_size, 2);
+  options_.sample_interval =
+      std::max(options_.sample_interval, std::chrono::milliseconds(100));
+}
+
+void LinkStatsSampler::Start() {
+  SampleOnce();
+  thread_ = std::jthread([this](std::stop_token stop) { Run(stop); });
+}
+
+void LinkStatsSampler::Run(std::stop_token stop) {
+  std::mutex wait_mutex;
+  std::condition_variable_any wake;
+  auto next = std::chrono::steady_clock::now();
+  while (!stop.stop_requested()) {
+    // 取樣落後時不補做，直接從現在重新計時
+    next = std::max(
+        next + options_.sample_interval, std::chrono::steady_clock::now());
+    {
+      std::unique_lock lock(wait_mutex);
+      wake.wait_until(lock, stop, next, [] { return false; });
+    }
+    if (stop.stop_requested()) {
+      break;
+    }
+    SampleOnce();
+  }
+}
+
+void LinkStatsSampler::SampleOnce() {
+  auto interfaces = iptool::netlink::ReadInterfaceCounters();
+  if (interfaces.empty()) {
+    return;
+  }
+  const auto now = std::chrono::system_clock::now();
+  const auto steady = std::chrono::steady_clock::now();
+
+  // sysfs 讀取在鎖外完成
+  struct Link {
+    iptool::netlink::InterfaceCounters* entry;
+    int speed_mbps;
+    std::string duplex;
+  };
+  std::vector<Link> links;
+  for (auto& entry : interfaces) {
+    if (entry.loopback) {
+      continue;
+    }
+    links.push_back(Link{
+        &entry,
+        ParseSpeed(ReadSysfsAttribute(entry.name, "speed")),
+        ReadSysfsAttribute(entry.name, "duplex")});
+  }
+
+  std::lock_guard lock(mutex_);
+  ++generation_;
+  for (auto& link : links) {
+    auto& series = series_[link.entry->name];
+    if (series.samples.empty()) {
+      series.samples.resize(options_.history_size);
+    }
+    series.link_up = link.entry->link_up;
+    series.speed_mbps = link.speed_mbps;
+    series.duplex = std::move(link.duplex);
+    series.samples[series.next] =
+        Sample{now, steady, link.entry->counters};
+    series.next = (series.next + 1) % series.samples.size();
+    series.count = std::min(series.count + 1, series.samples.size());
+    series.generation = generation_;
+  }
+  // 已移除的介面
+  std::erase_if(series_, [&](const auto& item) {
+    return item.second.generation != generation_;
+  });
+}
+
+LinkStatsSnapshot LinkStatsSampler::Snapshot(
+    const std::string& name, const Series& series, size_t limit) const {
+  LinkStatsSnapshot snapshot;
+  snapshot.interface_name = name;
+  snapshot.link_up = series.link_up;
+  snapshot.speed_mbps = series.speed_mbps;
+  snapshot.duplex = series.duplex;
+
+  const size_t capacity = series.samples.size();
+  auto at = [&](size_t age) -> const Sample& {
+    // age 0 為最新的樣本
+    return series.samples[(series.next + capacity - 1 - age) % capacity];
+  };
+  if (series.count == 0) {
+    return snapshot;
+  }
+  snapshot.counters = at(0).counters;
+
+  size_t rates = series.count - 1;
+  if (limit > 0) {
+    rates = std::min(rates, limit);
+  }
+  snapshot.history.reserve(rates);
+  for (size_t age = rates; age-- > 0;) {
+    const Sample& current = at(age);
+    const Sample& previous = at(age + 1);
+    const double seconds =
+        std::chrono::duration<double>(current.steady - previous.steady)
+            .count();
+    if (seconds <= 0) {
+      continue;
+    }
+    const auto& c = current.counters;
+    const auto& p = previous.counters;
+    LinkRate rate;
+    rate.time = current.time;
+    rate.rx_bps = static_cast<double>(Delta(c.rx_bytes, p.rx_bytes)) * 8 /
+        seconds;
+    rate.tx_bps = static_cast<double>(Delta(c.tx_bytes, p.tx_bytes)) * 8 /
+        seconds;
+    rate.rx_pps =
+        static_cast<double>(Delta(c.rx_packets, p.rx_packets)) / seconds;
+    rate.tx_pps =
+        static_cast<double>(Delta(c.tx_packets, p.tx_packets)) / seconds;
+    rate.rx_dropped = Delta(c.rx_dropped, p.rx_dropped);
+    rate.tx_dropped = Delta(c.tx_dropped, p.tx_dropped);
+    rate.rx_errors = Delta(c.rx_errors, p.rx_errors);
+    rate.tx_errors = Delta(c.tx_errors, p.tx_errors);
+    snapshot.history.push_back(rate);
+  }
+  return snapshot;
+}
+
+std::vector<LinkStatsSnapshot> LinkStatsSampler::Get(
+    const std::string& interface_name, size_t history_limit) const {
+  std::vector<LinkStatsSnapshot> result;
+  std::lock_guard lock(mutex_);
+  if (!interface_name.empty()) {
+    if (auto it = series_.find(interface_name); it != series_.end()) {
+      result.push_back(Snapshot(it->first, it->second, history_limit));
+    }
+    return result;
+  }
+  for (const auto& [name, series] : series_) {
+    result.push_back(Snapshot(name, series, history_limit));
+  }
+  std::ranges::sort(result, {}, &LinkStatsSnapshot::interface_name);
+  return result;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "network/netlink_reader.hpp"
+
+struct LinkStatsOptions {
+  std::chrono::milliseconds sample_interval{1000};
+  // 每個介面保留的樣本數
+  size_t history_size = 300;
+};
+
+// 相鄰兩次取樣之間的速率與錯誤增量
+struct LinkRate {
+  std::chrono::system_clock::time_point time;
+  double rx_bps = 0;
+  double tx_bps = 0;
+  double rx_pps = 0;
+  double tx_pps = 0;
+  uint64_t rx_dropped = 0;
+  uint64_t tx_dropped = 0;
+  uint64_t rx_errors = 0;
+  uint64_t tx_errors = 0;
+};
+
+struct LinkStatsSnapshot {
+  std::string interface_name;
+  bool link_up = false;
+  // 無法取得（例如虛擬介面或 link down）時為 -1 與空字串
+  int speed_mbps = -1;
+  std::string duplex;
+  iptool::netlink::LinkCounters counters;
+  // 由舊到新，最後一筆為目前速率
+  std::vector<LinkRate> history;
+};
+
+/**
+ * 於背景以固定間隔透過 netlink 讀取所有介面的流量計數，並從 sysfs 讀取
+ * 速度與雙工模式，不啟動任何子行程。每個介面以環狀緩衝區保留最近的
+ * 樣本，查詢時換算成速率。
+ */
+class LinkStatsSampler {
+ public:
+  explicit LinkStatsSampler(LinkStatsOptions options = {});
+  ~LinkStatsSampler() = default;
+  LinkStatsSampler(const LinkStatsSampler&) = delete;
+  LinkStatsSampler& operator=(const LinkStatsSampler&) = delete;
+
+  void Start();
+
+  const LinkStatsOptions& options() const { return options_; }
+
+  // interface_name 為空時回傳所有非 loopback 介面；history_limit 為 0 時
+  // 回傳全部保留的歷史
+  std::vector<LinkStatsSnapshot> Get(
+      const std::string& interface_name, size_t history_limit) const;
+
+ private:
+  struct Sample {
+    std::chrono::system_clock::time_point time;
+    std::chrono::steady_clock::time_point steady;
+    iptool::netlink::LinkCounters counters;
+  };
+
+  struct Series {
+    bool link_up = false;
+    int speed_mbps = -1;
+    std::string duplex;
+    // 固定大小的環狀緩衝區，next 指向下一個寫入位置
+    std::vector<Sample> samples;
+    size_t next = 0;
+    size_t count = 0;
+    uint64_t generation = 0;
+  };
+
+  void Run(std::stop_token stop);
+  void SampleOnce();
+  LinkStatsSnapshot Snapshot(
+      const std::string& name, const Series& series, size_t limit) const;
+
+  LinkStatsOptions options_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Series> series_;
+  uint64_t generation_ = 0;
+  std::jthread thread_;
+};
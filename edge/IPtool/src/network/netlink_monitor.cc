@@ -0,0 +1,185 @@
+#include "network/netlink_monitor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "util/logging.hpp"
+
+namespace iptool::netlink {
+
+namespace {
+
+// 收到第一個事件後再等待這段時間收集後續事件（固定視窗，不因持續的
+// 事件而延後）
+constexpr std::chrono::milliseconds kCoalesceWindow{100};
+constexpr size_t kReceiveBufferSize = 16 * 1024;
+
+int RouteOutputInterface(const nlmsghdr* msg) {
+  const auto* route = static_cast<const rtmsg*>(NLMSG_DATA(msg));
+  auto length = RTM_PAYLOAD(msg);
+  for (auto* attr = RTM_RTA(route); RTA_OK(attr, length);
+       attr = RTA_NEXT(attr, length)) {
+    if (attr->rta_type == RTA_OIF) {
+      uint32_t oif = 0;
+      std::memcpy(&oif, RTA_DATA(attr), sizeof(oif));
+      return static_cast<int>(oif);
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+NetlinkMonitor::NetlinkMonitor(Callback callback)
+    : callback_(std::move(callback)) {}
+
+NetlinkMonitor::~NetlinkMonitor() {
+  if (thread_.joinable()) {
+    thread_.request_stop();
+    const uint64_t one = 1;
+    [[maybe_unused]] auto _ = ::write(wake_fd_, &one, sizeof(one));
+    thread_.join();
+  }
+  if (socket_fd_ >= 0) {
+    ::close(socket_fd_);
+  }
+  if (wake_fd_ >= 0) {
+    ::close(wake_fd_);
+  }
+}
+
+bool NetlinkMonitor::Start() {
+  socket_fd_ = ::socket(
+      AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+  if (socket_fd_ < 0) {
+    LogErrorFormat("無法建立 netlink 監聽 socket: {}", std::strerror(errno));
+    return false;
+  }
+  sockaddr_nl local{};
+  local.nl_family = AF_NETLINK;
+  local.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV4_ROUTE;
+  if (::bind(socket_fd_, reinterpret_cast<sockaddr*>(&local), sizeof(local)) !=
+      0) {
+    LogErrorFormat("無法訂閱 netlink 事件: {}", std::strerror(errno));
+    return false;
+  }
+  wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wake_fd_ < 0) {
+    LogErrorFormat("無法建立 eventfd: {}", std::strerror(errno));
+    return false;
+  }
+  thread_ = std::jthread([this](std::stop_token stop) { Run(stop); });
+  return true;
+}
+
+bool NetlinkMonitor::Drain(std::vector<int>* indexes, bool* full_resync) {
+  alignas(nlmsghdr) std::array<char, kReceiveBufferSize> buffer;
+  while (true) {
+    const ssize_t received =
+        ::recv(socket_fd_, buffer.data(), buffer.size(), 0);
+    if (received < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return true;
+      }
+      if (errno == ENOBUFS) {
+        // kernel 已丟棄部分事件，無法得知受影響的介面
+        LogWarn("netlink 事件緩衝區溢位，重新讀取所有介面");
+        *full_resync = true;
+        continue;
+      }
+      LogErrorFormat("netlink 事件讀取失敗: {}", std::strerror(errno));
+      return false;
+    }
+    auto remaining = static_cast<unsigned int>(received);
+    for (auto* msg = reinterpret_cast<nlmsghdr*>(buffer.data());
+         NLMSG_OK(msg, remaining);
+         msg = NLMSG_NEXT(msg, remaining)) {
+      int index = 0;
+      switch (msg->nlmsg_type) {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+          index = static_cast<const ifinfomsg*>(NLMSG_DATA(msg))->ifi_index;
+          break;
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+          index = static_cast<int>(
+              static_cast<const ifaddrmsg*>(NLMSG_DATA(msg))->ifa_index);
+          break;
+        case RTM_NEWROUTE:
+        case RTM_DELROUTE:
+          index = RouteOutputInterface(msg);
+          if (index == 0) {
+            *full_resync = true;
+          }
+          break;
+        default:
+          break;
+      }
+      if (index > 0 && std::ranges::find(*indexes, index) == indexes->end()) {
+        indexes->push_back(index);
+      }
+    }
+  }
+}
+
+void NetlinkMonitor::Run(std::stop_token stop) {
+  using Clock = std::chrono::steady_clock;
+  std::array<pollfd, 2> fds{
+      pollfd{socket_fd_, POLLIN, 0}, pollfd{wake_fd_, POLLIN, 0}};
+  std::vector<int> indexes;
+  bool full_resync = false;
+  bool pending = false;
+  Clock::time_point deadline;
+
+  while (!stop.stop_requested()) {
+    int timeout_ms = -1;
+    if (pending) {
+      const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - Clock::now());
+      timeout_ms = static_cast<int>(std::max<int64_t>(left.count(), 0));
+    }
+    const int ready = ::poll(fds.data(), fds.size(), timeout_ms);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LogErrorFormat("netlink poll 失敗: {}", std::strerror(errno));
+      return;
+    }
+    if (fds[1].revents != 0) {
+      return;
+    }
+    if (ready > 0) {
+      if (!Drain(&indexes, &full_resync)) {
+        return;
+      }
+      if (!pending && (full_resync || !indexes.empty())) {
+        pending = true;
+        deadline = Clock::now() + kCoalesceWindow;
+      }
+    }
+    if (pending && Clock::now() >= deadline) {
+      // 視窗結束，一次回呼所有受影響的介面
+      callback_(indexes, full_resync);
+      indexes.clear();
+      full_resync = false;
+      pending = false;
+    }
+  }
+}
+
+} // namespace iptool::netlink
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace iptool::netlink {
+
+/**
+ * 訂閱 rtnetlink multicast（RTNLGRP_LINK、RTNLGRP_IPV4_IFADDR、
+ * RTNLGRP_IPV4_ROUTE），於背景執行緒收集事件。短時間內的連續事件會
+ * 合併成一次回呼，避免 DHCP 續約或 connection up 時重複重新整理。
+ */
+class NetlinkMonitor {
+ public:
+  // indexes 為受影響的介面 index；full_resync 為 true 時代表事件遺失或
+  // 無法判斷介面（例如 socket 緩衝區溢位），應重新讀取所有介面
+  using Callback =
+      std::function<void(const std::vector<int>& indexes, bool full_resync)>;
+
+  explicit NetlinkMonitor(Callback callback);
+  ~NetlinkMonitor();
+  NetlinkMonitor(const NetlinkMonitor&) = delete;
+  NetlinkMonitor& operator=(const NetlinkMonitor&) = delete;
+
+  // 建立 socket 並啟動背景執行緒；失敗時回傳 false
+  bool Start();
+
+ private:
+  void Run(std::stop_token stop);
+  // 讀出目前所有待處理的訊息，回傳 false 表示 socket 發生錯誤
+  bool Drain(std::vector<int>* indexes, bool* full_resync);
+
+  Callback callback_;
+  int socket_fd_ = -1;
+  int wake_fd_ = -1;
+  std::jthread thread_;
+};
+
+} // namespace iptool::netlink
@@ -0,0 +1,429 @@
+#include "network/netlink_reader.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/if_link.h>
+#include <linux/neighbour.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "util/logging.hpp"
+
+namespace iptool::netlink {
+
+namespace {
+
+// 接收緩衝區的初始大小；較大的回覆會依實際長度擴大
+constexpr size_t kReceiveBufferSize = 16 * 1024;
+
+class NetlinkSocket {
+ public:
+  NetlinkSocket()
+      : fd_(::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)) {
+    if (fd_ < 0) {
+      return;
+    }
+    // 限制單次等待時間，避免核心未回覆時卡住 gRPC 執行緒
+    timeval timeout{1, 0};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_nl local{};
+    local.nl_family = AF_NETLINK;
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+  ~NetlinkSocket() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+  NetlinkSocket(const NetlinkSocket&) = delete;
+  NetlinkSocket& operator=(const NetlinkSocket&) = delete;
+
+  bool valid() const { return fd_ >= 0; }
+
+  // 送出請求並逐一處理回覆的 nlmsghdr，直到 NLMSG_DONE 或非 dump 回覆結束
+  template <typename Payload, typename Handler>
+  bool Request(
+      uint16_t type, uint16_t flags, const Payload& payload, Handler&& on_msg) {
+    struct {
+      nlmsghdr header;
+      Payload payload;
+    } request{};
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(Payload));
+    request.header.nlmsg_type = type;
+    request.header.nlmsg_flags = static_cast<uint16_t>(NLM_F_REQUEST | flags);
+    request.header.nlmsg_seq = ++seq_;
+    request.payload = payload;
+
+    sockaddr_nl kernel{};
+    kernel.nl_family = AF_NETLINK;
+    if (::sendto(
+            fd_,
+            &request,
+            request.header.nlmsg_len,
+            0,
+            reinterpret_cast<sockaddr*>(&kernel),
+            sizeof(kernel)) < 0) {
+      LogWarnFormat("netlink sendto 失敗: {}", std::strerror(errno));
+      return false;
+    }
+
+    const bool dump = (flags & NLM_F_DUMP) == NLM_F_DUMP;
+    while (true) {
+      const ssize_t received = Receive();
+      if (received < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        LogWarnFormat("netlink recv 失敗: {}", std::strerror(errno));
+        return false;
+      }
+      auto remaining = static_cast<unsigned int>(received);
+      for (auto* msg = reinterpret_cast<nlmsghdr*>(buffer_.data());
+           NLMSG_OK(msg, remaining);
+           msg = NLMSG_NEXT(msg, remaining)) {
+        if (msg->nlmsg_seq != seq_) {
+          continue;
+        }
+        if (msg->nlmsg_type == NLMSG_DONE) {
+          return true;
+        }
+        if (msg->nlmsg_type == NLMSG_ERROR) {
+          const auto* error = static_cast<const nlmsgerr*>(NLMSG_DATA(msg));
+          if (error->error == 0) {
+            return true;
+          }
+          errno = -error->error;
+          return false;
+        }
+        on_msg(msg);
+        if (!dump) {
+          return true;
+        }
+      }
+    }
+  }
+
+ private:
+  // 先以 MSG_PEEK|MSG_TRUNC 取得下一個 datagram 的完整長度再接收；
+  // 直接讀入固定大小的緩衝區時，超過的部分會被核心丟棄
+  ssize_t Receive() {
+    const ssize_t length = ::recv(fd_, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+    if (length < 0) {
+      return length;
+    }
+    if (static_cast<size_t>(length) > buffer_.size()) {
+      buffer_.resize(static_cast<size_t>(length));
+    }
+    return ::recv(fd_, buffer_.data(), buffer_.size(), 0);
+  }
+
+  int fd_ = -1;
+  uint32_t seq_ = 0;
+  // operator new 的對齊滿足 nlmsghdr
+  std::vector<char> buffer_ = std::vector<char>(kReceiveBufferSize);
+};
+
+std::string FormatIpv4(const void* data) {
+  std::array<char, INET_ADDRSTRLEN> text{};
+  if (!::inet_ntop(AF_INET, data, text.data(), text.size())) {
+    return {};
+  }
+  return text.data();
+}
+
+// 讀取小型文字檔到固定大小緩衝區，回傳實際長度
+size_t ReadSmallFile(const char* path, char* buffer, size_t capacity) {
+  const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return 0;
+  }
+  size_t used = 0;
+  while (used < capacity) {
+    const ssize_t n = ::read(fd, buffer + used, capacity - used);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    used += static_cast<size_t>(n);
+  }
+  ::close(fd);
+  return used;
+}
+
+std::vector<std::string> ParseNameservers(std::string_view content) {
+  constexpr std::string_view kKeyword = "nameserver";
+  std::vector<std::string> servers;
+  while (!content.empty()) {
+    const auto newline = content.find('\n');
+    auto line = content.substr(0, newline);
+    content = newline == std::string_view::npos ? std::string_view{}
+                                                : content.substr(newline + 1);
+    if (!line.starts_with(kKeyword)) {
+      continue;
+    }
+    line.remove_prefix(kKeyword.size());
+    const auto begin = line.find_first_not_of(" \t");
+    if (begin == std::string_view::npos || begin == 0) {
+      continue;
+    }
+    line.remove_prefix(begin);
+    const auto end = line.find_first_of(" \t\r#");
+    servers.emplace_back(line.substr(0, end));
+  }
+  return servers;
+}
+
+} // namespace
+
+std::optional<InterfaceState> ReadInterfaceState(
+    std::string_view interface_name) {
+  std::array<char, IF_NAMESIZE> name{};
+  if (interface_name.empty() || interface_name.size() >= name.size()) {
+    return std::nullopt;
+  }
+  std::memcpy(name.data(), interface_name.data(), interface_name.size());
+  const unsigned int index = ::if_nametoindex(name.data());
+  if (index == 0) {
+    return std::nullopt;
+  }
+
+  NetlinkSocket socket;
+  if (!socket.valid()) {
+    LogWarnFormat("無法建立 netlink socket: {}", std::strerror(errno));
+    return std::nullopt;
+  }
+
+  InterfaceState state;
+  state.index = static_cast<int>(index);
+
+  ifinfomsg link_request{};
+  link_request.ifi_family = AF_UNSPEC;
+  link_request.ifi_index = state.index;
+  const bool link_ok =
+      socket.Request(RTM_GETLINK, 0, link_request, [&](const nlmsghdr* msg) {
+        if (msg->nlmsg_type != RTM_NEWLINK) {
+          return;
+        }
+        const auto* info = static_cast<const ifinfomsg*>(NLMSG_DATA(msg));
+        state.link_up = (info->ifi_flags & IFF_UP) != 0 &&
+            (info->ifi_flags & IFF_RUNNING) != 0;
+      });
+  if (!link_ok) {
+    return std::nullopt;
+  }
+
+  ifaddrmsg addr_request{};
+  addr_request.ifa_family = AF_INET;
+  const bool addr_ok = socket.Request(
+      RTM_GETADDR, NLM_F_DUMP, addr_request, [&](const nlmsghdr* msg) {
+        if (msg->nlmsg_type != RTM_NEWADDR || !state.ip_address.empty()) {
+          return;
+        }
+        const auto* addr = static_cast<const ifaddrmsg*>(NLMSG_DATA(msg));
+        if (addr->ifa_index != index || addr->ifa_family != AF_INET ||
+            (addr->ifa_flags & IFA_F_SECONDARY) != 0) {
+          return;
+        }
+        const void* local = nullptr;
+        const void* address = nullptr;
+        auto length = IFA_PAYLOAD(msg);
+        for (auto* attr = IFA_RTA(addr); RTA_OK(attr, length);
+             attr = RTA_NEXT(attr, length)) {
+          if (attr->rta_type == IFA_LOCAL) {
+            local = RTA_DATA(attr);
+          } else if (attr->rta_type == IFA_ADDRESS) {
+            address = RTA_DATA(attr);
+          }
+        }
+        // point-to-point 介面的 IFA_ADDRESS 為對端位址，優先使用 IFA_LOCAL
+        const void* chosen = local ? local : address;
+        if (chosen) {
+          state.ip_address = FormatIpv4(chosen);
+          state.prefix_length = addr->ifa_prefixlen;
+        }
+      });
+  if (!addr_ok) {
+    return std::nullopt;
+  }
+
+  rtmsg route_request{};
+  route_request.rtm_family = AF_INET;
+  uint32_t best_metric = std::numeric_limits<uint32_t>::max();
+  const bool route_ok = socket.Request(
+      RTM_GETROUTE, NLM_F_DUMP, route_request, [&](const nlmsghdr* msg) {
+        if (msg->nlmsg_type != RTM_NEWROUTE) {
+          return;
+        }
+        const auto* route = static_cast<const rtmsg*>(NLMSG_DATA(msg));
+        if (route->rtm_family != AF_INET || route->rtm_dst_len != 0 ||
+            route->rtm_type != RTN_UNICAST) {
+          return;
+        }
+        uint32_t table = route->rtm_table;
+        uint32_t oif = 0;
+        uint32_t metric = 0;
+        const void* gateway = nullptr;
+        auto length = RTM_PAYLOAD(msg);
+        for (auto* attr = RTM_RTA(route); RTA_OK(attr, length);
+             attr = RTA_NEXT(attr, length)) {
+          switch (attr->rta_type) {
+            case RTA_TABLE:
+              std::memcpy(&table, RTA_DATA(attr), sizeof(table));
+              break;
+            case RTA_OIF:
+              std::memcpy(&oif, RTA_DATA(attr), sizeof(oif));
+              break;
+            case RTA_PRIORITY:
+              std::memcpy(&metric, RTA_DATA(attr), sizeof(metric));
+              break;
+            case RTA_GATEWAY:
+              gateway = RTA_DATA(attr);
+              break;
+            default:
+              break;
+          }
+        }
+        if (table != RT_TABLE_MAIN || oif != index || !gateway ||
+            metric >= best_metric) {
+          return;
+        }
+        best_metric = metric;
+        state.gateway = FormatIpv4(gateway);
+      });
+  if (!route_ok) {
+    return std::nullopt;
+  }
+
+  return state;
+}
+
+std::vector<InterfaceCounters> ReadInterfaceCounters() {
+  std::vector<InterfaceCounters> interfaces;
+  NetlinkSocket socket;
+  if (!socket.valid()) {
+    LogWarnFormat("無法建立 netlink socket: {}", std::strerror(errno));
+    return interfaces;
+  }
+
+  ifinfomsg request{};
+  request.ifi_family = AF_UNSPEC;
+  const bool ok = socket.Request(
+      RTM_GETLINK, NLM_F_DUMP, request, [&](const nlmsghdr* msg) {
+        if (msg->nlmsg_type != RTM_NEWLINK) {
+          return;
+        }
+        const auto* info = static_cast<const ifinfomsg*>(NLMSG_DATA(msg));
+        InterfaceCounters entry;
+        entry.index = info->ifi_index;
+        entry.loopback = (info->ifi_flags & IFF_LOOPBACK) != 0;
+        entry.link_up = (info->ifi_flags & IFF_UP) != 0 &&
+            (info->ifi_flags & IFF_RUNNING) != 0;
+        auto length = IFLA_PAYLOAD(msg);
+        for (auto* attr = IFLA_RTA(info); RTA_OK(attr, length);
+             attr = RTA_NEXT(attr, length)) {
+          if (attr->rta_type == IFLA_IFNAME) {
+            entry.name = static_cast<const char*>(RTA_DATA(attr));
+          } else if (
+              attr->rta_type == IFLA_STATS64 &&
+              RTA_PAYLOAD(attr) >= sizeof(rtnl_link_stats64)) {
+            rtnl_link_stats64 stats{};
+            std::memcpy(&stats, RTA_DATA(attr), sizeof(stats));
+            entry.counters.rx_bytes = stats.rx_bytes;
+            entry.counters.tx_bytes = stats.tx_bytes;
+            entry.counters.rx_packets = stats.rx_packets;
+            entry.counters.tx_packets = stats.tx_packets;
+            entry.counters.rx_dropped = stats.rx_dropped;
+            entry.counters.tx_dropped = stats.tx_dropped;
+            entry.counters.rx_errors = stats.rx_errors;
+            entry.counters.tx_errors = stats.tx_errors;
+          }
+        }
+        if (!entry.name.empty()) {
+          interfaces.push_back(std::move(entry));
+        }
+      });
+  if (!ok) {
+    interfaces.clear();
+  }
+  return interfaces;
+}
+
+bool IsNeighbourConfirmed(std::string_view ipv4_address) {
+  std::array<char, INET_ADDRSTRLEN> text{};
+  in_addr target{};
+  if (ipv4_address.size() >= text.size()) {
+    return false;
+  }
+  std::memcpy(text.data(), ipv4_address.data(), ipv4_address.size());
+  if (::inet_pton(AF_INET, text.data(), &target) != 1) {
+    return false;
+  }
+
+  NetlinkSocket socket;
+  if (!socket.valid()) {
+    LogWarnFormat("無法建立 netlink socket: {}", std::strerror(errno));
+    return false;
+  }
+
+  constexpr uint16_t kConfirmed = NUD_REACHABLE | NUD_PERMANENT | NUD_NOARP;
+  bool confirmed = false;
+  ndmsg request{};
+  request.ndm_family = AF_INET;
+  socket.Request(RTM_GETNEIGH, NLM_F_DUMP, request, [&](const nlmsghdr* msg) {
+    if (msg->nlmsg_type != RTM_NEWNEIGH || confirmed) {
+      return;
+    }
+    const auto* neighbour = static_cast<const ndmsg*>(NLMSG_DATA(msg));
+    if (neighbour->ndm_family != AF_INET ||
+        (neighbour->ndm_state & kConfirmed) == 0) {
+      return;
+    }
+    // linux/neighbour.h 沒有提供 NDA_RTA/NDA_PAYLOAD 的 userspace 巨集
+    auto length = NLMSG_PAYLOAD(msg, sizeof(ndmsg));
+    for (auto* attr = reinterpret_cast<const rtattr*>(
+             reinterpret_cast<const char*>(neighbour) +
+             NLMSG_ALIGN(sizeof(ndmsg)));
+         RTA_OK(attr, length);
+         attr = RTA_NEXT(attr, length)) {
+      if (attr->rta_type == NDA_DST &&
+          RTA_PAYLOAD(attr) == sizeof(target) &&
+          std::memcmp(RTA_DATA(attr), &target, sizeof(target)) == 0) {
+        confirmed = true;
+        return;
+      }
+    }
+  });
+  return confirmed;
+}
+
+std::vector<std::string> ReadResolverNameservers() {
+  std::array<char, 4096> buffer;
+  size_t length =
+      ReadSmallFile("/etc/resolv.conf", buffer.data(), buffer.size());
+  auto servers = ParseNameservers(std::string_view(buffer.data(), length));
+  if (servers.size() == 1 && servers.front() == "127.0.0.53") {
+    length = ReadSmallFile(
+        "/run/systemd/resolve/resolv.conf", buffer.data(), buffer.size());
+    auto upstream = ParseNameservers(std::string_view(buffer.data(), length));
+    if (!upstream.empty()) {
+      servers = std::move(upstream);
+    }
+  }
+  return servers;
+}
+
+} // namespace iptool::netlink
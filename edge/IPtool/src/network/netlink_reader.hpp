@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace iptool::netlink {
+
+// 透過 rtnetlink 讀到的介面即時狀態（IPv4）
+struct InterfaceState {
+  int index = 0;
+  // 介面已啟用 (IFF_UP) 且有 carrier (IFF_RUNNING)
+  bool link_up = false;
+  std::string ip_address;
+  int prefix_length = -1;
+  // 經由此介面的預設路由 gateway，沒有時為空字串
+  std::string gateway;
+};
+
+// 介面累計流量計數（IFLA_STATS64）
+struct LinkCounters {
+  uint64_t rx_bytes = 0;
+  uint64_t tx_bytes = 0;
+  uint64_t rx_packets = 0;
+  uint64_t tx_packets = 0;
+  uint64_t rx_dropped = 0;
+  uint64_t tx_dropped = 0;
+  uint64_t rx_errors = 0;
+  uint64_t tx_errors = 0;
+};
+
+struct InterfaceCounters {
+  int index = 0;
+  std::string name;
+  bool loopback = false;
+  bool link_up = false;
+  LinkCounters counters;
+};
+
+/**
+ * 以 AF_NETLINK/NETLINK_ROUTE 查詢介面狀態（RTM_GETLINK、RTM_GETADDR、
+ * RTM_GETROUTE），不需啟動任何子行程。介面不存在或 netlink 失敗時回傳
+ * std::nullopt。
+ */
+std::optional<InterfaceState> ReadInterfaceState(
+    std::string_view interface_name);
+
+// 以一次 RTM_GETLINK dump 讀取所有介面的流量計數；失敗時回傳空陣列
+std::vector<InterfaceCounters> ReadInterfaceCounters();
+
+/**
+ * 以 RTM_GETNEIGH 查詢 IPv4 位址的 neighbour（ARP）項目是否已確認：
+ * REACHABLE 代表近期收到 ARP 回覆或上層協定的確認，PERMANENT 與 NOARP
+ * 亦視為已確認。STALE、DELAY 等仍在等待確認的狀態回傳 false。
+ */
+bool IsNeighbourConfirmed(std::string_view ipv4_address);
+
+/**
+ * 讀取系統 resolver 目前使用的 DNS 伺服器。若 /etc/resolv.conf 指向
+ * systemd-resolved 的 stub，改讀 /run/systemd/resolve/resolv.conf。
+ */
+std::vector<std::string> ReadResolverNameservers();
+
+} // namespace iptool::netlink
@@ -1,257 +1,104 @@
 #include "network_service.hpp"
 
-#include <algorithm>
-#include <array>
-#include <cerrno>
-#include <cstdio>
-#include <fstream>
+#include <chrono>
+#include <initializer_list>
+#include <mutex>
 #include <optional>
-#include <ranges>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
-#include <sys/wait.h>
-#include <unistd.h>
-
+#include "network/netlink_reader.hpp"
+#include "network/nmcli_parser.hpp"
+#include "process/subprocess.hpp"
 #include "util/logging.hpp"
 
 namespace {
 
-// 使用 shell quote 逃脫使用者輸入，避免命令注入
-std::string ShellEscape(const std::string& value) {
-  std::string escaped = "'";
-  for (const char ch : value) {
-    if (ch == '\'') {
-      escaped += "'\\''";
-    } else {
-      escaped += ch;
+using iptool::nmcli::MaskToPrefix;
+using iptool::nmcli::ParseConfigOutput;
+using iptool::nmcli::PrefixToMask;
+using iptool::process::ProcessOptions;
+using iptool::process::ProcessResult;
+
+// 查詢類指令與套用設定類指令的逾時
+constexpr std::chrono::seconds kQueryTimeout{5};
+constexpr std::chrono::seconds kModifyTimeout{10};
+constexpr std::chrono::seconds kConnectionUpTimeout{60};
+
+// 以程式名稱加上前兩個子命令作為延遲統計的標籤（例如
+// "nmcli connection up"），選項、-f 的欄位清單與連線名稱不列入
+void BuildCommandLabel(
+    std::initializer_list<std::string_view> argv, std::string* label) {
+  label->clear();
+  int words = 0;
+  bool skip_next = false;
+  for (const auto arg : argv) {
+    if (skip_next) {
+      skip_next = false;
+      continue;
     }
-  }
-  escaped += "'";
-  return escaped;
-}
-
-struct CommandResult {
-  int status = -1;
-  std::string output;
-};
-
-// 封裝 std::system 呼叫並將輸出導入暫存檔案，之後再讀出內容
-std::optional<CommandResult> RunCommandWithCapture(const std::string& command) {
-  char tmp_template[] = "/tmp/iptoolXXXXXX";
-  int fd = mkstemp(tmp_template);
-  if (fd == -1) {
-    LogErrorFormat("建立暫存檔失敗: {}", std::strerror(errno));
-    return std::nullopt;
-  }
-  close(fd);
-
-  std::string temp_path = tmp_template;
-  std::string full_command = command + " > " + ShellEscape(temp_path) + " 2>&1";
-  LogDebugFormat("執行命令: {}", full_command);
-  int status = std::system(full_command.c_str());
-
-  std::ifstream file(temp_path);
-  std::stringstream buffer;
-  buffer << file.rdbuf();
-  std::string output = buffer.str();
-  file.close();
-  std::remove(temp_path.c_str());
-
-  return CommandResult{status, std::move(output)};
-}
-
-std::string Trim(std::string value) {
-  auto not_space = [](const unsigned char ch) { return !std::isspace(ch); };
-  value.erase(value.begin(), std::ranges::find_if(value, not_space));
-  value.erase(
-      std::find_if(value.rbegin(), value.rend(), not_space).base(),
-      value.end());
-  return value;
-}
-
-bool CommandSucceeded(int status) {
-  if (status == -1) {
-    return false;
-  }
-  if (WIFEXITED(status)) {
-    return WEXITSTATUS(status) == 0;
-  }
-  return false;
-}
-
-// 前綴轉換成子網路遮罩
-std::optional<std::string> PrefixToMask(const int prefix_length) {
-  if (prefix_length < 0 || prefix_length > 32) {
-    return std::nullopt;
-  }
-  uint32_t mask = prefix_length == 0 ? 0U : 0xFFFFFFFFu << (32 - prefix_length);
-  std::array<int, 4> octets{};
-  for (int i = 0; i < 4; ++i) {
-    octets[i] = static_cast<int>((mask >> (24 - i * 8)) & 0xFF);
-  }
-  std::ostringstream stream;
-  stream << octets[0] << '.' << octets[1] << '.' << octets[2] << '.'
-         << octets[3];
-  return stream.str();
-}
-
-// 子網路遮罩轉換成前綴長度
-std::optional<int> MaskToPrefix(const std::string& mask) {
-  std::array<int, 4> octets{};
-  char dot1 = 0;
-  char dot2 = 0;
-  char dot3 = 0;
-  std::istringstream stream(mask);
-  if (!(stream >> octets[0] >> dot1 >> octets[1] >> dot2 >> octets[2] >> dot3 >>
-        octets[3])) {
-    return std::nullopt;
-  }
-  if (dot1 != '.' || dot2 != '.' || dot3 != '.') {
-    return std::nullopt;
-  }
-
-  uint32_t value = 0;
-  for (int octet : octets) {
-    if (octet < 0 || octet > 255) {
-      return std::nullopt;
+    if (arg.starts_with('-')) {
+      skip_next = arg == "-f";
+      continue;
     }
-    value = (value << 8) | static_cast<unsigned>(octet);
-  }
-
-  bool zero_encountered = false;
-  int prefix = 0;
-  for (int bit = 31; bit >= 0; --bit) {
-    bool is_one = (value >> bit) & 1U;
-    if (is_one) {
-      if (zero_encountered) {
-        return std::nullopt;
-      }
-      ++prefix;
-    } else {
-      zero_encountered = true;
+    if (words > 0) {
+      *label += ' ';
     }
-  }
-  return prefix;
-}
-
-// 將 nmcli `ipv4.addresses` 解析成 IP 和遮罩
-void ParseAddressWithPrefix(
-    const std::string& value, std::string* ip, std::string* mask) {
-  if (value.empty()) {
-    return;
-  }
-  auto addresses = value;
-  auto delimiter = addresses.find(';');
-  if (delimiter != std::string::npos) {
-    addresses = addresses.substr(0, delimiter);
-  }
-  auto slash = addresses.find('/');
-  if (slash == std::string::npos) {
-    *ip = addresses;
-    return;
-  }
-  *ip = addresses.substr(0, slash);
-  auto prefix_str = addresses.substr(slash + 1);
-  try {
-    int prefix_length = std::stoi(prefix_str);
-    if (auto mask_opt = PrefixToMask(prefix_length)) {
-      *mask = *mask_opt;
+    *label += arg;
+    if (++words == 3) {
+      break;
     }
-  } catch (...) {
-    LogWarn("解析前綴長度時發生例外");
   }
 }
 
-// 從 nmcli 輸出解析出 NetworkConfigData
-std::optional<NetworkConfigData> ParseConfigOutput(
-    const std::string& interface_name, const std::string& output) {
-  NetworkConfigData data;
-  data.interface_name = interface_name;
-
-  std::istringstream stream(output);
-  std::string line;
-  while (std::getline(stream, line)) {
-    auto separator = line.find(':');
-    if (separator == std::string::npos) {
-      continue;
-    }
-    auto key = line.substr(0, separator);
-    auto value = line.substr(separator + 1);
-    if (key == "ipv4.method") {
-      if (value == "auto") {
-        data.mode = iptool::NETWORK_MODE_DHCP;
-      } else if (value == "manual") {
-        data.mode = iptool::NETWORK_MODE_MANUAL;
-      } else {
-        data.mode = iptool::NETWORK_MODE_UNSPECIFIED;
-      }
-    } else if (key == "ipv4.addresses") {
-      ParseAddressWithPrefix(value, &data.ip_address, &data.subnet_mask);
-    } else if (key == "ipv4.gateway") {
-      data.gateway = value;
-    } else if (key == "ipv4.dns") {
-      auto dns_value = value;
-      auto delimiter = dns_value.find(';');
-      if (delimiter != std::string::npos) {
-        dns_value = dns_value.substr(0, delimiter);
-      }
-      data.dns = dns_value;
+// 直接以參數陣列執行指令（不經過 shell），回傳的結果為執行緒私有緩衝區，
+// 在同一執行緒下一次呼叫前有效。執行緒上有 ScopedCancellation 時，
+// RPC 取消會一併終止子行程
+const ProcessResult* RunCommand(
+    std::initializer_list<std::string_view> argv,
+    std::chrono::milliseconds timeout = kQueryTimeout) {
+  thread_local ProcessResult result;
+  thread_local std::string label;
+  if constexpr (kDebugLogsEnabled) {
+    std::string joined;
+    for (const auto arg : argv) {
+      joined += arg;
+      joined += ' ';
     }
+    LogDebugFormat("執行命令: {}", joined);
   }
-
-  if (data.mode == iptool::NETWORK_MODE_UNSPECIFIED) {
-    LogWarn("未能解析網路模式");
+  BuildCommandLabel(argv, &label);
+  ProcessOptions options;
+  options.timeout = timeout;
+  options.label = label;
+  if (!iptool::process::RunProcess(argv, options, &result)) {
+    LogErrorFormat("無法執行 {}: {}", *argv.begin(), result.stderr_data);
+    return nullptr;
   }
-
-  return data;
+  return &result;
 }
 
 bool FetchDhcpRuntimeConfig(
     const std::string& interface_name, NetworkConfigData* data) {
-  const std::string command =
-      "nmcli -t -f IP4.ADDRESS,IP4.GATEWAY,IP4.DNS device show " +
-      ShellEscape(interface_name);
-  auto result = RunCommandWithCapture(command);
+  const auto* result = RunCommand(
+      {"nmcli",
+       "-t",
+       "-f",
+       "IP4.ADDRESS,IP4.GATEWAY,IP4.DNS",
+       "device",
+       "show",
+       interface_name});
   if (!result) {
     LogWarn("查詢 DHCP 配置時無法執行 nmcli");
     return false;
   }
-  if (!CommandSucceeded(result->status)) {
-    LogWarnFormat("nmcli 查詢 DHCP 配置失敗: {}", result->output);
+  if (!result->Succeeded()) {
+    LogWarnFormat("nmcli 查詢 DHCP 配置失敗: {}", result->ErrorOutput());
     return false;
   }
 
-  std::istringstream stream(result->output);
-  std::string line;
-  while (std::getline(stream, line)) {
-    if (line.empty()) {
-      continue;
-    }
-    auto separator = line.find(':');
-    if (separator == std::string::npos) {
-      continue;
-    }
-    auto key = Trim(line.substr(0, separator));
-    auto value = Trim(line.substr(separator + 1));
-
-    if (key.rfind("IP4.ADDRESS", 0) == 0) {
-      ParseAddressWithPrefix(value, &data->ip_address, &data->subnet_mask);
-    } else if (key == "IP4.GATEWAY") {
-      data->gateway = value;
-    } else if (key.rfind("IP4.DNS", 0) == 0) {
-      auto delimiter = value.find(';');
-      if (delimiter != std::string::npos) {
-        value = value.substr(0, delimiter);
-      }
-      if (data->dns.empty()) {
-        data->dns = value;
-      } else {
-        data->dns += ';' + value;
-      }
-    }
-  }
-
+  iptool::nmcli::ParseDeviceShowOutput(result->stdout_data, data);
   if (data->ip_address.empty()) {
     LogWarnFormat("介面 {} 未取得 DHCP IP 位址", interface_name);
     return false;
@@ -259,75 +106,158 @@ bool FetchDhcpRuntimeConfig(
   return true;
 }
 
+// 介面 -> nmcli 連線名稱的快取；對應關係只在新增/刪除 profile 時改變，
+// nmcli 指令失敗時清除，下次查詢重新建立
+std::mutex g_connection_mutex;
+std::unordered_map<std::string, std::string> g_connection_names;
+
+void InvalidateConnectionName(const std::string& interface_name) {
+  std::lock_guard lock(g_connection_mutex);
+  g_connection_names.erase(interface_name);
+}
+
 // 透過裝置名稱查找對應的 nmcli 連線名稱 (NAME 欄位)
 std::optional<std::string> ResolveConnectionName(
     const std::string& interface_name) {
-  const std::string command = "nmcli -t -f NAME,DEVICE connection show";
-  auto result = RunCommandWithCapture(command);
+  {
+    std::lock_guard lock(g_connection_mutex);
+    if (auto it = g_connection_names.find(interface_name);
+        it != g_connection_names.end()) {
+      return it->second;
+    }
+  }
+
+  const auto* result =
+      RunCommand({"nmcli", "-t", "-f", "NAME,DEVICE", "connection", "show"});
   if (!result) {
     LogError("查詢連線列表時無法執行 nmcli");
     return std::nullopt;
   }
-  if (!CommandSucceeded(result->status)) {
-    LogErrorFormat("nmcli 查詢連線列表失敗: {}", result->output);
+  if (!result->Succeeded()) {
+    LogErrorFormat("nmcli 查詢連線列表失敗: {}", result->ErrorOutput());
     return std::nullopt;
   }
 
-  std::istringstream stream(result->output);
-  std::string line;
-  while (std::getline(stream, line)) {
-    if (line.empty()) {
-      continue;
-    }
-    auto separator = line.find(':');
-    if (separator == std::string::npos) {
-      continue;
-    }
-    auto name = Trim(line.substr(0, separator));
-    auto device = Trim(line.substr(separator + 1));
-    if (device == interface_name) {
-      return name;
-    }
+  std::string name;
+  if (iptool::nmcli::FindConnectionName(
+          result->stdout_data, interface_name, &name)) {
+    std::lock_guard lock(g_connection_mutex);
+    g_connection_names[interface_name] = name;
+    return name;
   }
 
   LogWarnFormat("找不到介面 {} 對應的 nmcli 連線名稱", interface_name);
   return std::nullopt;
 }
 
+// 將 netlink 讀到的即時狀態套用到設定；沒有 IPv4 位址時回傳 false
+bool ApplyKernelState(
+    const iptool::netlink::InterfaceState& state, NetworkConfigData* data) {
+  data->link_up = state.link_up;
+  if (state.ip_address.empty()) {
+    return false;
+  }
+  const auto mask = PrefixToMask(state.prefix_length);
+  if (!mask) {
+    return false;
+  }
+  data->ip_address = state.ip_address;
+  data->subnet_mask = *mask;
+  data->gateway = state.gateway;
+  if (data->dns.empty()) {
+    // DHCP 取得的 DNS 不在 profile 中，改讀 resolver 狀態
+    for (const auto& server : iptool::netlink::ReadResolverNameservers()) {
+      if (!data->dns.empty()) {
+        data->dns += ';';
+      }
+      data->dns += server;
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 std::optional<NetworkConfigData> NetworkService::GetNetworkConfig(
     const std::string& interface_name) {
+  // 位址、遮罩、gateway 與 link 狀態直接向 kernel 查詢
+  const auto kernel_state = iptool::netlink::ReadInterfaceState(interface_name);
+  if (!kernel_state) {
+    LogWarnFormat("無法透過 netlink 讀取介面 {}", interface_name);
+  }
+
   const auto connection_name = ResolveConnectionName(interface_name);
   if (!connection_name) {
     return std::nullopt;
   }
 
-  const std::string command =
-      "nmcli -t -f ipv4.method,ipv4.addresses,ipv4.gateway,ipv4.dns connection show " +
-      ShellEscape(*connection_name);
-  auto result = RunCommandWithCapture(command);
+  // ipv4.method 與手動 DNS 只有 NetworkManager 知道
+  const auto* result = RunCommand(
+      {"nmcli",
+       "-t",
+       "-f",
+       "ipv4.method,ipv4.dns",
+       "connection",
+       "show",
+       *connection_name});
   if (!result) {
     LogError("取得網路設定時無法執行 nmcli");
     return std::nullopt;
   }
-  if (!CommandSucceeded(result->status)) {
-    LogErrorFormat("nmcli 取得設定失敗: {}", result->output);
+  if (!result->Succeeded()) {
+    LogErrorFormat("nmcli 取得設定失敗: {}", result->ErrorOutput());
+    InvalidateConnectionName(interface_name);
     return std::nullopt;
   }
 
-  auto config = ParseConfigOutput(interface_name, result->output);
-  if (!config) {
-    LogError("無法解析 nmcli 輸出");
-    return std::nullopt;
+  std::optional<NetworkConfigData> config =
+      ParseConfigOutput(interface_name, result->stdout_data);
+  if (config->mode == iptool::NETWORK_MODE_UNSPECIFIED) {
+    LogWarn("未能解析網路模式");
+  }
+  if (kernel_state && ApplyKernelState(*kernel_state, &*config)) {
+    return config;
   }
+
+  // 介面目前沒有 IPv4 位址（例如連線尚未啟動），退回 nmcli 的設定值
   if (config->mode == iptool::NETWORK_MODE_DHCP) {
     FetchDhcpRuntimeConfig(interface_name, &*config);
+    return config;
+  }
+  const auto* profile = RunCommand(
+      {"nmcli",
+       "-t",
+       "-f",
+       "ipv4.method,ipv4.addresses,ipv4.gateway,ipv4.dns",
+       "connection",
+       "show",
+       *connection_name});
+  if (profile && profile->Succeeded()) {
+    auto stored = ParseConfigOutput(interface_name, profile->stdout_data);
+    stored.link_up = config->link_up;
+    return stored;
   }
   return config;
 }
 
-OperationResult NetworkService::SetManualConfig(
+bool NetworkService::RefreshKernelState(NetworkConfigData* config) {
+  const auto state =
+      iptool::netlink::ReadInterfaceState(config->interface_name);
+  if (!state) {
+    return false;
+  }
+  NetworkConfigData updated = *config;
+  if (updated.mode == iptool::NETWORK_MODE_DHCP) {
+    updated.dns.clear();
+  }
+  if (!ApplyKernelState(*state, &updated)) {
+    return false;
+  }
+  *config = std::move(updated);
+  return true;
+}
+
+OperationResult NetworkService::ValidateManualConfig(
     const NetworkConfigData& config) {
   OperationResult result;
 
@@ -347,13 +277,45 @@ OperationResult NetworkService::SetManualConfig(
     result.message = "請提供 DNS 伺服器";
     return result;
   }
-
-  auto prefix_opt = MaskToPrefix(config.subnet_mask);
-  if (!prefix_opt) {
+  if (!MaskToPrefix(config.subnet_mask)) {
     result.message = "子網路遮罩格式錯誤";
     return result;
   }
 
+  result.success = true;
+  return result;
+}
+
+bool NetworkService::MatchesManualConfig(
+    const NetworkConfigData& live, const NetworkConfigData& target) {
+  return live.mode == iptool::NETWORK_MODE_MANUAL && live.link_up &&
+      live.ip_address == target.ip_address &&
+      live.subnet_mask == target.subnet_mask &&
+      live.gateway == target.gateway && live.dns == target.dns;
+}
+
+bool NetworkService::HasDhcpLease(const NetworkConfigData& live) {
+  return live.mode == iptool::NETWORK_MODE_DHCP && live.link_up &&
+      !live.ip_address.empty();
+}
+
+OperationResult NetworkService::SetManualConfig(
+    const NetworkConfigData& config) {
+  OperationResult result = ValidateManualConfig(config);
+  if (!result.success) {
+    return result;
+  }
+  result.success = false;
+  const auto prefix_opt = MaskToPrefix(config.subnet_mask);
+
+  if (const auto live = GetNetworkConfig(config.interface_name);
+      live && MatchesManualConfig(*live, config)) {
+    result.success = true;
+    result.message = "設定與目前狀態相同，未重新套用";
+    LogInfoFormat("介面 {} 手動設定未變更，略過", config.interface_name);
+    return result;
+  }
+
   auto connection_name = ResolveConnectionName(config.interface_name);
   if (!connection_name) {
     result.message = "找不到對應的連線名稱";
@@ -362,33 +324,40 @@ OperationResult NetworkService::SetManualConfig(
 
   std::string address_with_prefix =
       config.ip_address + "/" + std::to_string(*prefix_opt);
-  std::string command = "nmcli connection modify " +
-      ShellEscape(*connection_name) + " ipv4.method manual";
-  command += " ipv4.addresses " + ShellEscape(address_with_prefix);
-  command += " ipv4.gateway " + ShellEscape(config.gateway);
-  command += " ipv4.dns " + ShellEscape(config.dns);
-
-  auto modify_result = RunCommandWithCapture(command);
+  const auto* modify_result = RunCommand(
+      {"nmcli",
+       "connection",
+       "modify",
+       *connection_name,
+       "ipv4.method",
+       "manual",
+       "ipv4.addresses",
+       address_with_prefix,
+       "ipv4.gateway",
+       config.gateway,
+       "ipv4.dns",
+       config.dns},
+      kModifyTimeout);
   if (!modify_result) {
     result.message = "無法執行 nmcli 修改指令";
     return result;
   }
-  if (!CommandSucceeded(modify_result->status)) {
-    result.message = modify_result->output;
-    LogErrorFormat("手動設定指令失敗: {}", modify_result->output);
+  if (!modify_result->Succeeded()) {
+    result.message = modify_result->ErrorOutput();
+    LogErrorFormat("手動設定指令失敗: {}", result.message);
+    InvalidateConnectionName(config.interface_name);
     return result;
   }
 
-  const std::string up_command =
-      "nmcli connection up " + ShellEscape(*connection_name);
-  auto up_result = RunCommandWithCapture(up_command);
+  const auto* up_result = RunCommand(
+      {"nmcli", "connection", "up", *connection_name}, kConnectionUpTimeout);
   if (!up_result) {
     result.message = "無法執行 nmcli 啟動指令";
     return result;
   }
-  if (!CommandSucceeded(up_result->status)) {
-    result.message = up_result->output;
-    LogErrorFormat("nmcli connection up 失敗: {}", up_result->output);
+  if (!up_result->Succeeded()) {
+    result.message = up_result->ErrorOutput();
+    LogErrorFormat("nmcli connection up 失敗: {}", result.message);
     return result;
   }
 
@@ -406,36 +375,54 @@ OperationResult NetworkService::SwitchToDhcp(
     return result;
   }
 
+  if (const auto live = GetNetworkConfig(interface_name);
+      live && HasDhcpLease(*live)) {
+    result.success = true;
+    result.message = "已是 DHCP 模式，未重新套用";
+    LogInfoFormat("介面 {} 已是 DHCP，略過", interface_name);
+    return result;
+  }
+
   auto connection_name = ResolveConnectionName(interface_name);
   if (!connection_name) {
     result.message = "找不到對應的連線名稱";
     return result;
   }
 
-  std::string command = "nmcli connection modify " +
-      ShellEscape(*connection_name) +
-      " ipv4.method auto ipv4.addresses '' ipv4.gateway '' ipv4.dns ''";
-  auto modify_result = RunCommandWithCapture(command);
+  const auto* modify_result = RunCommand(
+      {"nmcli",
+       "connection",
+       "modify",
+       *connection_name,
+       "ipv4.method",
+       "auto",
+       "ipv4.addresses",
+       "",
+       "ipv4.gateway",
+       "",
+       "ipv4.dns",
+       ""},
+      kModifyTimeout);
   if (!modify_result) {
     result.message = "無法執行 nmcli 修改指令";
     return result;
   }
-  if (!CommandSucceeded(modify_result->status)) {
-    result.message = modify_result->output;
-    LogErrorFormat("切換 DHCP 指令失敗: {}", modify_result->output);
+  if (!modify_result->Succeeded()) {
+    result.message = modify_result->ErrorOutput();
+    LogErrorFormat("切換 DHCP 指令失敗: {}", result.message);
+    InvalidateConnectionName(interface_name);
     return result;
   }
 
-  const std::string up_command =
-      "nmcli connection up " + ShellEscape(*connection_name);
-  auto up_result = RunCommandWithCapture(up_command);
+  const auto* up_result = RunCommand(
+      {"nmcli", "connection", "up", *connection_name}, kConnectionUpTimeout);
   if (!up_result) {
     result.message = "無法執行 nmcli 啟動指令";
     return result;
   }
-  if (!CommandSucceeded(up_result->status)) {
-    result.message = up_result->output;
-    LogErrorFormat("nmcli connection up 失敗: {}", up_result->output);
+  if (!up_result->Succeeded()) {
+    result.message = up_result->ErrorOutput();
+    LogErrorFormat("nmcli connection up 失敗: {}", result.message);
     return result;
   }
 
@@ -12,6 +12,9 @@ struct NetworkConfigData {
   std::string gateway;
   std::string dns;
   iptool::NetworkMode mode = iptool::NETWORK_MODE_UNSPECIFIED;
+  bool link_up = false;
+
+  bool operator==(const NetworkConfigData&) const = default;
 };
 
 struct OperationResult {
@@ -28,6 +31,17 @@ class NetworkService {
 
   static std::optional<NetworkConfigData> GetNetworkConfig(
       const std::string& interface_name);
+  // 只以 kernel 狀態更新位址、gateway 與 link 欄位，不呼叫 nmcli；
+  // 介面沒有 IPv4 位址時回傳 false，呼叫端應改用 GetNetworkConfig
+  static bool RefreshKernelState(NetworkConfigData* config);
+  // 檢查手動設定的必填欄位與遮罩格式，通過時 success 為 true
+  static OperationResult ValidateManualConfig(const NetworkConfigData& config);
+  // 即時狀態已是 link up 且位址、遮罩、gateway、DNS 相同的手動設定
+  static bool MatchesManualConfig(
+      const NetworkConfigData& live, const NetworkConfigData& target);
+  // 即時狀態已是 link up 且取得位址的 DHCP
+  static bool HasDhcpLease(const NetworkConfigData& live);
+  // 目前的即時狀態已符合目標設定時直接回傳成功，不重新啟動連線
   static OperationResult SetManualConfig(const NetworkConfigData& config);
   static OperationResult SwitchToDhcp(const std::string& interface_name);
 };
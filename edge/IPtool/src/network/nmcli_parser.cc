@@ -0,0 +1,200 @@
+#include "network/nmcli_parser.hpp"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+
+namespace iptool::nmcli {
+
+namespace {
+
+template <typename Handler>
+void ForEachLine(std::string_view output, Handler&& handler) {
+  while (!output.empty()) {
+    const auto newline = output.find('\n');
+    handler(output.substr(0, newline));
+    output = newline == std::string_view::npos ? std::string_view{}
+                                               : output.substr(newline + 1);
+  }
+}
+
+// 逐行走訪 "key:value"，略過沒有分隔符號的行；key 與 value 皆已去除
+// 前後空白。屬性名稱不含 ':'，以第一個 ':' 分隔
+template <typename Handler>
+void ForEachField(std::string_view output, Handler&& handler) {
+  ForEachLine(output, [&](std::string_view line) {
+    const auto separator = line.find(':');
+    if (separator == std::string_view::npos) {
+      return;
+    }
+    handler(Trim(line.substr(0, separator)), Trim(line.substr(separator + 1)));
+  });
+}
+
+// 取多值欄位的第一筆。nmcli 依版本以 ","、", " 或 "; " 分隔多個值，
+// IPv4 位址本身不含這些字元
+std::string_view FirstValue(std::string_view value) {
+  return Trim(value.substr(0, value.find_first_of(",; ")));
+}
+
+// 還原 terse 輸出中跳脫的 "\:" 與 "\\"，其餘字元原樣保留
+void AssignUnescaped(std::string_view value, std::string* out) {
+  out->clear();
+  for (size_t i = 0; i < value.size(); ++i) {
+    if (value[i] == '\\' && i + 1 < value.size() &&
+        (value[i + 1] == ':' || value[i + 1] == '\\')) {
+      ++i;
+    }
+    out->push_back(value[i]);
+  }
+}
+
+} // namespace
+
+std::string_view Trim(std::string_view value) {
+  constexpr std::string_view kSpaces = " \t\r\n\v\f";
+  const auto begin = value.find_first_not_of(kSpaces);
+  if (begin == std::string_view::npos) {
+    return {};
+  }
+  const auto end = value.find_last_not_of(kSpaces);
+  return value.substr(begin, end - begin + 1);
+}
+
+std::optional<std::string> PrefixToMask(const int prefix_length) {
+  if (prefix_length < 0 || prefix_length > 32) {
+    return std::nullopt;
+  }
+  // 以 64 位元位移避免 prefix 為 0 時位移 32 位元的未定義行為
+  const auto mask = static_cast<uint32_t>(
+      ~uint64_t{0} << (32 - prefix_length));
+  // "255.255.255.255" 為 15 字元，位於 SSO 範圍內
+  std::array<char, 16> buffer;
+  char* out = buffer.data();
+  char* const end = buffer.data() + buffer.size();
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out = std::to_chars(out, end, (mask >> shift) & 0xFF).ptr;
+    if (shift > 0) {
+      *out++ = '.';
+    }
+  }
+  return std::string(buffer.data(), out);
+}
+
+std::optional<int> MaskToPrefix(std::string_view mask) {
+  const char* cursor = mask.data();
+  const char* const end = mask.data() + mask.size();
+  uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (i > 0) {
+      if (cursor == end || *cursor != '.') {
+        return std::nullopt;
+      }
+      ++cursor;
+    }
+    unsigned octet = 0;
+    const auto [ptr, ec] = std::from_chars(cursor, end, octet);
+    if (ec != std::errc{} || ptr == cursor || octet > 255) {
+      return std::nullopt;
+    }
+    value = (value << 8) | octet;
+    cursor = ptr;
+  }
+  if (cursor != end) {
+    return std::nullopt;
+  }
+  // 合法遮罩取反後必為 2^k - 1（低位元全為 1）
+  const uint32_t host_bits = ~value;
+  if ((host_bits & (host_bits + 1)) != 0) {
+    return std::nullopt;
+  }
+  return std::popcount(value);
+}
+
+void ParseAddressWithPrefix(
+    std::string_view value, std::string* ip, std::string* mask) {
+  if (value.empty()) {
+    return;
+  }
+  const auto address = FirstValue(value);
+  const auto slash = address.find('/');
+  if (slash == std::string_view::npos) {
+    ip->assign(address);
+    return;
+  }
+  ip->assign(address.substr(0, slash));
+  const auto prefix_text = address.substr(slash + 1);
+  int prefix_length = -1;
+  const auto [ptr, ec] = std::from_chars(
+      prefix_text.data(),
+      prefix_text.data() + prefix_text.size(),
+      prefix_length);
+  if (ec != std::errc{} || ptr != prefix_text.data() + prefix_text.size()) {
+    return;
+  }
+  if (auto mask_opt = PrefixToMask(prefix_length)) {
+    *mask = std::move(*mask_opt);
+  }
+}
+
+NetworkConfigData ParseConfigOutput(
+    std::string_view interface_name, std::string_view output) {
+  NetworkConfigData data;
+  data.interface_name.assign(interface_name);
+
+  ForEachField(output, [&](std::string_view key, std::string_view value) {
+    if (key == "ipv4.method") {
+      if (value == "auto") {
+        data.mode = iptool::NETWORK_MODE_DHCP;
+      } else if (value == "manual") {
+        data.mode = iptool::NETWORK_MODE_MANUAL;
+      } else {
+        data.mode = iptool::NETWORK_MODE_UNSPECIFIED;
+      }
+    } else if (key == "ipv4.addresses") {
+      ParseAddressWithPrefix(value, &data.ip_address, &data.subnet_mask);
+    } else if (key == "ipv4.gateway") {
+      data.gateway.assign(value);
+    } else if (key == "ipv4.dns") {
+      data.dns.assign(FirstValue(value));
+    }
+  });
+  return data;
+}
+
+void ParseDeviceShowOutput(std::string_view output, NetworkConfigData* data) {
+  ForEachField(output, [&](std::string_view key, std::string_view value) {
+    if (key.starts_with("IP4.ADDRESS")) {
+      ParseAddressWithPrefix(value, &data->ip_address, &data->subnet_mask);
+    } else if (key == "IP4.GATEWAY") {
+      data->gateway.assign(value);
+    } else if (key.starts_with("IP4.DNS")) {
+      if (!data->dns.empty()) {
+        data->dns += ';';
+      }
+      data->dns.append(FirstValue(value));
+    }
+  });
+}
+
+bool FindConnectionName(
+    std::string_view output,
+    std::string_view interface_name,
+    std::string* name) {
+  bool found = false;
+  ForEachLine(output, [&](std::string_view line) {
+    // 連線名稱中的 ':' 會跳脫為 "\:"，介面名稱則不可能含 ':'，因此以
+    // 最後一個 ':' 分隔
+    const auto separator = line.rfind(':');
+    if (found || separator == std::string_view::npos ||
+        Trim(line.substr(separator + 1)) != interface_name) {
+      return;
+    }
+    AssignUnescaped(Trim(line.substr(0, separator)), name);
+    found = true;
+  });
+  return found;
+}
+
+} // namespace iptool::nmcli
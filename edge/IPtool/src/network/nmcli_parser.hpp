@@ -0,0 +1,46 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "network/network_service.hpp"
+
+/**
+ * nmcli `-t`（terse）輸出的解析函式。全部以 std::string_view 走訪原始
+ * 輸出，不建立中間字串；只有寫入結果欄位時才會配置記憶體（並沿用欄位
+ * 既有的容量）。
+ */
+namespace iptool::nmcli {
+
+// 去除前後空白（含 \r）
+std::string_view Trim(std::string_view value);
+
+// 前綴長度轉換成點分十進位遮罩，超出 [0, 32] 時回傳 std::nullopt
+std::optional<std::string> PrefixToMask(int prefix_length);
+
+// 點分十進位遮罩轉換成前綴長度；格式錯誤或 1 位元不連續時回傳 std::nullopt
+std::optional<int> MaskToPrefix(std::string_view mask);
+
+// 解析 `ipv4.addresses` / `IP4.ADDRESS` 的值（"a.b.c.d/nn"，多筆以 ; 分隔
+// 時只取第一筆）並寫入 ip 與 mask
+void ParseAddressWithPrefix(
+    std::string_view value, std::string* ip, std::string* mask);
+
+// 解析 `nmcli -t -f ipv4.* connection show <name>` 的輸出
+NetworkConfigData ParseConfigOutput(
+    std::string_view interface_name, std::string_view output);
+
+// 解析 `nmcli -t -f IP4.* device show <dev>` 的輸出並寫入 data；
+// 多個 DNS 以 ; 串接
+void ParseDeviceShowOutput(std::string_view output, NetworkConfigData* data);
+
+// 從 `nmcli -t -f NAME,DEVICE connection show` 的輸出找出介面對應的
+// 連線名稱，還原跳脫字元後寫入 name（沿用其既有容量）；找不到時回傳
+// false 且不修改 name
+bool FindConnectionName(
+    std::string_view output,
+    std::string_view interface_name,
+    std::string* name);
+
+} // namespace iptool::nmcli
@@ -0,0 +1,206 @@
+#include "network/operation_queue.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "process/subprocess.hpp"
+#include "util/logging.hpp"
+
+namespace {
+
+// 保留已完成操作的筆數上限，供呼叫端之後查詢
+constexpr size_t kMaxHistory = 256;
+
+bool AllCancelled(const std::vector<NetworkOperationQueue::CancelFlag>& flags) {
+  return !flags.empty() &&
+      std::all_of(flags.begin(), flags.end(), [](const auto& flag) {
+           return flag->load(std::memory_order_relaxed);
+         });
+}
+
+} // namespace
+
+NetworkOperationQueue::NetworkOperationQueue(
+    Applier apply, Completion on_applied)
+    : apply_(std::move(apply)), on_applied_(std::move(on_applied)) {}
+
+NetworkOperationQueue::~NetworkOperationQueue() {
+  std::vector<std::jthread> workers;
+  std::vector<Notification> notifications;
+  {
+    std::lock_guard lock(mutex_);
+    const OperationResult aborted{false, "服務結束，操作未執行"};
+    for (auto& [name, lane] : lanes_) {
+      // 未開始的操作不再執行，只等待進行中的 nmcli 結束
+      if (lane.pending) {
+        lane.pending.reset();
+        auto finished =
+            Finish(lane.pending_id, OperationState::kAborted, aborted);
+        std::move(
+            finished.begin(),
+            finished.end(),
+            std::back_inserter(notifications));
+      }
+      if (lane.worker.joinable()) {
+        workers.push_back(std::move(lane.worker));
+      }
+    }
+  }
+  for (const auto& [listener, status] : notifications) {
+    listener(status);
+  }
+  workers.clear();
+}
+
+uint64_t NetworkOperationQueue::Submit(
+    NetworkConfigData target, CancelFlag cancel) {
+  std::lock_guard lock(mutex_);
+  const uint64_t id = ++next_id_;
+  const std::string interface_name = target.interface_name;
+  auto& status = operations_[id];
+  status.id = id;
+  status.interface_name = interface_name;
+
+  auto& lane = lanes_[interface_name];
+  if (lane.pending) {
+    // 尚未開始的變更改由新的請求取代，連同先前已合併的操作一起轉移
+    for (auto& [other_id, other] : operations_) {
+      if (other_id == lane.pending_id ||
+          (other.merged_into == lane.pending_id && !other.finished())) {
+        other.merged_into = id;
+      }
+    }
+    LogInfoFormat(
+        "介面 {} 的操作 {} 由操作 {} 取代", interface_name, lane.pending_id, id);
+  } else {
+    lane.pending_cancels.clear();
+    lane.pending_detached = false;
+  }
+  if (cancel) {
+    lane.pending_cancels.push_back(std::move(cancel));
+  } else {
+    lane.pending_detached = true;
+  }
+  lane.pending = std::move(target);
+  lane.pending_id = id;
+
+  if (!lane.busy) {
+    if (lane.worker.joinable()) {
+      // 上一個執行緒已離開處理迴圈，只剩結束
+      lane.worker.join();
+    }
+    lane.busy = true;
+    lane.worker =
+        std::jthread([this, interface_name] { RunLane(interface_name); });
+  }
+  return id;
+}
+
+void NetworkOperationQueue::RunLane(std::string interface_name) {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    auto& lane = lanes_[interface_name];
+    if (!lane.pending) {
+      lane.busy = false;
+      return;
+    }
+    NetworkConfigData target = std::move(*lane.pending);
+    lane.pending.reset();
+    const uint64_t id = lane.pending_id;
+    // 有不等待結果的呼叫端時不隨取消中止
+    std::vector<CancelFlag> cancels;
+    if (!lane.pending_detached) {
+      cancels = std::move(lane.pending_cancels);
+    }
+    lane.pending_cancels.clear();
+
+    std::vector<Notification> notifications;
+    if (AllCancelled(cancels)) {
+      LogInfoFormat("介面 {} 的操作 {} 已取消，不套用", interface_name, id);
+      notifications = Finish(
+          id, OperationState::kAborted, {false, "請求已取消，設定未套用"});
+    } else {
+      operations_[id].state = OperationState::kRunning;
+      lock.unlock();
+
+      LogInfoFormat("開始執行介面 {} 的操作 {}", interface_name, id);
+      OperationResult result;
+      {
+        std::optional<iptool::process::ScopedCancellation> scope;
+        if (!cancels.empty()) {
+          scope.emplace([&cancels] { return AllCancelled(cancels); });
+        }
+        result = apply_(target);
+      }
+      on_applied_(interface_name);
+
+      lock.lock();
+      notifications = Finish(
+          id,
+          result.success ? OperationState::kSucceeded
+                         : OperationState::kFailed,
+          result);
+    }
+    if (!notifications.empty()) {
+      lock.unlock();
+      for (const auto& [listener, status] : notifications) {
+        listener(status);
+      }
+      lock.lock();
+    }
+  }
+}
+
+std::vector<NetworkOperationQueue::Notification> NetworkOperationQueue::Finish(
+    uint64_t id, OperationState state, const OperationResult& result) {
+  std::vector<Notification> notifications;
+  for (auto& [other_id, status] : operations_) {
+    if (other_id == id || status.merged_into == id) {
+      status.state = state;
+      status.result = result;
+      auto [begin, end] = listeners_.equal_range(other_id);
+      for (auto it = begin; it != end; ++it) {
+        notifications.emplace_back(std::move(it->second), status);
+      }
+      listeners_.erase(begin, end);
+    }
+  }
+  TrimHistory();
+  return notifications;
+}
+
+void NetworkOperationQueue::TrimHistory() {
+  for (auto it = operations_.begin();
+       operations_.size() > kMaxHistory && it != operations_.end();) {
+    if (it->second.finished()) {
+      it = operations_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::optional<OperationStatus> NetworkOperationQueue::Status(
+    uint64_t id) const {
+  std::lock_guard lock(mutex_);
+  if (auto it = operations_.find(id); it != operations_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+void NetworkOperationQueue::NotifyWhenDone(uint64_t id, Listener listener) {
+  std::optional<OperationStatus> status;
+  {
+    std::lock_guard lock(mutex_);
+    auto it = operations_.find(id);
+    if (it != operations_.end() && !it->second.finished()) {
+      listeners_.emplace(id, std::move(listener));
+      return;
+    }
+    if (it != operations_.end()) {
+      status = it->second;
+    }
+  }
+  listener(status);
+}
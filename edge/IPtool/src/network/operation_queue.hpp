@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "network/network_service.hpp"
+
+// kAborted：未開始執行即中止（服務結束，或等待結果的呼叫端都已取消），
+// 設定沒有被套用
+enum class OperationState {
+  kPending,
+  kRunning,
+  kSucceeded,
+  kFailed,
+  kAborted,
+};
+
+struct OperationStatus {
+  uint64_t id = 0;
+  std::string interface_name;
+  OperationState state = OperationState::kPending;
+  OperationResult result;
+  // 尚未執行就被同介面較新的請求取代時，記錄實際套用的操作 ID；
+  // 完成時結果與該操作相同
+  uint64_t merged_into = 0;
+
+  bool finished() const {
+    return state != OperationState::kPending &&
+        state != OperationState::kRunning;
+  }
+};
+
+/**
+ * 每個介面一條單一寫入者的設定佇列。同一介面的變更依序執行，不會交錯
+ * 呼叫 nmcli；尚未開始的變更會被較新的請求合併，只套用最後的目標設定。
+ */
+class NetworkOperationQueue {
+ public:
+  // 依 target.mode 套用手動設定或切換 DHCP
+  using Applier = std::function<OperationResult(const NetworkConfigData&)>;
+  // 每次套用結束（不論成功與否）後於佇列執行緒呼叫
+  using Completion = std::function<void(const std::string& interface_name)>;
+  // 操作結束時的通知；ID 不存在時參數為 std::nullopt
+  using Listener = std::function<void(const std::optional<OperationStatus>&)>;
+  // 呼叫端的取消旗標（例如 UnaryCall::cancelled()）
+  using CancelFlag = std::shared_ptr<const std::atomic<bool>>;
+
+  NetworkOperationQueue(Applier apply, Completion on_applied);
+  // 等待執行中的操作結束；尚未開始的操作以 kAborted 結束並通知 listener
+  ~NetworkOperationQueue();
+  NetworkOperationQueue(const NetworkOperationQueue&) = delete;
+  NetworkOperationQueue& operator=(const NetworkOperationQueue&) = delete;
+
+  // 排入目標設定並立即回傳操作 ID。cancel 為 nullptr 表示呼叫端不等待
+  // 結果，設定一定會套用；否則合併到同一次套用的呼叫端全部取消時，
+  // 尚未開始的操作以 kAborted 結束，執行中的操作則終止其 nmcli
+  uint64_t Submit(NetworkConfigData target, CancelFlag cancel = nullptr);
+
+  std::optional<OperationStatus> Status(uint64_t id) const;
+
+  // 操作結束後於佇列執行緒（不持有鎖）呼叫 listener，不佔用等待的執行緒；
+  // 操作已結束或 ID 不存在時直接在呼叫端執行緒呼叫
+  void NotifyWhenDone(uint64_t id, Listener listener);
+
+ private:
+  struct Lane {
+    std::optional<NetworkConfigData> pending;
+    uint64_t pending_id = 0;
+    // 合併到 pending 的呼叫端取消旗標；有任何不等待的呼叫端時為 detached
+    std::vector<CancelFlag> pending_cancels;
+    bool pending_detached = false;
+    bool busy = false;
+    std::jthread worker;
+  };
+
+  using Notification = std::pair<Listener, OperationStatus>;
+
+  void RunLane(std::string interface_name);
+  // 回傳需要在解鎖後呼叫的 listener
+  std::vector<Notification> Finish(
+      uint64_t id, OperationState state, const OperationResult& result);
+  void TrimHistory();
+
+  Applier apply_;
+  Completion on_applied_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Lane> lanes_;
+  std::map<uint64_t, OperationStatus> operations_;
+  std::unordered_multimap<uint64_t, Listener> listeners_;
+  uint64_t next_id_ = 0;
+};
@@ -0,0 +1,346 @@
+#include "network/path_diagnostics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "network/netlink_reader.hpp"
+#include "util/logging.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 等待期間檢查取消的最長間隔
+constexpr std::chrono::milliseconds kCancelPollInterval{100};
+constexpr size_t kDnsHeaderSize = 12;
+
+struct Probe {
+  int fd = -1;
+  bool pending = false;
+  uint16_t dns_id = 0;
+  Clock::time_point started;
+};
+
+void CloseWithReset(int fd) {
+  // 直接送出 RST，不在對方留下半開或 TIME_WAIT 連線
+  const linger reset{1, 0};
+  ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+  ::close(fd);
+}
+
+std::string_view TrimView(std::string_view text) {
+  const auto begin = text.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) {
+    return {};
+  }
+  const auto end = text.find_last_not_of(" \t");
+  return text.substr(begin, end - begin + 1);
+}
+
+// 以 RD 旗標查詢 A 紀錄；名稱格式錯誤時回傳空
+std::vector<uint8_t> BuildDnsQuery(std::string_view name) {
+  std::vector<uint8_t> query(kDnsHeaderSize, 0);
+  query[2] = 0x01; // RD
+  query[5] = 0x01; // QDCOUNT = 1
+  while (!name.empty()) {
+    const auto dot = name.find('.');
+    const auto label = name.substr(0, dot);
+    if (label.empty() || label.size() > 63) {
+      return {};
+    }
+    query.push_back(static_cast<uint8_t>(label.size()));
+    query.insert(query.end(), label.begin(), label.end());
+    name = dot == std::string_view::npos ? std::string_view{}
+                                         : name.substr(dot + 1);
+  }
+  if (query.size() == kDnsHeaderSize) {
+    return {};
+  }
+  query.push_back(0);
+  // QTYPE = A, QCLASS = IN
+  query.insert(query.end(), {0x00, 0x01, 0x00, 0x01});
+  return query;
+}
+
+} // namespace
+
+std::optional<ProbeTarget> ParseProbeEndpoint(
+    std::string_view endpoint, ProbeKind kind, uint16_t default_port) {
+  endpoint = TrimView(endpoint);
+  ProbeTarget target;
+  target.kind = kind;
+  target.port = default_port;
+  const auto colon = endpoint.rfind(':');
+  if (colon != std::string_view::npos) {
+    const auto port_text = endpoint.substr(colon + 1);
+    uint16_t port = 0;
+    const auto [ptr, ec] = std::from_chars(
+        port_text.data(), port_text.data() + port_text.size(), port);
+    if (ec != std::errc{} || ptr != port_text.data() + port_text.size() ||
+        port == 0) {
+      return std::nullopt;
+    }
+    target.port = port;
+    endpoint = endpoint.substr(0, colon);
+  }
+  target.host = std::string(endpoint);
+  in_addr address{};
+  if (::inet_pton(AF_INET, target.host.c_str(), &address) != 1) {
+    return std::nullopt;
+  }
+  return target;
+}
+
+std::vector<ProbeTarget> BuildConfigTargets(
+    const std::string& gateway, const std::string& dns, uint16_t gateway_port) {
+  std::vector<ProbeTarget> targets;
+  if (!gateway.empty()) {
+    if (auto target =
+            ParseProbeEndpoint(gateway, ProbeKind::kGateway, gateway_port)) {
+      targets.push_back(std::move(*target));
+    }
+  }
+  std::string_view servers(dns);
+  while (!servers.empty()) {
+    const auto delimiter = servers.find_first_of(";,");
+    const auto server = TrimView(servers.substr(0, delimiter));
+    if (!server.empty()) {
+      if (auto target =
+              ParseProbeEndpoint(server, ProbeKind::kDns, kDefaultDnsPort)) {
+        targets.push_back(std::move(*target));
+      }
+    }
+    servers = delimiter == std::string_view::npos
+                  ? std::string_view{}
+                  : servers.substr(delimiter + 1);
+  }
+  return targets;
+}
+
+std::vector<ProbeStats> RunPathDiagnostics(
+    std::span<const ProbeTarget> targets,
+    const DiagnosticsOptions& options,
+    const std::function<bool()>& cancelled) {
+  std::vector<ProbeStats> stats(targets.size());
+  std::vector<sockaddr_in> addresses(targets.size());
+  for (size_t i = 0; i < targets.size(); ++i) {
+    stats[i].target = targets[i];
+    addresses[i].sin_family = AF_INET;
+    addresses[i].sin_port = htons(targets[i].port);
+    if (::inet_pton(
+            AF_INET, targets[i].host.c_str(), &addresses[i].sin_addr) != 1) {
+      stats[i].error = "位址格式錯誤";
+    }
+  }
+
+  auto dns_query = BuildDnsQuery(options.dns_query_name);
+  if (dns_query.empty()) {
+    for (auto& entry : stats) {
+      if (entry.target.kind == ProbeKind::kDns && entry.error.empty()) {
+        entry.error = "DNS 查詢名稱格式錯誤";
+      }
+    }
+  }
+
+  const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0) {
+    LogErrorFormat("epoll_create1 失敗: {}", std::strerror(errno));
+    for (auto& entry : stats) {
+      entry.error = "無法建立 epoll";
+    }
+    return stats;
+  }
+
+  std::mt19937 random{std::random_device{}()};
+  std::vector<Probe> probes(targets.size());
+  std::vector<double> total_ms(targets.size(), 0.0);
+  size_t pending = 0;
+
+  auto record = [&](size_t index, bool success) {
+    auto& probe = probes[index];
+    if (probe.fd >= 0) {
+      ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, probe.fd, nullptr);
+      if (targets[index].kind == ProbeKind::kDns) {
+        ::close(probe.fd);
+      } else {
+        CloseWithReset(probe.fd);
+      }
+      probe.fd = -1;
+    }
+    probe.pending = false;
+    --pending;
+    if (!success) {
+      return;
+    }
+    const double elapsed_ms =
+        std::chrono::duration<double, std::milli>(
+            Clock::now() - probe.started)
+            .count();
+    auto& entry = stats[index];
+    entry.min_ms =
+        entry.received == 0 ? elapsed_ms : std::min(entry.min_ms, elapsed_ms);
+    entry.max_ms = std::max(entry.max_ms, elapsed_ms);
+    total_ms[index] += elapsed_ms;
+    ++entry.received;
+  };
+
+  // 建立 socket 並送出探測；已立即得到結果時直接記錄
+  auto start = [&](size_t index) {
+    const auto& target = targets[index];
+    const bool is_dns = target.kind == ProbeKind::kDns;
+    const int fd = ::socket(
+        AF_INET,
+        (is_dns ? SOCK_DGRAM : SOCK_STREAM) | SOCK_NONBLOCK | SOCK_CLOEXEC,
+        0);
+    if (fd < 0) {
+      LogWarnFormat("無法建立探測 socket: {}", std::strerror(errno));
+      return;
+    }
+    auto& probe = probes[index];
+    probe.fd = fd;
+    probe.pending = true;
+    probe.started = Clock::now();
+    ++stats[index].sent;
+    ++pending;
+
+    const auto* address = reinterpret_cast<const sockaddr*>(&addresses[index]);
+    epoll_event event{};
+    event.data.u64 = index;
+    if (is_dns) {
+      probe.dns_id = static_cast<uint16_t>(random());
+      dns_query[0] = static_cast<uint8_t>(probe.dns_id >> 8);
+      dns_query[1] = static_cast<uint8_t>(probe.dns_id & 0xff);
+      if (::connect(fd, address, sizeof(sockaddr_in)) != 0 ||
+          ::send(fd, dns_query.data(), dns_query.size(), 0) < 0) {
+        record(index, false);
+        return;
+      }
+      event.events = EPOLLIN;
+    } else {
+      if (::connect(fd, address, sizeof(sockaddr_in)) == 0) {
+        record(index, true);
+        return;
+      }
+      if (errno != EINPROGRESS) {
+        // RST 代表對方主機存在，只是連接埠未開啟
+        record(index, errno == ECONNREFUSED);
+        return;
+      }
+      event.events = EPOLLOUT;
+    }
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+  };
+
+  auto handle = [&](size_t index) {
+    auto& probe = probes[index];
+    if (targets[index].kind != ProbeKind::kDns) {
+      int error = 0;
+      socklen_t length = sizeof(error);
+      ::getsockopt(probe.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+      record(index, error == 0 || error == ECONNREFUSED);
+      return;
+    }
+    std::array<uint8_t, 512> reply;
+    while (true) {
+      const ssize_t received = ::recv(probe.fd, reply.data(), reply.size(), 0);
+      if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          return;
+        }
+        // ICMP port unreachable 等錯誤：伺服器沒有提供 DNS 服務
+        record(index, false);
+        return;
+      }
+      // 只接受 ID 相符的回應（QR = 1），忽略過期或偽造的封包；
+      // NXDOMAIN 等錯誤碼仍代表伺服器有回應
+      if (static_cast<size_t>(received) >= kDnsHeaderSize &&
+          reply[0] == (probe.dns_id >> 8) &&
+          reply[1] == (probe.dns_id & 0xff) && (reply[2] & 0x80) != 0) {
+        record(index, true);
+        return;
+      }
+    }
+  };
+
+  auto is_cancelled = [&] { return cancelled && cancelled(); };
+
+  std::array<epoll_event, 32> events;
+  for (uint32_t attempt = 0; attempt < options.attempts; ++attempt) {
+    if (is_cancelled()) {
+      break;
+    }
+    const auto round_start = Clock::now();
+    for (size_t i = 0; i < targets.size(); ++i) {
+      if (stats[i].error.empty()) {
+        start(i);
+      }
+    }
+
+    const auto deadline = round_start + options.timeout;
+    while (pending > 0 && !is_cancelled()) {
+      const auto now = Clock::now();
+      if (now >= deadline) {
+        break;
+      }
+      const auto wait = std::min(
+          std::chrono::ceil<std::chrono::milliseconds>(deadline - now),
+          kCancelPollInterval);
+      const int ready = ::epoll_wait(
+          epoll_fd,
+          events.data(),
+          static_cast<int>(events.size()),
+          static_cast<int>(wait.count()));
+      if (ready < 0 && errno != EINTR) {
+        LogErrorFormat("epoll_wait 失敗: {}", std::strerror(errno));
+        break;
+      }
+      for (int i = 0; i < ready; ++i) {
+        const auto index = static_cast<size_t>(events[i].data.u64);
+        if (probes[index].pending) {
+          handle(index);
+        }
+      }
+    }
+    // 逾時仍未完成的探測計為遺失
+    for (size_t i = 0; i < probes.size(); ++i) {
+      if (probes[i].pending) {
+        record(i, false);
+      }
+    }
+
+    if (attempt + 1 < options.attempts) {
+      const auto resume = round_start + options.interval;
+      while (Clock::now() < resume && !is_cancelled()) {
+        std::this_thread::sleep_for(std::min(
+            std::chrono::ceil<std::chrono::milliseconds>(
+                resume - Clock::now()),
+            kCancelPollInterval));
+      }
+    }
+  }
+  ::close(epoll_fd);
+
+  for (size_t i = 0; i < stats.size(); ++i) {
+    auto& entry = stats[i];
+    if (entry.received > 0) {
+      entry.avg_ms = total_ms[i] / entry.received;
+    }
+    // TCP 探測會觸發 ARP 解析；gateway 丟棄 TCP 時仍可由 ARP 回覆確認
+    if (entry.target.kind == ProbeKind::kGateway) {
+      entry.arp_resolved =
+          iptool::netlink::IsNeighbourConfirmed(entry.target.host);
+    }
+  }
+  return stats;
+}
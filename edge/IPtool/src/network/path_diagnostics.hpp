@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ProbeKind { kGateway, kDns, kCamera };
+
+struct ProbeTarget {
+  ProbeKind kind = ProbeKind::kCamera;
+  // IPv4 位址（不做名稱解析，避免診斷本身受 DNS 影響）
+  std::string host;
+  uint16_t port = 0;
+};
+
+struct DiagnosticsOptions {
+  uint32_t attempts = 3;
+  // 單次探測的逾時，超過即計為遺失
+  std::chrono::milliseconds timeout{1000};
+  // 相鄰兩輪探測開始時間的最小間隔
+  std::chrono::milliseconds interval{200};
+  // DNS 探測查詢的 A 紀錄名稱
+  std::string dns_query_name = "example.com";
+};
+
+struct ProbeStats {
+  ProbeTarget target;
+  uint32_t sent = 0;
+  uint32_t received = 0;
+  double min_ms = 0;
+  double avg_ms = 0;
+  double max_ms = 0;
+  // 僅 gateway：探測後 kernel neighbour 表中的 ARP 項目已確認（REACHABLE）
+  bool arp_resolved = false;
+  // 無法送出探測時的原因（例如位址格式錯誤）
+  std::string error;
+
+  double loss_ratio() const {
+    return sent == 0 ? 1.0 : 1.0 - static_cast<double>(received) / sent;
+  }
+
+  // 許多 gateway 會丟棄送往 TCP/80 的連線，此時以 ARP 回覆判斷可達
+  bool reachable() const {
+    return received > 0 || (target.kind == ProbeKind::kGateway && arp_resolved);
+  }
+};
+
+inline constexpr uint16_t kDefaultGatewayProbePort = 80;
+inline constexpr uint16_t kDefaultDnsPort = 53;
+inline constexpr uint16_t kDefaultCameraPort = 554;
+
+// 解析 "host" 或 "host:port"，未指定 port 時使用 default_port
+std::optional<ProbeTarget> ParseProbeEndpoint(
+    std::string_view endpoint, ProbeKind kind, uint16_t default_port);
+
+// 依目前的 gateway 與 dns 設定（以 ; 或 , 分隔）建立探測目標
+std::vector<ProbeTarget> BuildConfigTargets(
+    const std::string& gateway,
+    const std::string& dns,
+    uint16_t gateway_port = kDefaultGatewayProbePort);
+
+/**
+ * 以單一 epoll 迴圈同時探測所有目標，共 options.attempts 輪：
+ * gateway 與攝影機以非阻塞 TCP connect 量測往返時間（收到 RST 也代表
+ * 路徑可達），DNS 以 UDP 查詢量測回應時間。全部使用一般 socket，
+ * 不需要 raw socket 權限。cancelled 回傳 true 時提前結束並回傳已完成的
+ * 統計。
+ */
+std::vector<ProbeStats> RunPathDiagnostics(
+    std::span<const ProbeTarget> targets,
+    const DiagnosticsOptions& options,
+    const std::function<bool()>& cancelled = {});
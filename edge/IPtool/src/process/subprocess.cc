@@ -0,0 +1,354 @@
+#include "process/subprocess.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "util/logging.hpp"
+
+extern char** environ;
+
+namespace iptool::process {
+
+namespace {
+
+// 取消旗標的檢查間隔
+constexpr int kCancelPollMs = 50;
+// 參數與 argv 指標的暫存上限，nmcli 指令遠低於此
+constexpr size_t kMaxArgs = 32;
+constexpr size_t kArgBufferSize = 4096;
+
+class Pipe {
+ public:
+  Pipe() = default;
+  ~Pipe() { Close(); }
+  Pipe(const Pipe&) = delete;
+  Pipe& operator=(const Pipe&) = delete;
+
+  bool Open() { return ::pipe2(fds_.data(), O_CLOEXEC) == 0; }
+  int read_end() const { return fds_[0]; }
+  int write_end() const { return fds_[1]; }
+  void CloseRead() { CloseFd(&fds_[0]); }
+  void CloseWrite() { CloseFd(&fds_[1]); }
+  void Close() {
+    CloseRead();
+    CloseWrite();
+  }
+
+ private:
+  static void CloseFd(int* fd) {
+    if (*fd >= 0) {
+      ::close(*fd);
+      *fd = -1;
+    }
+  }
+  std::array<int, 2> fds_{-1, -1};
+};
+
+void SetError(ProcessResult* result, std::string_view what) {
+  result->stderr_data.assign(what);
+  result->stderr_data += ": ";
+  result->stderr_data += std::strerror(errno);
+}
+
+// 讀取可用資料，EOF 或錯誤時回傳 false
+bool Drain(int fd, std::string* out) {
+  std::array<char, 4096> chunk;
+  while (true) {
+    const ssize_t n = ::read(fd, chunk.data(), chunk.size());
+    if (n > 0) {
+      out->append(chunk.data(), static_cast<size_t>(n));
+      continue;
+    }
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    }
+    return false;
+  }
+}
+
+void Reap(pid_t pid, int* status) {
+  while (::waitpid(pid, status, 0) < 0 && errno == EINTR) {
+  }
+}
+
+enum class WaitResult {
+  kExited,
+  // 被取消或超過 deadline，行程仍在執行
+  kInterrupted,
+  // waitpid 失敗，errno 為其錯誤
+  kFailed,
+};
+
+/**
+ * 等待子行程結束並回收（寫入 status）。核心不支援 pidfd_open（5.3 之前）
+ * 時退回以短間隔輪詢 waitpid。
+ */
+template <typename Deadline, typename IsCanceled>
+WaitResult WaitExit(
+    pid_t pid,
+    Deadline deadline,
+    bool cancellable,
+    const IsCanceled& is_canceled,
+    int* status) {
+  const int pidfd = static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+  WaitResult outcome = WaitResult::kInterrupted;
+  while (true) {
+    const pid_t done = ::waitpid(pid, status, WNOHANG);
+    if (done == pid) {
+      outcome = WaitResult::kExited;
+      break;
+    }
+    if (done < 0 && errno != EINTR) {
+      outcome = WaitResult::kFailed;
+      break;
+    }
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - Deadline::clock::now());
+    if (is_canceled() || remaining.count() <= 0) {
+      break;
+    }
+    int wait_ms = static_cast<int>(remaining.count());
+    if (cancellable) {
+      wait_ms = std::min(wait_ms, kCancelPollMs);
+    }
+    if (pidfd >= 0) {
+      pollfd exit_fd{pidfd, POLLIN, 0};
+      ::poll(&exit_fd, 1, wait_ms);
+    } else {
+      ::usleep(static_cast<useconds_t>(std::min(wait_ms, 5) * 1000));
+    }
+  }
+  if (pidfd >= 0) {
+    const int saved_errno = errno;
+    ::close(pidfd);
+    errno = saved_errno;
+  }
+  return outcome;
+}
+
+thread_local const ScopedCancellation* t_scope = nullptr;
+
+} // namespace
+
+ScopedCancellation::ScopedCancellation(const std::atomic<bool>* cancel)
+    : cancel_(cancel), previous_(t_scope) {
+  t_scope = this;
+}
+
+ScopedCancellation::ScopedCancellation(std::function<bool()> cancelled)
+    : predicate_(std::move(cancelled)), previous_(t_scope) {
+  t_scope = this;
+}
+
+ScopedCancellation::~ScopedCancellation() {
+  t_scope = previous_;
+}
+
+const ScopedCancellation* ScopedCancellation::Current() {
+  return t_scope;
+}
+
+bool ScopedCancellation::cancelled() const {
+  if (cancel_) {
+    return cancel_->load(std::memory_order_relaxed);
+  }
+  return predicate_ && predicate_();
+}
+
+util::LatencyRegistry& SubprocessLatencies() {
+  static util::LatencyRegistry registry;
+  return registry;
+}
+
+bool RunProcess(
+    std::span<const std::string_view> argv,
+    const ProcessOptions& options,
+    ProcessResult* result) {
+  result->exit_code = -1;
+  result->term_signal = 0;
+  result->timed_out = false;
+  result->canceled = false;
+  result->stdout_data.clear();
+  result->stderr_data.clear();
+
+  if (argv.empty() || argv.size() >= kMaxArgs) {
+    result->stderr_data = "invalid argument vector";
+    return false;
+  }
+
+  // 參數複製到堆疊上的連續緩衝區並補上 NUL，避免每次呼叫配置記憶體
+  std::array<char, kArgBufferSize> arg_buffer;
+  std::array<char*, kMaxArgs> arg_ptrs{};
+  size_t used = 0;
+  for (size_t i = 0; i < argv.size(); ++i) {
+    const auto arg = argv[i];
+    if (used + arg.size() + 1 > arg_buffer.size() ||
+        arg.find('\0') != std::string_view::npos) {
+      result->stderr_data = "argument vector too long";
+      return false;
+    }
+    std::copy(arg.begin(), arg.end(), arg_buffer.begin() + used);
+    arg_buffer[used + arg.size()] = '\0';
+    arg_ptrs[i] = arg_buffer.data() + used;
+    used += arg.size() + 1;
+  }
+  arg_ptrs[argv.size()] = nullptr;
+
+  Pipe out_pipe;
+  Pipe err_pipe;
+  if (!out_pipe.Open() || !err_pipe.Open()) {
+    SetError(result, "pipe2");
+    return false;
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_adddup2(&actions, out_pipe.write_end(), 1);
+  posix_spawn_file_actions_adddup2(&actions, err_pipe.write_end(), 2);
+
+  // 子行程使用預設的 signal 行為，不繼承 gRPC 執行緒的 mask
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+  sigset_t default_signals;
+  sigset_t empty_mask;
+  sigemptyset(&default_signals);
+  sigaddset(&default_signals, SIGPIPE);
+  sigemptyset(&empty_mask);
+  posix_spawnattr_setsigdefault(&attr, &default_signals);
+  posix_spawnattr_setsigmask(&attr, &empty_mask);
+  posix_spawnattr_setflags(
+      &attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+
+  pid_t pid = -1;
+  const int spawn_error = ::posix_spawnp(
+      &pid, arg_ptrs[0], &actions, &attr, arg_ptrs.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attr);
+  out_pipe.CloseWrite();
+  err_pipe.CloseWrite();
+  if (spawn_error != 0) {
+    errno = spawn_error;
+    SetError(result, "posix_spawnp");
+    return false;
+  }
+
+  ::fcntl(out_pipe.read_end(), F_SETFL, O_NONBLOCK);
+  ::fcntl(err_pipe.read_end(), F_SETFL, O_NONBLOCK);
+
+  using Clock = std::chrono::steady_clock;
+  const auto started = Clock::now();
+  const auto deadline = started + options.timeout;
+  const ScopedCancellation* scope =
+      options.cancel ? nullptr : ScopedCancellation::Current();
+  const bool cancellable = options.cancel || scope;
+  auto is_canceled = [&options, scope] {
+    if (options.cancel) {
+      return options.cancel->load(std::memory_order_relaxed);
+    }
+    return scope && scope->cancelled();
+  };
+  std::array<pollfd, 2> fds{
+      pollfd{out_pipe.read_end(), POLLIN, 0},
+      pollfd{err_pipe.read_end(), POLLIN, 0}};
+  std::array<std::string*, 2> sinks{
+      &result->stdout_data, &result->stderr_data};
+  int open_fds = 2;
+  bool killed = false;
+
+  auto kill_child = [&](bool* flag) {
+    *flag = true;
+    ::kill(pid, SIGKILL);
+    killed = true;
+  };
+
+  while (open_fds > 0) {
+    if (is_canceled()) {
+      kill_child(&result->canceled);
+      break;
+    }
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - Clock::now());
+    if (remaining.count() <= 0) {
+      kill_child(&result->timed_out);
+      break;
+    }
+    int wait_ms = static_cast<int>(remaining.count());
+    if (cancellable) {
+      wait_ms = std::min(wait_ms, kCancelPollMs);
+    }
+
+    const int ready = ::poll(fds.data(), fds.size(), wait_ms);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      SetError(result, "poll");
+      kill_child(&killed);
+      break;
+    }
+    for (size_t i = 0; i < fds.size(); ++i) {
+      if (fds[i].fd < 0 || fds[i].revents == 0) {
+        continue;
+      }
+      if (!Drain(fds[i].fd, sinks[i])) {
+        fds[i].fd = -1;
+        --open_fds;
+      }
+    }
+  }
+
+  // stdout/stderr 已關閉但行程尚未結束時，仍受同一個時限約束；以 pidfd
+  // 等待行程結束，不需輪詢 waitpid
+  int status = 0;
+  if (!killed) {
+    switch (WaitExit(pid, deadline, cancellable, is_canceled, &status)) {
+      case WaitResult::kExited:
+        break;
+      case WaitResult::kInterrupted:
+        kill_child(is_canceled() ? &result->canceled : &result->timed_out);
+        break;
+      case WaitResult::kFailed:
+        SetError(result, "waitpid");
+        return false;
+    }
+  }
+  if (killed) {
+    Reap(pid, &status);
+  }
+
+  if (WIFEXITED(status)) {
+    result->exit_code = WEXITSTATUS(status);
+  } else if (WIFSIGNALED(status)) {
+    result->term_signal = WTERMSIG(status);
+  }
+  if (!options.label.empty()) {
+    SubprocessLatencies().Get(options.label).Record(Clock::now() - started);
+  }
+  if (result->timed_out) {
+    LogWarnFormat("子行程 {} 逾時，已終止", argv.front());
+  } else if (result->canceled) {
+    LogInfoFormat("子行程 {} 已隨請求取消而終止", argv.front());
+  }
+  return true;
+}
+
+} // namespace iptool::process
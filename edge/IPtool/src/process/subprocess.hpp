@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/latency_histogram.hpp"
+
+namespace iptool::process {
+
+struct ProcessOptions {
+  // 超過時限即以 SIGKILL 結束子行程
+  std::chrono::milliseconds timeout{std::chrono::seconds(15)};
+  // 非 nullptr 時，旗標被設為 true 會立即終止子行程；未指定時使用
+  // 目前執行緒上 ScopedCancellation 設定的旗標
+  const std::atomic<bool>* cancel = nullptr;
+  // 非空時將執行時間記錄到 SubprocessLatencies() 中同名的直方圖
+  std::string_view label;
+};
+
+/**
+ * 在作用範圍內將取消條件綁定到目前執行緒，讓深層呼叫的 RunProcess
+ * 不必逐層傳遞參數即可隨 RPC 取消（用戶端取消或 deadline 到期）終止
+ * 子行程。可巢狀使用，離開時還原先前的範圍。
+ */
+class ScopedCancellation {
+ public:
+  explicit ScopedCancellation(const std::atomic<bool>* cancel);
+  // 條件由多個旗標決定時使用，例如合併的請求全部取消才終止；
+  // RunProcess 執行期間會定期呼叫
+  explicit ScopedCancellation(std::function<bool()> cancelled);
+  ~ScopedCancellation();
+  ScopedCancellation(const ScopedCancellation&) = delete;
+  ScopedCancellation& operator=(const ScopedCancellation&) = delete;
+
+  // 目前執行緒最內層的範圍；沒有時為 nullptr
+  static const ScopedCancellation* Current();
+
+  bool cancelled() const;
+
+ private:
+  const std::atomic<bool>* cancel_ = nullptr;
+  std::function<bool()> predicate_;
+  const ScopedCancellation* previous_;
+};
+
+// 各類子行程的執行時間
+util::LatencyRegistry& SubprocessLatencies();
+
+struct ProcessResult {
+  int exit_code = -1;
+  int term_signal = 0;
+  bool timed_out = false;
+  bool canceled = false;
+  std::string stdout_data;
+  std::string stderr_data;
+
+  bool Succeeded() const {
+    return exit_code == 0 && term_signal == 0 && !timed_out && !canceled;
+  }
+  // 失敗時優先回傳 stderr，沒有內容時退回 stdout
+  std::string_view ErrorOutput() const {
+    return stderr_data.empty() ? stdout_data : stderr_data;
+  }
+};
+
+/**
+ * 不經過 /bin/sh 直接以 posix_spawnp 執行參數陣列，透過 pipe 擷取
+ * stdout/stderr，不落地到檔案。result 的字串會先 clear() 再寫入，
+ * 重複使用同一個 ProcessResult 可沿用其已配置的容量。
+ * 無法建立子行程時回傳 false（errno 訊息寫入 stderr_data）。
+ */
+bool RunProcess(
+    std::span<const std::string_view> argv,
+    const ProcessOptions& options,
+    ProcessResult* result);
+
+inline bool RunProcess(
+    std::initializer_list<std::string_view> argv,
+    const ProcessOptions& options,
+    ProcessResult* result) {
+  return RunProcess(
+      std::span<const std::string_view>(argv.begin(), argv.size()),
+      options,
+      result);
+}
+
+} // namespace iptool::process
@@ -0,0 +1,65 @@
+#include "util/bounded_executor.hpp"
+
+#include <algorithm>
+
+namespace iptool::util {
+
+BoundedExecutor::BoundedExecutor(uint32_t threads, uint32_t queue_capacity)
+    : queue_capacity_(std::max<uint32_t>(queue_capacity, 1)) {
+  threads = std::max<uint32_t>(threads, 1);
+  workers_.reserve(threads);
+  for (uint32_t i = 0; i < threads; ++i) {
+    workers_.emplace_back([this] { Run(); });
+  }
+}
+
+BoundedExecutor::~BoundedExecutor() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  ready_.notify_all();
+  workers_.clear();
+}
+
+bool BoundedExecutor::TrySubmit(std::function<void()> task) {
+  {
+    std::lock_guard lock(mutex_);
+    if (stopping_ || tasks_.size() >= queue_capacity_) {
+      ++rejected_;
+      return false;
+    }
+    tasks_.push_back(std::move(task));
+  }
+  ready_.notify_one();
+  return true;
+}
+
+BoundedExecutor::Stats BoundedExecutor::stats() const {
+  std::lock_guard lock(mutex_);
+  Stats stats;
+  stats.threads = static_cast<uint32_t>(workers_.size());
+  stats.queued = static_cast<uint32_t>(tasks_.size());
+  stats.active = active_;
+  stats.rejected = rejected_;
+  return stats;
+}
+
+void BoundedExecutor::Run() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+    if (tasks_.empty()) {
+      return;
+    }
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+    ++active_;
+    lock.unlock();
+    task();
+    lock.lock();
+    --active_;
+  }
+}
+
+} // namespace iptool::util
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iptool::util {
+
+/**
+ * 固定執行緒數、有界佇列的工作執行器，用來執行會阻塞的系統操作
+ * （nmcli、網路探測），不佔用 gRPC 的回呼執行緒。佇列已滿時 TrySubmit
+ * 直接回傳 false，由呼叫端回覆 RESOURCE_EXHAUSTED，不無限制地堆積工作。
+ */
+class BoundedExecutor {
+ public:
+  struct Stats {
+    uint32_t threads = 0;
+    uint32_t queued = 0;
+    uint32_t active = 0;
+    uint64_t rejected = 0;
+  };
+
+  BoundedExecutor(uint32_t threads, uint32_t queue_capacity);
+  // 等待已排入的工作執行完畢後結束
+  ~BoundedExecutor();
+  BoundedExecutor(const BoundedExecutor&) = delete;
+  BoundedExecutor& operator=(const BoundedExecutor&) = delete;
+
+  bool TrySubmit(std::function<void()> task);
+
+  Stats stats() const;
+
+ private:
+  void Run();
+
+  const uint32_t queue_capacity_;
+  mutable std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> tasks_;
+  uint32_t active_ = 0;
+  uint64_t rejected_ = 0;
+  bool stopping_ = false;
+  std::vector<std::jthread> workers_;
+};
+
+} // namespace iptool::util
@@ -0,0 +1,109 @@
+#include "util/latency_histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace iptool::util {
+
+namespace {
+
+constexpr uint64_t kFirstBucketNs = 100'000;
+
+size_t BucketIndex(uint64_t ns) {
+  if (ns <= kFirstBucketNs) {
+    return 0;
+  }
+  // 上界為 kFirstBucketNs * 2^i，取能容納 ns 的最小 i
+  const uint64_t scaled = (ns - 1) / kFirstBucketNs;
+  const auto index = static_cast<size_t>(std::bit_width(scaled));
+  return std::min(index, LatencyHistogram::kBucketCount - 1);
+}
+
+} // namespace
+
+double LatencyHistogram::BucketUpperMs(size_t index) {
+  if (index + 1 >= kBucketCount) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return static_cast<double>(kFirstBucketNs << index) / 1e6;
+}
+
+double LatencyHistogram::Snapshot::Percentile(double q) const {
+  if (count == 0) {
+    return 0;
+  }
+  const auto rank = static_cast<uint64_t>(q * static_cast<double>(count));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen > rank) {
+      // 不超過實際觀察到的最大值
+      return std::min(BucketUpperMs(i), max_ms);
+    }
+  }
+  return max_ms;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds elapsed) {
+  const auto ns = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+  buckets_[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+  uint64_t current = max_ns_.load(std::memory_order_relaxed);
+  while (ns > current &&
+         !max_ns_.compare_exchange_weak(
+             current, ns, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Read() const {
+  Snapshot snapshot;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.buckets[i];
+  }
+  snapshot.sum_ms =
+      static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) / 1e6;
+  snapshot.max_ms =
+      static_cast<double>(max_ns_.load(std::memory_order_relaxed)) / 1e6;
+  return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_ns_.store(0, std::memory_order_relaxed);
+  max_ns_.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram& LatencyRegistry::Get(std::string_view name) {
+  std::lock_guard lock(mutex_);
+  auto it = histograms_.find(name);
+  if (it == histograms_.end()) {
+    it = histograms_
+             .emplace(std::string(name), std::make_unique<LatencyHistogram>())
+             .first;
+  }
+  return *it->second;
+}
+
+void LatencyRegistry::ForEach(
+    const std::function<void(const std::string&, const LatencyHistogram&)>&
+        visit) const {
+  std::lock_guard lock(mutex_);
+  for (const auto& [name, histogram] : histograms_) {
+    visit(name, *histogram);
+  }
+}
+
+void LatencyRegistry::Reset() {
+  std::lock_guard lock(mutex_);
+  for (auto& [name, histogram] : histograms_) {
+    histogram->Reset();
+  }
+}
+
+} // namespace iptool::util
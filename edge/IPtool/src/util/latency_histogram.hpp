@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace iptool::util {
+
+/**
+ * 固定桶位的延遲直方圖，上界依 2 倍遞增（100us、200us ... 約 52 秒），
+ * 最後一格收集其餘樣本。Record 只做 relaxed atomic 加法，可由任意執行緒
+ * 同時呼叫。
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBucketCount = 21;
+
+  struct Snapshot {
+    uint64_t count = 0;
+    double sum_ms = 0;
+    double max_ms = 0;
+    std::array<uint64_t, kBucketCount> buckets{};
+
+    // 以桶位上界估計百分位數（q 介於 0 與 1），沒有樣本時為 0
+    double Percentile(double q) const;
+  };
+
+  // 第 i 格的上界（毫秒）；最後一格為無限大
+  static double BucketUpperMs(size_t index);
+
+  void Record(std::chrono::nanoseconds elapsed);
+  Snapshot Read() const;
+  void Reset();
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_ns_{0};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+// 依名稱建立直方圖；回傳的參考在 registry 存活期間有效
+class LatencyRegistry {
+ public:
+  LatencyHistogram& Get(std::string_view name);
+  void ForEach(
+      const std::function<void(const std::string&, const LatencyHistogram&)>&
+          visit) const;
+  void Reset();
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<LatencyHistogram>, std::less<>>
+      histograms_;
+};
+
+} // namespace iptool::util
@@ -1,13 +1,33 @@
 #include "logging.hpp"
 #include "time.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <thread>
+
+#include <unistd.h>
 
 namespace {
-std::mutex& LogMutex() {
-  static std::mutex mutex;
-  return mutex;
+
+int Severity(LogLevel level) {
+  switch (level) {
+    case LogLevel::Debug:
+      return 0;
+    case LogLevel::Info:
+      return 1;
+    case LogLevel::Warn:
+      return 2;
+    case LogLevel::Error:
+      return 3;
+  }
+  return 1;
 }
 
 std::string_view LevelTag(LogLevel level) {
@@ -25,24 +45,248 @@ std::string_view LevelTag(LogLevel level) {
   }
 }
 
-std::ostream& LevelStream(LogLevel level) {
-  if (level == LogLevel::Error) {
-    return std::cerr;
+int InitialSeverity() {
+  // 未設定時維持原本行為：debug build 輸出 LogDebug，release build 不輸出
+  const int fallback =
+      Severity(kDebugLogsEnabled ? LogLevel::Debug : LogLevel::Info);
+  const char* env = std::getenv("LOG_LEVEL");
+  if (!env) {
+    return fallback;
+  }
+  const std::string_view value(env);
+  if (value == "debug") {
+    return Severity(LogLevel::Debug);
+  }
+  if (value == "warn") {
+    return Severity(LogLevel::Warn);
+  }
+  if (value == "error") {
+    return Severity(LogLevel::Error);
+  }
+  if (value == "info") {
+    return Severity(LogLevel::Info);
   }
-  return std::cout;
+  return fallback;
 }
 
-std::string IsoTimestamp() {
-  return CurrentIsoTimestamp();
+std::atomic<int> g_min_severity{InitialSeverity()};
+
+void WriteAll(int fd, std::string_view data) {
+  while (!data.empty()) {
+    const ssize_t written = ::write(fd, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    data.remove_prefix(static_cast<size_t>(written));
+  }
+}
+
+/**
+ * 多生產者、單一消費者的固定大小環狀佇列（Vyukov bounded queue）。
+ * 生產者以 CAS 取得 slot 後直接寫入，不持有任何鎖；背景執行緒依序取出
+ * 並批次 write(2)，RPC 執行緒不會因磁碟或 pipe 變慢而被阻塞。
+ */
+class AsyncLogger {
+ public:
+  AsyncLogger() {
+    for (size_t i = 0; i < kCapacity; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer_ = std::jthread([this](std::stop_token stop) { Run(stop); });
+  }
+
+  ~AsyncLogger() {
+    writer_.request_stop();
+    Wake();
+    writer_.join();
+  }
+
+  void Push(LogLevel level, std::string_view message) {
+    const auto now = std::chrono::system_clock::now();
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+      slot = &slots_[pos & kMask];
+      const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // 佇列已滿：丟棄訊息，由背景執行緒回報丟棄數量
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->level = level;
+    slot->time = now;
+    slot->truncated = message.size() > slot->text.size();
+    slot->length = static_cast<uint16_t>(
+        std::min(message.size(), slot->text.size()));
+    std::memcpy(slot->text.data(), message.data(), slot->length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    Wake();
+  }
+
+  void Flush() {
+    const uint64_t target = enqueue_pos_.load(std::memory_order_acquire);
+    Wake();
+    uint64_t done = written_pos_.load(std::memory_order_acquire);
+    while (done < target) {
+      written_pos_.wait(done, std::memory_order_acquire);
+      done = written_pos_.load(std::memory_order_acquire);
+    }
+  }
+
+ private:
+  static constexpr size_t kCapacity = 1024;
+  static constexpr size_t kMask = kCapacity - 1;
+  static constexpr size_t kTextSize = 472;
+  // 批次寫出的緩衝區超過此大小即先寫出
+  static constexpr size_t kBatchBytes = 32 * 1024;
+  static_assert((kCapacity & kMask) == 0, "capacity must be a power of two");
+
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::chrono::system_clock::time_point time;
+    LogLevel level = LogLevel::Info;
+    bool truncated = false;
+    uint16_t length = 0;
+    std::array<char, kTextSize> text;
+  };
+
+  void Wake() {
+    wake_seq_.fetch_add(1, std::memory_order_release);
+    if (writer_waiting_.load(std::memory_order_seq_cst)) {
+      wake_seq_.notify_one();
+    }
+  }
+
+  void Append(const Slot& slot) {
+    std::string& out = slot.level == LogLevel::Error ? err_batch_ : out_batch_;
+    const auto tag = LevelTag(slot.level);
+    out.append(tag);
+    out.push_back(' ');
+    char timestamp[kIsoTimestampLength];
+    FormatIsoTimestamp(slot.time, timestamp);
+    out.append(timestamp, kIsoTimestampLength);
+    out.push_back(' ');
+    out.append(slot.text.data(), slot.length);
+    if (slot.truncated) {
+      out.append("...(truncated)");
+    }
+    out.push_back('\n');
+  }
+
+  void WriteBatches() {
+    if (!out_batch_.empty()) {
+      WriteAll(STDOUT_FILENO, out_batch_);
+      out_batch_.clear();
+    }
+    if (!err_batch_.empty()) {
+      WriteAll(STDERR_FILENO, err_batch_);
+      err_batch_.clear();
+    }
+  }
+
+  // 取出目前所有可讀的 slot，回傳處理的筆數
+  size_t Drain() {
+    size_t count = 0;
+    while (true) {
+      Slot& slot = slots_[dequeue_pos_ & kMask];
+      if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+        break;
+      }
+      Append(slot);
+      slot.sequence.store(dequeue_pos_ + kCapacity, std::memory_order_release);
+      ++dequeue_pos_;
+      ++count;
+      if (out_batch_.size() + err_batch_.size() >= kBatchBytes) {
+        WriteBatches();
+      }
+    }
+    if (const auto dropped = dropped_.exchange(0, std::memory_order_relaxed)) {
+      char timestamp[kIsoTimestampLength];
+      FormatIsoTimestamp(std::chrono::system_clock::now(), timestamp);
+      err_batch_.append("[WARN] ");
+      err_batch_.append(timestamp, kIsoTimestampLength);
+      err_batch_.append(" 日誌佇列已滿，丟棄 ");
+      err_batch_.append(std::to_string(dropped));
+      err_batch_.append(" 筆訊息\n");
+    }
+    WriteBatches();
+    written_pos_.store(dequeue_pos_, std::memory_order_release);
+    written_pos_.notify_all();
+    return count;
+  }
+
+  void Run(std::stop_token stop) {
+    out_batch_.reserve(kBatchBytes * 2);
+    err_batch_.reserve(kBatchBytes);
+    while (true) {
+      const uint32_t seen = wake_seq_.load(std::memory_order_acquire);
+      if (Drain() > 0) {
+        continue;
+      }
+      if (stop.stop_requested()) {
+        break;
+      }
+      writer_waiting_.store(true, std::memory_order_seq_cst);
+      wake_seq_.wait(seen, std::memory_order_acquire);
+      writer_waiting_.store(false, std::memory_order_relaxed);
+    }
+    Drain();
+  }
+
+  std::array<Slot, kCapacity> slots_;
+  alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+  alignas(64) std::atomic<uint32_t> wake_seq_{0};
+  std::atomic<bool> writer_waiting_{false};
+  std::atomic<uint64_t> dropped_{0};
+  alignas(64) std::atomic<uint64_t> written_pos_{0};
+  // 以下只由背景執行緒存取
+  uint64_t dequeue_pos_ = 0;
+  std::string out_batch_;
+  std::string err_batch_;
+  std::jthread writer_;
+};
+
+AsyncLogger& Logger() {
+  static AsyncLogger logger;
+  return logger;
 }
 
 } // namespace
 
+void SetMinLogLevel(LogLevel level) {
+  g_min_severity.store(Severity(level), std::memory_order_relaxed);
+}
+
+bool LogLevelEnabled(LogLevel level) {
+  if (level == LogLevel::Debug && !kDebugLogsEnabled) {
+    return false;
+  }
+  return Severity(level) >= g_min_severity.load(std::memory_order_relaxed);
+}
+
 void LogMessage(LogLevel level, std::string_view message) {
-  std::scoped_lock lock(LogMutex());
-  auto& stream = LevelStream(level);
-  stream << LevelTag(level) << ' ' << IsoTimestamp() << ' ' << message
-         << std::endl;
+  if (!LogLevelEnabled(level)) {
+    return;
+  }
+  Logger().Push(level, message);
+}
+
+void FlushLogs() {
+  Logger().Flush();
 }
 
 void LogInfo(std::string_view message) {
@@ -58,9 +302,5 @@ void LogError(std::string_view message) {
 }
 
 void LogDebug(std::string_view message) {
-  if constexpr (kDebugLogsEnabled) {
-    LogMessage(LogLevel::Debug, message);
-  } else {
-    (void)message;
-  }
+  LogMessage(LogLevel::Debug, message);
 }
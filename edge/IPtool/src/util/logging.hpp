@@ -1,9 +1,8 @@
 #pragma once
 
 #include <format>
-#include <mutex>
+#include <string>
 #include <string_view>
-#include <tuple>
 
 enum class LogLevel { Info, Warn, Error, Debug };
 
@@ -13,8 +12,21 @@ constexpr bool kDebugLogsEnabled = false;
 constexpr bool kDebugLogsEnabled = true;
 #endif
 
+// 執行期的最低輸出等級（Debug < Info < Warn < Error）；預設在 debug
+// build 為 Debug、release build 為 Info，可由環境變數
+// LOG_LEVEL=debug|info|warn|error 覆寫。服務本身只在啟動時讀取
+// LOG_LEVEL，沒有執行期調整的入口；SetMinLogLevel 供測試與嵌入此程式庫
+// 的程式使用。非 debug build 中 Debug 一律不輸出
+void SetMinLogLevel(LogLevel level);
+bool LogLevelEnabled(LogLevel level);
+
+// 將訊息放入佇列後立即返回，由背景執行緒批次寫出；佇列滿時丟棄訊息並
+// 計數，不會阻塞呼叫端
 void LogMessage(LogLevel level, std::string_view message);
 
+// 等待目前佇列中的訊息全部寫出
+void FlushLogs();
+
 void LogInfo(std::string_view message);
 void LogWarn(std::string_view message);
 void LogError(std::string_view message);
@@ -22,19 +34,19 @@ void LogDebug(std::string_view message);
 
 template <typename... Args>
 void LogFormat(LogLevel level, std::string_view fmt, Args&&... args) {
-  std::string formatted;
+  if (!LogLevelEnabled(level)) {
+    return;
+  }
+  // 每個執行緒重複使用同一個緩衝區，穩態下不需配置記憶體
+  thread_local std::string buffer;
+  buffer.clear();
   try {
-    auto args_pack = std::make_tuple(std::forward<Args>(args)...);
-    formatted = std::apply(
-        [&](auto&... inner) {
-          return std::vformat(
-              fmt, std::make_format_args<std::format_context>(inner...));
-        },
-        args_pack);
+    std::vformat_to(
+        std::back_inserter(buffer), fmt, std::make_format_args(args...));
   } catch (...) {
-    formatted = "[format-error]";
+    buffer = "[format-error]";
   }
-  LogMessage(level, formatted);
+  LogMessage(level, buffer);
 }
 
 template <typename... Args>
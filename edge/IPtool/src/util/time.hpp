@@ -1,5 +1,15 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <string>
 
+// "2025-01-01T08:00:00.000+08:00"
+inline constexpr size_t kIsoTimestampLength = 29;
+
+// 將時間格式化為 UTC+8 的 ISO 8601 字串寫入 out（不含結尾 '\0'）；
+// 秒以上的部分依執行緒快取，同一秒內只需格式化毫秒
+void FormatIsoTimestamp(
+    std::chrono::system_clock::time_point time, char* out);
+
 std::string CurrentIsoTimestamp();
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include "util/bounded_executor.hpp"
+
+using iptool::util::BoundedExecutor;
+using namespace std::chrono_literals;
+
+namespace {
+
+// 等到執行器回報 active 個工作正在執行
+void WaitActive(const BoundedExecutor& executor, uint32_t active) {
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (executor.stats().active < active &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+  }
+}
+
+} // namespace
+
+TEST(BoundedExecutorTest, RejectsWhenQueueIsFull) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> ran{0};
+  {
+    BoundedExecutor executor(1, 2);
+    ASSERT_TRUE(executor.TrySubmit([&] {
+      released.wait();
+      ++ran;
+    }));
+    WaitActive(executor, 1);
+
+    // 唯一的執行緒被佔用，佇列只容納兩個
+    EXPECT_TRUE(executor.TrySubmit([&] { ++ran; }));
+    EXPECT_TRUE(executor.TrySubmit([&] { ++ran; }));
+    EXPECT_FALSE(executor.TrySubmit([&] { ++ran; }));
+    EXPECT_FALSE(executor.TrySubmit([&] { ++ran; }));
+
+    const auto stats = executor.stats();
+    EXPECT_EQ(stats.threads, 1u);
+    EXPECT_EQ(stats.active, 1u);
+    EXPECT_EQ(stats.queued, 2u);
+    EXPECT_EQ(stats.rejected, 2u);
+    release.set_value();
+  }
+  // 解構會執行完已接受的工作，被拒絕的不會執行
+  EXPECT_EQ(ran.load(), 3);
+}
+
+TEST(BoundedExecutorTest, AcceptsAgainAfterQueueDrains) {
+  BoundedExecutor executor(2, 1);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  // 佇列只容納一個，逐一等待執行緒取走
+  for (uint32_t active = 1; active <= 2; ++active) {
+    EXPECT_TRUE(executor.TrySubmit([released] { released.wait(); }));
+    WaitActive(executor, active);
+  }
+  EXPECT_TRUE(executor.TrySubmit([] {}));
+  EXPECT_FALSE(executor.TrySubmit([] {}));
+  release.set_value();
+
+  std::promise<void> done;
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  bool accepted = false;
+  while (!accepted && std::chrono::steady_clock::now() < deadline) {
+    accepted = executor.TrySubmit([&done] { done.set_value(); });
+    if (!accepted) {
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+  ASSERT_TRUE(accepted);
+  EXPECT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+  EXPECT_EQ(executor.stats().rejected, 1u);
+}
+
+TEST(BoundedExecutorTest, ClampsZeroSizesToOne) {
+  BoundedExecutor executor(0, 0);
+  EXPECT_EQ(executor.stats().threads, 1u);
+  std::promise<void> done;
+  ASSERT_TRUE(executor.TrySubmit([&done] { done.set_value(); }));
+  EXPECT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+}
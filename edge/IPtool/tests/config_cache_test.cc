@@ -0,0 +1,281 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <net/if.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "network/config_cache.hpp"
+#include "network/netlink_monitor.hpp"
+#include "process/subprocess.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string Ip(std::initializer_list<std::string_view> args) {
+  std::vector<std::string_view> argv{"ip"};
+  argv.insert(argv.end(), args);
+  iptool::process::ProcessResult result;
+  if (!iptool::process::RunProcess(argv, {}, &result) ||
+      !result.Succeeded()) {
+    return std::string(result.ErrorOutput());
+  }
+  return {};
+}
+
+template <typename Predicate>
+bool WaitFor(Predicate done, std::chrono::milliseconds limit = 5s) {
+  const auto deadline = std::chrono::steady_clock::now() + limit;
+  while (!done()) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(5ms);
+  }
+  return true;
+}
+
+/**
+ * 在獨立的 network namespace 內建立 v0/v1 veth pair，並在 PATH 最前面
+ * 放一個假的 nmcli：把 v0 對應到手動設定的 profile，每次執行都記錄到
+ * log，用來確認哪些路徑會（或不會）執行 nmcli。
+ */
+class ConfigCacheNetns : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    if (::unshare(CLONE_NEWNET) != 0) {
+      skip_reason_ = std::string("無法建立 network namespace: ") +
+          std::strerror(errno);
+      return;
+    }
+    char dir_template[] = "/tmp/iptool-nmcli-XXXXXX";
+    if (!::mkdtemp(dir_template)) {
+      skip_reason_ = "無法建立暫存目錄";
+      return;
+    }
+    dir_ = dir_template;
+    log_path_ = dir_ + "/nmcli.log";
+    const std::string script = dir_ + "/nmcli";
+    std::ofstream(script) << "#!/bin/sh\n"
+                          << "echo \"$*\" >> " << log_path_ << "\n"
+                          << "case \"$*\" in\n"
+                          << "  *NAME,DEVICE*) echo 'test-v0:v0' ;;\n"
+                          << "  *ipv4.method,ipv4.dns*)\n"
+                          << "    echo 'ipv4.method:manual'\n"
+                          << "    echo 'ipv4.dns:10.9.0.53' ;;\n"
+                          << "  *) exit 1 ;;\n"
+                          << "esac\n";
+    ::chmod(script.c_str(), 0755);
+    const char* path = std::getenv("PATH");
+    ::setenv(
+        "PATH", (dir_ + ":" + (path ? path : "/usr/bin:/bin")).c_str(), 1);
+  }
+
+  static void TearDownTestSuite() {
+    if (!dir_.empty()) {
+      std::filesystem::remove_all(dir_);
+    }
+  }
+
+  void SetUp() override {
+    if (!skip_reason_.empty()) {
+      GTEST_SKIP() << skip_reason_
+                   << "（需要 CAP_NET_ADMIN，可用 unshare -rn 執行）";
+    }
+    for (const auto& error :
+         {Ip({"link", "add", "v0", "type", "veth", "peer", "name", "v1"}),
+          Ip({"link", "set", "v0", "up"}),
+          Ip({"link", "set", "v1", "up"}),
+          Ip({"addr", "add", "10.9.0.1/24", "dev", "v0"})}) {
+      ASSERT_TRUE(error.empty()) << error;
+    }
+    std::ofstream(log_path_, std::ios::trunc);
+  }
+
+  void TearDown() override {
+    if (skip_reason_.empty()) {
+      Ip({"link", "del", "v0"});
+    }
+  }
+
+  static int NmcliCalls() {
+    std::ifstream log(log_path_);
+    int lines = 0;
+    for (std::string line; std::getline(log, line);) {
+      ++lines;
+    }
+    return lines;
+  }
+
+  // 以 ip -batch 一次送出多個指令，讓事件在數毫秒內連續產生
+  static std::string IpBatch(const std::vector<std::string>& commands) {
+    const std::string path = dir_ + "/batch";
+    {
+      std::ofstream batch(path, std::ios::trunc);
+      for (const auto& command : commands) {
+        batch << command << '\n';
+      }
+    }
+    return Ip({"-batch", path});
+  }
+
+  static inline std::string skip_reason_;
+  static inline std::string dir_;
+  static inline std::string log_path_;
+};
+
+} // namespace
+
+TEST_F(ConfigCacheNetns, GetServesCachedSnapshotWithoutNmcli) {
+  NetworkConfigCache cache;
+  EXPECT_FALSE(cache.Peek("v0").has_value());
+
+  const auto first = cache.Get("v0");
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(first->config.ip_address, "10.9.0.1");
+  EXPECT_EQ(first->config.subnet_mask, "255.255.255.0");
+  EXPECT_EQ(first->config.dns, "10.9.0.53");
+  EXPECT_EQ(first->config.mode, iptool::NETWORK_MODE_MANUAL);
+  const int loads = NmcliCalls();
+  EXPECT_GT(loads, 0);
+
+  for (int i = 0; i < 5; ++i) {
+    const auto cached = cache.Get("v0");
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->version, first->version);
+  }
+  EXPECT_EQ(cache.Peek("v0")->version, first->version);
+  EXPECT_EQ(NmcliCalls(), loads);
+}
+
+TEST_F(ConfigCacheNetns, EventBurstIsMergedIntoOneUpdate) {
+  NetworkConfigCache cache;
+  cache.Start();
+  ASSERT_TRUE(cache.Get("v0").has_value());
+  const int loads = NmcliCalls();
+
+  std::atomic<int> notifications{0};
+  cache.Subscribe([&](const std::string& name) {
+    if (name == "v0") {
+      ++notifications;
+    }
+  });
+  // 位址、路由與 link 事件在同一個 100ms 視窗內
+  ASSERT_EQ(
+      IpBatch({
+          "address del 10.9.0.1/24 dev v0",
+          "address add 10.9.0.7/24 dev v0",
+          "route add default via 10.9.0.254 dev v0",
+          "link set v1 down",
+          "link set v1 up",
+      }),
+      "");
+
+  ASSERT_TRUE(WaitFor([&] { return notifications.load() > 0; }));
+  // 再等過一個視窗，確認沒有第二次更新
+  std::this_thread::sleep_for(300ms);
+  EXPECT_EQ(notifications.load(), 1);
+  const auto snapshot = cache.Peek("v0");
+  ASSERT_TRUE(snapshot.has_value());
+  EXPECT_EQ(snapshot->config.ip_address, "10.9.0.7");
+  EXPECT_EQ(snapshot->config.gateway, "10.9.0.254");
+  // kernel 事件只透過 netlink 更新，不執行 nmcli
+  EXPECT_EQ(NmcliCalls(), loads);
+}
+
+TEST_F(ConfigCacheNetns, ListenerMayUnsubscribeItselfDuringNotification) {
+  NetworkConfigCache cache;
+  std::atomic<int> calls{0};
+  uint64_t id = 0;
+  id = cache.Subscribe([&](const std::string&) {
+    ++calls;
+    cache.Unsubscribe(id);
+    // 回呼內新增訂閱也不能卡住
+    cache.Subscribe([](const std::string&) {});
+  });
+  ASSERT_TRUE(cache.Get("v0").has_value());
+  ASSERT_EQ(Ip({"link", "set", "v1", "down"}), "");
+  cache.Reload("v0");
+  EXPECT_EQ(calls.load(), 1);
+}
+
+TEST_F(ConfigCacheNetns, BufferOverflowTriggersFullResync) {
+  NetworkConfigCache cache;
+  cache.Start();
+  ASSERT_TRUE(cache.Get("v0").has_value());
+
+  // listener 在 monitor 執行緒上被呼叫；讓它停住，事件只能堆在 socket
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<bool> blocked{false};
+  std::atomic<bool> first{true};
+  cache.Subscribe([&](const std::string&) {
+    if (first.exchange(false)) {
+      blocked = true;
+      released.wait();
+    }
+  });
+  ASSERT_EQ(Ip({"link", "set", "v1", "down"}), "");
+  ASSERT_TRUE(WaitFor([&] { return blocked.load(); }));
+
+  // 先以 v1 上大量的位址事件塞滿接收緩衝區，v0 的變更排在最後而被丟棄，
+  // 只有 ENOBUFS 之後的完整重新讀取才會看到
+  std::vector<std::string> flood;
+  for (int i = 0; i < 3000; ++i) {
+    flood.push_back(
+        "address add 10.10." + std::to_string(i / 250) + "." +
+        std::to_string(i % 250 + 1) + "/32 dev v1");
+  }
+  flood.push_back("address del 10.9.0.1/24 dev v0");
+  flood.push_back("address add 10.9.0.9/24 dev v0");
+  ASSERT_EQ(IpBatch(flood), "");
+  release.set_value();
+
+  EXPECT_TRUE(WaitFor([&] {
+    const auto snapshot = cache.Peek("v0");
+    return snapshot && snapshot->config.ip_address == "10.9.0.9";
+  }));
+}
+
+TEST_F(ConfigCacheNetns, MonitorReportsAffectedIndexes) {
+  std::mutex mutex;
+  std::vector<std::vector<int>> calls;
+  iptool::netlink::NetlinkMonitor monitor(
+      [&](const std::vector<int>& indexes, bool /*full_resync*/) {
+        std::lock_guard lock(mutex);
+        calls.push_back(indexes);
+      });
+  ASSERT_TRUE(monitor.Start());
+  ASSERT_EQ(
+      IpBatch({"address add 10.9.0.2/24 dev v0", "link set v1 down"}), "");
+  ASSERT_TRUE(WaitFor([&] {
+    std::lock_guard lock(mutex);
+    return !calls.empty();
+  }));
+  std::this_thread::sleep_for(300ms);
+
+  std::lock_guard lock(mutex);
+  ASSERT_EQ(calls.size(), 1u);
+  const int v0 = static_cast<int>(::if_nametoindex("v0"));
+  const int v1 = static_cast<int>(::if_nametoindex("v1"));
+  EXPECT_NE(std::ranges::find(calls[0], v0), calls[0].end());
+  EXPECT_NE(std::ranges::find(calls[0], v1), calls[0].end());
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/latency_histogram.hpp"
+
+using iptool::util::LatencyHistogram;
+using iptool::util::LatencyRegistry;
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, BucketBoundsDoubleFrom100Us) {
+  EXPECT_DOUBLE_EQ(LatencyHistogram::BucketUpperMs(0), 0.1);
+  EXPECT_DOUBLE_EQ(LatencyHistogram::BucketUpperMs(1), 0.2);
+  EXPECT_DOUBLE_EQ(LatencyHistogram::BucketUpperMs(4), 1.6);
+  EXPECT_DOUBLE_EQ(
+      LatencyHistogram::BucketUpperMs(LatencyHistogram::kBucketCount - 2),
+      0.1 * (1 << (LatencyHistogram::kBucketCount - 2)));
+  EXPECT_TRUE(std::isinf(
+      LatencyHistogram::BucketUpperMs(LatencyHistogram::kBucketCount - 1)));
+}
+
+TEST(LatencyHistogramTest, SamplesLandInTheSmallestBucketThatHoldsThem) {
+  LatencyHistogram histogram;
+  histogram.Record(100us); // 剛好等於上界
+  histogram.Record(100us + 1ns);
+  histogram.Record(-5ms); // 負值視為 0
+  histogram.Record(1500us);
+  histogram.Record(std::chrono::hours(1)); // 超過所有上界
+
+  const auto snapshot = histogram.Read();
+  EXPECT_EQ(snapshot.count, 5u);
+  EXPECT_EQ(snapshot.buckets[0], 2u);
+  EXPECT_EQ(snapshot.buckets[1], 1u);
+  EXPECT_EQ(snapshot.buckets[4], 1u);
+  EXPECT_EQ(snapshot.buckets[LatencyHistogram::kBucketCount - 1], 1u);
+  EXPECT_DOUBLE_EQ(snapshot.max_ms, 3'600'000.0);
+  EXPECT_NEAR(snapshot.sum_ms, 0.1 + 0.100001 + 1.5 + 3'600'000.0, 1e-6);
+}
+
+TEST(LatencyHistogramTest, PercentilesUseBucketBoundsCappedByMax) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 90; ++i) {
+    histogram.Record(50us);
+  }
+  for (int i = 0; i < 9; ++i) {
+    histogram.Record(1500us);
+  }
+  histogram.Record(30ms);
+
+  const auto snapshot = histogram.Read();
+  EXPECT_DOUBLE_EQ(snapshot.Percentile(0.0), 0.1);
+  EXPECT_DOUBLE_EQ(snapshot.Percentile(0.5), 0.1);
+  // 第 90 個樣本之後落在 (0.8, 1.6] 這一格
+  EXPECT_DOUBLE_EQ(snapshot.Percentile(0.9), 1.6);
+  // 最後一筆的桶位上界為 51.2ms，以實際最大值 30ms 為限
+  EXPECT_DOUBLE_EQ(snapshot.Percentile(0.99), 30.0);
+  EXPECT_DOUBLE_EQ(snapshot.Percentile(1.0), 30.0);
+}
+
+TEST(LatencyHistogramTest, EmptyAndResetReportZero) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Read().Percentile(0.99), 0.0);
+  histogram.Record(10ms);
+  histogram.Reset();
+  const auto snapshot = histogram.Read();
+  EXPECT_EQ(snapshot.count, 0u);
+  EXPECT_EQ(snapshot.sum_ms, 0.0);
+  EXPECT_EQ(snapshot.max_ms, 0.0);
+  EXPECT_EQ(snapshot.Percentile(0.5), 0.0);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreAllCounted) {
+  LatencyHistogram histogram;
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 10'000;
+  {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&histogram, t] {
+        for (int i = 0; i < kPerThread; ++i) {
+          histogram.Record(std::chrono::microseconds(50 + t * 100));
+        }
+      });
+    }
+  }
+  const auto snapshot = histogram.Read();
+  EXPECT_EQ(snapshot.count, static_cast<uint64_t>(kThreads * kPerThread));
+  EXPECT_DOUBLE_EQ(snapshot.max_ms, 0.35);
+}
+
+TEST(LatencyRegistryTest, GetReturnsTheSameHistogramPerName) {
+  LatencyRegistry registry;
+  auto& first = registry.Get("nmcli");
+  EXPECT_EQ(&registry.Get("nmcli"), &first);
+  first.Record(1ms);
+  registry.Get("ip").Record(2ms);
+
+  std::vector<std::string> names;
+  registry.ForEach([&](const std::string& name, const LatencyHistogram& h) {
+    names.push_back(name);
+    EXPECT_EQ(h.Read().count, 1u);
+  });
+  EXPECT_EQ(names, (std::vector<std::string>{"ip", "nmcli"}));
+
+  registry.Reset();
+  EXPECT_EQ(first.Read().count, 0u);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "network/link_stats.hpp"
+#include "process/subprocess.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr int kDatagrams = 200;
+constexpr size_t kDatagramSize = 1000;
+
+// 以 ip(8) 設定測試用的 namespace，失敗時回傳錯誤輸出
+std::string Ip(std::initializer_list<std::string_view> args) {
+  std::vector<std::string_view> argv{"ip"};
+  argv.insert(argv.end(), args);
+  iptool::process::ProcessResult result;
+  if (!iptool::process::RunProcess(argv, {}, &result) ||
+      !result.Succeeded()) {
+    return std::string(result.ErrorOutput());
+  }
+  return {};
+}
+
+/**
+ * 每個測試在同一個獨立的 network namespace 內建立 v0/v1 veth pair，
+ * v0 設為 10.9.0.1/24，並以靜態 ARP 讓送往 10.9.0.2 的封包直接從 v0
+ * 送出、由 v1 收到，不依賴任何外部主機。
+ */
+class LinkStatsNetns : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    if (::unshare(CLONE_NEWNET) != 0) {
+      skip_reason_ = std::string("無法建立 network namespace: ") +
+          std::strerror(errno);
+    }
+  }
+
+  void SetUp() override {
+    if (!skip_reason_.empty()) {
+      GTEST_SKIP() << skip_reason_
+                   << "（需要 CAP_NET_ADMIN，可用 unshare -rn 執行）";
+    }
+    for (const auto& error :
+         {Ip({"link", "add", "v0", "type", "veth", "peer", "name", "v1"}),
+          Ip({"link", "set", "v0", "up"}),
+          Ip({"link", "set", "v1", "up"}),
+          Ip({"addr", "add", "10.9.0.1/24", "dev", "v0"}),
+          Ip({"neigh",
+              "add",
+              "10.9.0.2",
+              "lladdr",
+              "02:00:00:00:00:02",
+              "dev",
+              "v0"})}) {
+      ASSERT_TRUE(error.empty()) << error;
+    }
+  }
+
+  void TearDown() override {
+    if (skip_reason_.empty()) {
+      // 刪除 v0 會一併刪除 v1；已刪除時忽略錯誤
+      Ip({"link", "del", "v0"});
+    }
+  }
+
+  static void SendDatagrams() {
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(9);
+    ::inet_pton(AF_INET, "10.9.0.2", &destination.sin_addr);
+    const std::string payload(kDatagramSize, 'x');
+    for (int i = 0; i < kDatagrams; ++i) {
+      ASSERT_EQ(
+          ::sendto(
+              fd,
+              payload.data(),
+              payload.size(),
+              0,
+              reinterpret_cast<const sockaddr*>(&destination),
+              sizeof(destination)),
+          static_cast<ssize_t>(payload.size()));
+    }
+    ::close(fd);
+  }
+
+  static inline std::string skip_reason_;
+};
+
+} // namespace
+
+TEST_F(LinkStatsNetns, CountsTrafficOnBothEnds) {
+  LinkStatsSampler sampler({.sample_interval = 100ms, .history_size = 16});
+  sampler.Start();
+  SendDatagrams();
+  std::this_thread::sleep_for(350ms);
+
+  const auto sender = sampler.Get("v0", 0);
+  ASSERT_EQ(sender.size(), 1u);
+  EXPECT_TRUE(sender[0].link_up);
+  EXPECT_GE(sender[0].counters.tx_packets, uint64_t{kDatagrams});
+  // 每個封包另有 UDP/IP/Ethernet 標頭
+  EXPECT_GE(sender[0].counters.tx_bytes, uint64_t{kDatagrams} * kDatagramSize);
+  ASSERT_FALSE(sender[0].history.empty());
+  const auto peak = std::ranges::max(
+      sender[0].history, {}, &LinkRate::tx_bps);
+  EXPECT_GT(peak.tx_bps, 0.0);
+  EXPECT_GT(peak.tx_pps, 0.0);
+
+  const auto receiver = sampler.Get("v1", 0);
+  ASSERT_EQ(receiver.size(), 1u);
+  EXPECT_GE(receiver[0].counters.rx_packets, uint64_t{kDatagrams});
+}
+
+TEST_F(LinkStatsNetns, ListsInterfacesWithoutLoopback) {
+  LinkStatsSampler sampler({.sample_interval = 100ms, .history_size = 4});
+  sampler.Start();
+
+  const auto all = sampler.Get("", 0);
+  std::vector<std::string> names;
+  for (const auto& snapshot : all) {
+    names.push_back(snapshot.interface_name);
+  }
+  EXPECT_EQ(names, (std::vector<std::string>{"v0", "v1"}));
+  EXPECT_TRUE(sampler.Get("lo", 0).empty());
+}
+
+TEST_F(LinkStatsNetns, HistoryIsBoundedByTheRing) {
+  LinkStatsSampler sampler({.sample_interval = 100ms, .history_size = 4});
+  sampler.Start();
+  std::this_thread::sleep_for(750ms);
+
+  // 4 筆樣本可換算出 3 筆速率
+  const auto full = sampler.Get("v0", 0);
+  ASSERT_EQ(full.size(), 1u);
+  EXPECT_EQ(full[0].history.size(), 3u);
+  EXPECT_TRUE(std::ranges::is_sorted(full[0].history, {}, &LinkRate::time));
+
+  const auto limited = sampler.Get("v0", 2);
+  ASSERT_EQ(limited.size(), 1u);
+  ASSERT_EQ(limited[0].history.size(), 2u);
+  // 兩次 Get 之間可能多取樣一次，只要求限制後仍保留最新的速率
+  EXPECT_GE(limited[0].history.back().time, full[0].history.back().time);
+}
+
+TEST_F(LinkStatsNetns, ForgetsRemovedInterfaces) {
+  LinkStatsSampler sampler({.sample_interval = 100ms, .history_size = 4});
+  sampler.Start();
+  ASSERT_EQ(sampler.Get("v0", 0).size(), 1u);
+
+  ASSERT_EQ(Ip({"link", "del", "v0"}), "");
+  std::this_thread::sleep_for(300ms);
+  EXPECT_TRUE(sampler.Get("v0", 0).empty());
+  EXPECT_TRUE(sampler.Get("v1", 0).empty());
+}
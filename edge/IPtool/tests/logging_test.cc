@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <charconv>
+#include <cstdio>
+#include <future>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "util/logging.hpp"
+
+namespace {
+
+/**
+ * 把 stdout 或 stderr 暫時導向 pipe，背景執行緒收集寫出的內容。
+ * paused 為 true 時先不讀取，pipe 滿了之後日誌執行緒會卡在 write(2)。
+ */
+class FdCapture {
+ public:
+  explicit FdCapture(int fd, bool paused = false)
+      : fd_(fd), saved_(::dup(fd)) {
+    int ends[2];
+    EXPECT_EQ(::pipe2(ends, O_CLOEXEC), 0);
+    ::dup2(ends[1], fd_);
+    ::close(ends[1]);
+    read_end_ = ends[0];
+    if (!paused) {
+      resume_.set_value();
+    }
+    reader_ = std::jthread([this, resumed = resume_.get_future()] {
+      resumed.wait();
+      char buffer[4096];
+      ssize_t n;
+      while ((n = ::read(read_end_, buffer, sizeof(buffer))) > 0) {
+        data_.append(buffer, static_cast<size_t>(n));
+      }
+    });
+  }
+
+  ~FdCapture() { Finish(); }
+
+  void Resume() { resume_.set_value(); }
+
+  // 寫出佇列中的日誌後還原 fd，回傳收集到的內容
+  const std::string& Finish() {
+    if (saved_ >= 0) {
+      FlushLogs();
+      ::dup2(saved_, fd_);
+      ::close(saved_);
+      saved_ = -1;
+      reader_.join();
+      ::close(read_end_);
+    }
+    return data_;
+  }
+
+ private:
+  int fd_;
+  int saved_;
+  int read_end_ = -1;
+  std::promise<void> resume_;
+  std::string data_;
+  std::jthread reader_;
+};
+
+// 去掉 "[INFO] <時間> " 前綴，只留下訊息本文
+std::vector<std::string> Messages(std::string_view output) {
+  std::vector<std::string> messages;
+  while (!output.empty()) {
+    const auto newline = output.find('\n');
+    auto line = output.substr(0, newline);
+    output = newline == std::string_view::npos ? std::string_view{}
+                                               : output.substr(newline + 1);
+    const auto tag_end = line.find(' ');
+    const auto time_end = line.find(' ', tag_end + 1);
+    if (time_end != std::string_view::npos) {
+      messages.emplace_back(line.substr(time_end + 1));
+    }
+  }
+  return messages;
+}
+
+// 解析 "日誌佇列已滿，丟棄 N 筆訊息" 並加總
+uint64_t DroppedCount(std::string_view output) {
+  constexpr std::string_view kPrefix = "丟棄 ";
+  uint64_t total = 0;
+  for (auto pos = output.find(kPrefix); pos != std::string_view::npos;
+       pos = output.find(kPrefix, pos + 1)) {
+    const char* begin = output.data() + pos + kPrefix.size();
+    uint64_t value = 0;
+    std::from_chars(begin, output.data() + output.size(), value);
+    total += value;
+  }
+  return total;
+}
+
+} // namespace
+
+TEST(LoggingTest, EachThreadsMessagesKeepTheirOrder) {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 200;
+  FdCapture capture(STDOUT_FILENO);
+  {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([t] {
+        for (int i = 0; i < kPerThread; ++i) {
+          LogInfoFormat("t{} {}", t, i);
+        }
+      });
+    }
+  }
+  // FlushLogs 回傳時所有訊息都已寫出
+  const auto messages = Messages(capture.Finish());
+
+  std::map<int, int> next;
+  for (const auto& message : messages) {
+    int thread = -1;
+    int index = -1;
+    ASSERT_EQ(std::sscanf(message.c_str(), "t%d %d", &thread, &index), 2)
+        << message;
+    EXPECT_EQ(index, next[thread]) << "thread " << thread;
+    next[thread] = index + 1;
+  }
+  ASSERT_EQ(next.size(), static_cast<size_t>(kThreads));
+  for (const auto& [thread, count] : next) {
+    EXPECT_EQ(count, kPerThread) << "thread " << thread;
+  }
+}
+
+TEST(LoggingTest, OverflowIsDroppedAndCounted) {
+  constexpr int kMessages = 5000;
+  const std::string padding(300, 'x');
+  FdCapture errors(STDERR_FILENO);
+  FdCapture output(STDOUT_FILENO, /*paused=*/true);
+  // 沒有人讀取 stdout：pipe 滿後日誌執行緒停在 write(2)，佇列隨之填滿
+  for (int i = 0; i < kMessages; ++i) {
+    LogInfoFormat("{} {}", i, padding);
+  }
+  output.Resume();
+  const auto written = Messages(output.Finish());
+  const uint64_t dropped = DroppedCount(errors.Finish());
+
+  EXPECT_GT(dropped, 0u);
+  EXPECT_LT(written.size(), static_cast<size_t>(kMessages));
+  EXPECT_EQ(written.size() + dropped, static_cast<uint64_t>(kMessages));
+}
+
+TEST(LoggingTest, LevelsRouteAndFilter) {
+  FdCapture errors(STDERR_FILENO);
+  FdCapture output(STDOUT_FILENO);
+  SetMinLogLevel(LogLevel::Warn);
+  LogInfo("hidden info");
+  LogWarn("shown warn");
+  LogError("shown error");
+  SetMinLogLevel(LogLevel::Info);
+  LogInfo(std::string(1000, 'y'));
+
+  const auto out = Messages(output.Finish());
+  const auto err = Messages(errors.Finish());
+  ASSERT_EQ(out.size(), 2u);
+  EXPECT_EQ(out[0], "shown warn");
+  EXPECT_TRUE(out[1].ends_with("...(truncated)"));
+  EXPECT_LT(out[1].size(), 1000u);
+  EXPECT_EQ(err, std::vector<std::string>{"shown error"});
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "network/netlink_reader.hpp"
+#include "process/subprocess.hpp"
+
+using namespace iptool::netlink;
+
+namespace {
+
+// 以 ip(8) 設定測試用的 namespace，失敗時回傳錯誤輸出
+std::string Ip(std::initializer_list<std::string_view> args) {
+  std::vector<std::string_view> argv{"ip"};
+  argv.insert(argv.end(), args);
+  iptool::process::ProcessResult result;
+  if (!iptool::process::RunProcess(argv, {}, &result) ||
+      !result.Succeeded()) {
+    return std::string(result.ErrorOutput());
+  }
+  return {};
+}
+
+/**
+ * 在獨立的 network namespace 內建立 v0/v1 veth pair，v0 設為
+ * 10.9.0.1/24，直接以 rtnetlink 讀回並與 ip(8) 的設定比對。
+ */
+class NetlinkReaderNetns : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    if (::unshare(CLONE_NEWNET) != 0) {
+      skip_reason_ = std::string("無法建立 network namespace: ") +
+          std::strerror(errno);
+    }
+  }
+
+  void SetUp() override {
+    if (!skip_reason_.empty()) {
+      GTEST_SKIP() << skip_reason_
+                   << "（需要 CAP_NET_ADMIN，可用 unshare -rn 執行）";
+    }
+    for (const auto& error :
+         {Ip({"link", "add", "v0", "type", "veth", "peer", "name", "v1"}),
+          Ip({"link", "set", "v0", "up"}),
+          Ip({"link", "set", "v1", "up"}),
+          Ip({"addr", "add", "10.9.0.1/24", "dev", "v0"})}) {
+      ASSERT_TRUE(error.empty()) << error;
+    }
+  }
+
+  void TearDown() override {
+    if (skip_reason_.empty()) {
+      // 刪除 v0 會一併刪除 v1；已刪除時忽略錯誤
+      Ip({"link", "del", "v0"});
+    }
+  }
+
+  static inline std::string skip_reason_;
+};
+
+} // namespace
+
+TEST_F(NetlinkReaderNetns, ReadsAddressAndLinkState) {
+  const auto state = ReadInterfaceState("v0");
+  ASSERT_TRUE(state.has_value());
+  EXPECT_GT(state->index, 0);
+  EXPECT_TRUE(state->link_up);
+  EXPECT_EQ(state->ip_address, "10.9.0.1");
+  EXPECT_EQ(state->prefix_length, 24);
+  EXPECT_EQ(state->gateway, "");
+
+  // 對端關閉後 v0 失去 carrier
+  ASSERT_EQ(Ip({"link", "set", "v1", "down"}), "");
+  const auto down = ReadInterfaceState("v0");
+  ASSERT_TRUE(down.has_value());
+  EXPECT_FALSE(down->link_up);
+}
+
+TEST_F(NetlinkReaderNetns, SecondaryAddressesAreIgnored) {
+  ASSERT_EQ(Ip({"addr", "add", "10.9.0.5/24", "dev", "v0"}), "");
+  const auto state = ReadInterfaceState("v0");
+  ASSERT_TRUE(state.has_value());
+  EXPECT_EQ(state->ip_address, "10.9.0.1");
+}
+
+TEST_F(NetlinkReaderNetns, PicksLowestMetricDefaultGatewayOfTheInterface) {
+  ASSERT_EQ(
+      Ip({"route",
+          "add",
+          "default",
+          "via",
+          "10.9.0.254",
+          "dev",
+          "v0",
+          "metric",
+          "200"}),
+      "");
+  ASSERT_EQ(
+      Ip({"route",
+          "add",
+          "default",
+          "via",
+          "10.9.0.253",
+          "dev",
+          "v0",
+          "metric",
+          "100"}),
+      "");
+  // 其他介面的預設路由不影響 v0
+  ASSERT_EQ(Ip({"addr", "add", "10.8.0.1/24", "dev", "v1"}), "");
+  ASSERT_EQ(
+      Ip({"route",
+          "add",
+          "default",
+          "via",
+          "10.8.0.254",
+          "dev",
+          "v1",
+          "metric",
+          "10"}),
+      "");
+
+  const auto state = ReadInterfaceState("v0");
+  ASSERT_TRUE(state.has_value());
+  EXPECT_EQ(state->gateway, "10.9.0.253");
+  EXPECT_EQ(ReadInterfaceState("v1")->gateway, "10.8.0.254");
+}
+
+TEST_F(NetlinkReaderNetns, UnknownInterfaceIsNullopt) {
+  EXPECT_FALSE(ReadInterfaceState("missing0").has_value());
+  EXPECT_FALSE(ReadInterfaceState("").has_value());
+  EXPECT_FALSE(ReadInterfaceState("name-longer-than-ifnamsiz").has_value());
+}
+
+TEST_F(NetlinkReaderNetns, StaticNeighbourIsConfirmed) {
+  ASSERT_EQ(
+      Ip({"neigh",
+          "add",
+          "10.9.0.2",
+          "lladdr",
+          "02:00:00:00:00:02",
+          "dev",
+          "v0",
+          "nud",
+          "permanent"}),
+      "");
+  EXPECT_TRUE(IsNeighbourConfirmed("10.9.0.2"));
+  EXPECT_FALSE(IsNeighbourConfirmed("10.9.0.3"));
+  EXPECT_FALSE(IsNeighbourConfirmed("not-an-address"));
+}
+
+TEST_F(NetlinkReaderNetns, LargeDumpsReturnEveryInterface) {
+  // 回覆會跨越多個 datagram，每一個都要完整讀到
+  constexpr int kPairs = 40;
+  for (int i = 0; i < kPairs; ++i) {
+    const std::string a = "a" + std::to_string(i);
+    const std::string b = "b" + std::to_string(i);
+    ASSERT_EQ(Ip({"link", "add", a, "type", "veth", "peer", "name", b}), "");
+  }
+  const auto interfaces = ReadInterfaceCounters();
+  for (int i = 0; i < kPairs; ++i) {
+    for (const std::string name :
+         {"a" + std::to_string(i), "b" + std::to_string(i)}) {
+      EXPECT_TRUE(std::any_of(
+          interfaces.begin(),
+          interfaces.end(),
+          [&](const InterfaceCounters& entry) { return entry.name == name; }))
+          << name;
+    }
+  }
+  for (int i = 0; i < kPairs; ++i) {
+    Ip({"link", "del", "a" + std::to_string(i)});
+  }
+}
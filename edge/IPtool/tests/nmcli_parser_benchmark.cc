@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "network/nmcli_parser.hpp"
+
+using namespace iptool::nmcli;
+
+namespace {
+
+std::string Fixture(std::string_view name) {
+  std::ifstream file(std::string(NMCLI_FIXTURE_DIR "/") + std::string(name));
+  return {std::istreambuf_iterator<char>(file), {}};
+}
+
+void BM_ParseConfigOutput(benchmark::State& state) {
+  const std::string output = Fixture("connection_manual.txt");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ParseConfigOutput("eth0", output));
+  }
+}
+BENCHMARK(BM_ParseConfigOutput);
+
+void BM_ParseDeviceShowOutput(benchmark::State& state) {
+  const std::string output = Fixture("device_dhcp.txt");
+  NetworkConfigData data;
+  for (auto _ : state) {
+    // 與服務相同重複使用同一個 data，穩態下只沿用既有容量
+    data.dns.clear();
+    ParseDeviceShowOutput(output, &data);
+    benchmark::DoNotOptimize(data);
+  }
+}
+BENCHMARK(BM_ParseDeviceShowOutput);
+
+void BM_FindConnectionName(benchmark::State& state) {
+  const std::string output = Fixture("connection_list.txt");
+  std::string name;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FindConnectionName(output, "eth1", &name));
+  }
+}
+BENCHMARK(BM_FindConnectionName);
+
+void BM_MaskToPrefix(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(MaskToPrefix("255.255.240.0"));
+  }
+}
+BENCHMARK(BM_MaskToPrefix);
+
+} // namespace
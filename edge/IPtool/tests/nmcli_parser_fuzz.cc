@@ -0,0 +1,47 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+#include "network/nmcli_parser.hpp"
+
+using namespace iptool::nmcli;
+
+namespace {
+
+// 解析出的遮罩必定是合法遮罩
+void CheckMask(const std::string& mask) {
+  if (!mask.empty() && !MaskToPrefix(mask)) {
+    std::abort();
+  }
+}
+
+} // namespace
+
+// libFuzzer 進入點；以 fixtures/nmcli 作為初始語料
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  const std::string_view input(reinterpret_cast<const char*>(data), size);
+
+  const auto config = ParseConfigOutput("eth0", input);
+  CheckMask(config.subnet_mask);
+
+  NetworkConfigData device;
+  ParseDeviceShowOutput(input, &device);
+  CheckMask(device.subnet_mask);
+
+  std::string name;
+  if (FindConnectionName(input, "eth0", &name) &&
+      name.size() > input.size()) {
+    std::abort();
+  }
+
+  // 接受的遮罩（允許前導 0 等非標準寫法）必須能換回同一個前綴
+  if (const auto prefix = MaskToPrefix(input)) {
+    const auto mask = PrefixToMask(*prefix);
+    if (!mask || MaskToPrefix(*mask) != prefix) {
+      std::abort();
+    }
+  }
+  return 0;
+}
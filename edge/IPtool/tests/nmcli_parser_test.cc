@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "network/nmcli_parser.hpp"
+
+using namespace iptool::nmcli;
+
+namespace {
+
+// fixtures/nmcli 下為 nmcli -t（terse）的輸出：值中的 ':' 與 '\' 以 '\'
+// 跳脫、空值輸出為空字串，多值欄位以 "," 或 ", " 分隔
+std::string Fixture(std::string_view name) {
+  std::ifstream file(std::string(NMCLI_FIXTURE_DIR "/") + std::string(name));
+  EXPECT_TRUE(file.is_open()) << name;
+  return {std::istreambuf_iterator<char>(file), {}};
+}
+
+} // namespace
+
+TEST(NmcliMask, RoundTripsEveryPrefix) {
+  for (int prefix = 0; prefix <= 32; ++prefix) {
+    const auto mask = PrefixToMask(prefix);
+    ASSERT_TRUE(mask.has_value());
+    EXPECT_EQ(MaskToPrefix(*mask), prefix) << *mask;
+  }
+  EXPECT_FALSE(PrefixToMask(-1));
+  EXPECT_FALSE(PrefixToMask(33));
+}
+
+TEST(NmcliMask, RejectsMalformedMasks) {
+  for (const std::string_view mask :
+       {"255.0.255.0",
+        "255.255.255",
+        "256.0.0.0",
+        "255.255.255.0x",
+        "1.2.3.4.5",
+        "",
+        " 255.0.0.0",
+        "255..255.0"}) {
+    EXPECT_FALSE(MaskToPrefix(mask)) << mask;
+  }
+}
+
+TEST(NmcliConnectionList, FindsConnectionByDevice) {
+  const std::string output = Fixture("connection_list.txt");
+  std::string name;
+  ASSERT_TRUE(FindConnectionName(output, "eth0", &name));
+  EXPECT_EQ(name, "Wired connection 1");
+  ASSERT_TRUE(FindConnectionName(output, "docker0", &name));
+  EXPECT_EQ(name, "docker0");
+}
+
+TEST(NmcliConnectionList, UnescapesConnectionNames) {
+  const std::string output = Fixture("connection_list.txt");
+  std::string name;
+  ASSERT_TRUE(FindConnectionName(output, "eth1", &name));
+  EXPECT_EQ(name, "cam:uplink");
+  ASSERT_TRUE(FindConnectionName(output, "eth2", &name));
+  EXPECT_EQ(name, "back\\slash");
+}
+
+TEST(NmcliConnectionList, MissingDeviceLeavesNameUntouched) {
+  const std::string output = Fixture("connection_list.txt");
+  std::string name = "previous";
+  EXPECT_FALSE(FindConnectionName(output, "wlan0", &name));
+  EXPECT_EQ(name, "previous");
+}
+
+TEST(NmcliConnectionShow, ParsesManualProfile) {
+  const auto data =
+      ParseConfigOutput("eth0", Fixture("connection_manual.txt"));
+  EXPECT_EQ(data.interface_name, "eth0");
+  EXPECT_EQ(data.mode, iptool::NETWORK_MODE_MANUAL);
+  EXPECT_EQ(data.ip_address, "192.168.10.20");
+  EXPECT_EQ(data.subnet_mask, "255.255.255.0");
+  EXPECT_EQ(data.gateway, "192.168.10.1");
+  EXPECT_EQ(data.dns, "192.168.10.1");
+}
+
+TEST(NmcliConnectionShow, TakesFirstOfSeveralAddresses) {
+  const auto data =
+      ParseConfigOutput("eth0", Fixture("connection_manual_multi.txt"));
+  EXPECT_EQ(data.ip_address, "10.20.0.5");
+  EXPECT_EQ(data.subnet_mask, "255.255.0.0");
+  EXPECT_EQ(data.gateway, "10.20.0.1");
+  EXPECT_EQ(data.dns, "1.1.1.1");
+}
+
+TEST(NmcliConnectionShow, ParsesDhcpProfileWithEmptyValues) {
+  for (const std::string_view fixture :
+       {"connection_dhcp.txt", "connection_dhcp_short.txt"}) {
+    const auto data = ParseConfigOutput("eth0", Fixture(fixture));
+    EXPECT_EQ(data.mode, iptool::NETWORK_MODE_DHCP) << fixture;
+    EXPECT_TRUE(data.ip_address.empty()) << fixture;
+    EXPECT_TRUE(data.subnet_mask.empty()) << fixture;
+    EXPECT_TRUE(data.gateway.empty()) << fixture;
+    EXPECT_TRUE(data.dns.empty()) << fixture;
+  }
+}
+
+TEST(NmcliDeviceShow, ParsesLeaseAndJoinsDns) {
+  NetworkConfigData data;
+  ParseDeviceShowOutput(Fixture("device_dhcp.txt"), &data);
+  EXPECT_EQ(data.ip_address, "192.168.1.73");
+  EXPECT_EQ(data.subnet_mask, "255.255.255.0");
+  EXPECT_EQ(data.gateway, "192.168.1.1");
+  EXPECT_EQ(data.dns, "192.168.1.1;8.8.4.4");
+}
+
+TEST(NmcliDeviceShow, DownDeviceLeavesFieldsEmpty) {
+  NetworkConfigData data;
+  ParseDeviceShowOutput(Fixture("device_down.txt"), &data);
+  EXPECT_TRUE(data.ip_address.empty());
+  EXPECT_TRUE(data.subnet_mask.empty());
+  EXPECT_TRUE(data.gateway.empty());
+  EXPECT_TRUE(data.dns.empty());
+}
+
+TEST(NmcliParser, ToleratesMissingTrailingNewlineAndCrlf) {
+  const auto data = ParseConfigOutput(
+      "eth0",
+      "ipv4.method:manual\r\nipv4.addresses:10.0.0.2/8\r\n"
+      "ipv4.gateway:10.0.0.1");
+  EXPECT_EQ(data.mode, iptool::NETWORK_MODE_MANUAL);
+  EXPECT_EQ(data.ip_address, "10.0.0.2");
+  EXPECT_EQ(data.subnet_mask, "255.0.0.0");
+  EXPECT_EQ(data.gateway, "10.0.0.1");
+}
@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/network_service.hpp"
+#include "network/operation_queue.hpp"
+#include "process/subprocess.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+NetworkConfigData Manual(std::string interface_name, std::string ip) {
+  NetworkConfigData config;
+  config.interface_name = std::move(interface_name);
+  config.ip_address = std::move(ip);
+  config.subnet_mask = "255.255.255.0";
+  config.gateway = "192.168.1.1";
+  config.dns = "192.168.1.1";
+  config.mode = iptool::NETWORK_MODE_MANUAL;
+  return config;
+}
+
+/**
+ * 記錄每次套用的假 applier。hold() 之後的套用會停在 applier 內，直到
+ * release()，用來讓後續請求在佇列中等待。
+ */
+class FakeApplier {
+ public:
+  OperationResult operator()(const NetworkConfigData& target) {
+    std::unique_lock lock(mutex_);
+    applied_.push_back(target.ip_address);
+    entered_.notify_all();
+    released_.wait(lock, [this] { return !holding_; });
+    return {target.ip_address != "fail", "applied " + target.ip_address};
+  }
+
+  void hold() {
+    std::lock_guard lock(mutex_);
+    holding_ = true;
+  }
+
+  void release() {
+    {
+      std::lock_guard lock(mutex_);
+      holding_ = false;
+    }
+    released_.notify_all();
+  }
+
+  // 等到第 count 次套用開始
+  void WaitForApplies(size_t count) {
+    std::unique_lock lock(mutex_);
+    entered_.wait(lock, [&] { return applied_.size() >= count; });
+  }
+
+  std::vector<std::string> applied() {
+    std::lock_guard lock(mutex_);
+    return applied_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable entered_;
+  std::condition_variable released_;
+  bool holding_ = false;
+  std::vector<std::string> applied_;
+};
+
+class OperationQueueTest : public ::testing::Test {
+ protected:
+  OperationQueueTest()
+      : queue_(
+            [this](const NetworkConfigData& target) {
+              return applier_(target);
+            },
+            [this](const std::string&) { ++completions_; }) {}
+
+  std::optional<OperationStatus> WaitDone(uint64_t id) {
+    std::promise<std::optional<OperationStatus>> done;
+    auto future = done.get_future();
+    queue_.NotifyWhenDone(
+        id, [&done](const std::optional<OperationStatus>& status) {
+          done.set_value(status);
+        });
+    EXPECT_EQ(future.wait_for(5s), std::future_status::ready);
+    return future.get();
+  }
+
+  FakeApplier applier_;
+  std::atomic<int> completions_{0};
+  NetworkOperationQueue queue_;
+};
+
+} // namespace
+
+TEST_F(OperationQueueTest, IdsIncreaseAcrossInterfaces) {
+  const uint64_t first = queue_.Submit(Manual("eth0", "10.0.0.1"));
+  const uint64_t second = queue_.Submit(Manual("eth1", "10.0.1.1"));
+  const uint64_t third = queue_.Submit(Manual("eth0", "10.0.0.2"));
+  EXPECT_LT(first, second);
+  EXPECT_LT(second, third);
+
+  for (const uint64_t id : {first, second, third}) {
+    const auto status = WaitDone(id);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(status->id, id);
+    EXPECT_TRUE(status->finished());
+  }
+  EXPECT_EQ(queue_.Status(second)->interface_name, "eth1");
+}
+
+TEST_F(OperationQueueTest, PendingChangesAreMergedIntoTheLatest) {
+  applier_.hold();
+  const uint64_t running = queue_.Submit(Manual("eth0", "10.0.0.1"));
+  applier_.WaitForApplies(1);
+  EXPECT_EQ(queue_.Status(running)->state, OperationState::kRunning);
+
+  // 第一個仍在執行，後面三個只會套用最後一個
+  const uint64_t a = queue_.Submit(Manual("eth0", "10.0.0.2"));
+  const uint64_t b = queue_.Submit(Manual("eth0", "10.0.0.3"));
+  const uint64_t latest = queue_.Submit(Manual("eth0", "10.0.0.4"));
+  EXPECT_EQ(queue_.Status(a)->state, OperationState::kPending);
+  applier_.release();
+
+  const auto done = WaitDone(latest);
+  ASSERT_TRUE(done.has_value());
+  EXPECT_EQ(done->state, OperationState::kSucceeded);
+  EXPECT_EQ(done->merged_into, 0u);
+  for (const uint64_t id : {a, b}) {
+    const auto merged = WaitDone(id);
+    ASSERT_TRUE(merged.has_value());
+    EXPECT_EQ(merged->merged_into, latest);
+    EXPECT_EQ(merged->state, OperationState::kSucceeded);
+    EXPECT_EQ(merged->result.message, "applied 10.0.0.4");
+  }
+  EXPECT_EQ(
+      applier_.applied(),
+      (std::vector<std::string>{"10.0.0.1", "10.0.0.4"}));
+  EXPECT_EQ(completions_.load(), 2);
+}
+
+TEST_F(OperationQueueTest, FailureIsReportedToMergedOperations) {
+  applier_.hold();
+  queue_.Submit(Manual("eth0", "10.0.0.1"));
+  applier_.WaitForApplies(1);
+  const uint64_t merged = queue_.Submit(Manual("eth0", "10.0.0.2"));
+  const uint64_t failing = queue_.Submit(Manual("eth0", "fail"));
+  applier_.release();
+
+  const auto status = WaitDone(merged);
+  ASSERT_TRUE(status.has_value());
+  EXPECT_EQ(status->merged_into, failing);
+  EXPECT_EQ(status->state, OperationState::kFailed);
+  EXPECT_FALSE(status->result.success);
+}
+
+TEST_F(OperationQueueTest, NotifyWhenDoneRunsImmediatelyWhenFinished) {
+  const uint64_t id = queue_.Submit(Manual("eth0", "10.0.0.1"));
+  ASSERT_TRUE(WaitDone(id).has_value());
+
+  bool called = false;
+  queue_.NotifyWhenDone(id, [&](const std::optional<OperationStatus>& s) {
+    called = s.has_value() && s->state == OperationState::kSucceeded;
+  });
+  EXPECT_TRUE(called);
+
+  bool unknown = false;
+  queue_.NotifyWhenDone(id + 100, [&](const std::optional<OperationStatus>& s) {
+    unknown = !s.has_value();
+  });
+  EXPECT_TRUE(unknown);
+}
+
+TEST_F(OperationQueueTest, CancelledWaitersSkipPendingApply) {
+  applier_.hold();
+  queue_.Submit(Manual("eth0", "10.0.0.1"));
+  applier_.WaitForApplies(1);
+  auto cancel = std::make_shared<std::atomic<bool>>(false);
+  const uint64_t waiting = queue_.Submit(Manual("eth0", "10.0.0.2"), cancel);
+  cancel->store(true);
+  applier_.release();
+
+  const auto status = WaitDone(waiting);
+  ASSERT_TRUE(status.has_value());
+  EXPECT_EQ(status->state, OperationState::kAborted);
+  EXPECT_EQ(applier_.applied(), std::vector<std::string>{"10.0.0.1"});
+}
+
+TEST_F(OperationQueueTest, DetachedSubmitterKeepsMergedApply) {
+  applier_.hold();
+  queue_.Submit(Manual("eth0", "10.0.0.1"));
+  applier_.WaitForApplies(1);
+  auto cancel = std::make_shared<std::atomic<bool>>(true);
+  const uint64_t cancelled = queue_.Submit(Manual("eth0", "10.0.0.2"), cancel);
+  // no_wait 的請求合併進來後，即使先前的呼叫端已取消仍要套用
+  const uint64_t detached = queue_.Submit(Manual("eth0", "10.0.0.3"));
+  applier_.release();
+
+  const auto status = WaitDone(cancelled);
+  ASSERT_TRUE(status.has_value());
+  EXPECT_EQ(status->merged_into, detached);
+  EXPECT_EQ(status->state, OperationState::kSucceeded);
+  EXPECT_EQ(
+      applier_.applied(),
+      (std::vector<std::string>{"10.0.0.1", "10.0.0.3"}));
+}
+
+TEST(OperationQueueCancel, RunningApplySeesCallerCancellation) {
+  using iptool::process::ScopedCancellation;
+  std::promise<void> started;
+  NetworkOperationQueue queue(
+      [&](const NetworkConfigData&) -> OperationResult {
+        started.set_value();
+        // 模擬 RunProcess：定期檢查目前執行緒的取消範圍
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (std::chrono::steady_clock::now() < deadline) {
+          const auto* scope = ScopedCancellation::Current();
+          if (scope && scope->cancelled()) {
+            return {false, "canceled"};
+          }
+          std::this_thread::sleep_for(1ms);
+        }
+        return {true, "not canceled"};
+      },
+      [](const std::string&) {});
+  auto first = std::make_shared<std::atomic<bool>>(false);
+  const uint64_t id = queue.Submit(Manual("eth0", "10.0.0.1"), first);
+  started.get_future().wait();
+
+  std::promise<std::optional<OperationStatus>> done;
+  auto future = done.get_future();
+  queue.NotifyWhenDone(id, [&](const std::optional<OperationStatus>& status) {
+    done.set_value(status);
+  });
+  first->store(true);
+  ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+  const auto status = future.get();
+  ASSERT_TRUE(status.has_value());
+  EXPECT_EQ(status->state, OperationState::kFailed);
+  EXPECT_EQ(status->result.message, "canceled");
+}
+
+TEST(OperationQueueShutdown, PendingOperationsAreAbortedAndNotified) {
+  FakeApplier applier;
+  auto queue = std::make_unique<NetworkOperationQueue>(
+      [&](const NetworkConfigData& target) { return applier(target); },
+      [](const std::string&) {});
+  applier.hold();
+  const uint64_t running = queue->Submit(Manual("eth0", "10.0.0.1"));
+  applier.WaitForApplies(1);
+  const uint64_t pending = queue->Submit(Manual("eth0", "10.0.0.2"));
+
+  std::promise<std::optional<OperationStatus>> aborted;
+  auto aborted_future = aborted.get_future();
+  queue->NotifyWhenDone(
+      pending, [&](const std::optional<OperationStatus>& status) {
+        aborted.set_value(status);
+      });
+  std::promise<std::optional<OperationStatus>> finished;
+  auto finished_future = finished.get_future();
+  queue->NotifyWhenDone(
+      running, [&](const std::optional<OperationStatus>& status) {
+        finished.set_value(status);
+      });
+
+  // 解構會等待執行中的套用；未開始的操作必須在那之前就收到通知
+  std::jthread destroyer([&] { queue.reset(); });
+  ASSERT_EQ(aborted_future.wait_for(5s), std::future_status::ready);
+  const auto status = aborted_future.get();
+  ASSERT_TRUE(status.has_value());
+  EXPECT_EQ(status->state, OperationState::kAborted);
+  EXPECT_FALSE(status->result.success);
+
+  applier.release();
+  destroyer.join();
+  ASSERT_EQ(finished_future.wait_for(0s), std::future_status::ready);
+  EXPECT_EQ(finished_future.get()->state, OperationState::kSucceeded);
+  EXPECT_EQ(applier.applied(), std::vector<std::string>{"10.0.0.1"});
+}
+
+TEST(NetworkServiceMatch, ManualConfigMatchesOnlyWhenLiveAndIdentical) {
+  const NetworkConfigData target = Manual("eth0", "192.168.1.20");
+  NetworkConfigData live = target;
+  live.link_up = true;
+  EXPECT_TRUE(NetworkService::MatchesManualConfig(live, target));
+
+  NetworkConfigData down = live;
+  down.link_up = false;
+  EXPECT_FALSE(NetworkService::MatchesManualConfig(down, target));
+
+  NetworkConfigData dhcp = live;
+  dhcp.mode = iptool::NETWORK_MODE_DHCP;
+  EXPECT_FALSE(NetworkService::MatchesManualConfig(dhcp, target));
+
+  NetworkConfigData other_dns = live;
+  other_dns.dns = "8.8.8.8";
+  EXPECT_FALSE(NetworkService::MatchesManualConfig(other_dns, target));
+}
+
+TEST(NetworkServiceMatch, DhcpLeaseRequiresAddressAndLink) {
+  NetworkConfigData live;
+  live.interface_name = "eth0";
+  live.mode = iptool::NETWORK_MODE_DHCP;
+  live.link_up = true;
+  EXPECT_FALSE(NetworkService::HasDhcpLease(live));
+  live.ip_address = "192.168.1.73";
+  EXPECT_TRUE(NetworkService::HasDhcpLease(live));
+  live.link_up = false;
+  EXPECT_FALSE(NetworkService::HasDhcpLease(live));
+}
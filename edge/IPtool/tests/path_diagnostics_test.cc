@@ -0,0 +1,294 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "network/path_diagnostics.hpp"
+#include "process/subprocess.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+DiagnosticsOptions FastOptions() {
+  DiagnosticsOptions options;
+  options.attempts = 3;
+  options.timeout = 200ms;
+  options.interval = 20ms;
+  return options;
+}
+
+ProbeTarget Target(ProbeKind kind, std::string host, uint16_t port) {
+  return ProbeTarget{kind, std::move(host), port};
+}
+
+int BindLoopback(int type, uint16_t* port) {
+  const int fd = ::socket(AF_INET, type | SOCK_CLOEXEC, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  if (fd < 0 ||
+      ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+          0 ||
+      ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) !=
+          0) {
+    ADD_FAILURE() << "無法綁定 loopback socket: " << std::strerror(errno);
+  }
+  *port = ntohs(address.sin_port);
+  return fd;
+}
+
+// 單播 DNS stand-in：把查詢原樣送回並設定 QR；wrong_id 時改掉 ID
+class DnsResponder {
+ public:
+  explicit DnsResponder(bool wrong_id = false) : wrong_id_(wrong_id) {
+    fd_ = BindLoopback(SOCK_DGRAM, &port_);
+    thread_ = std::jthread([this](std::stop_token stop) { Serve(stop); });
+  }
+  ~DnsResponder() {
+    thread_.request_stop();
+    thread_.join();
+    ::close(fd_);
+  }
+
+  uint16_t port() const {
+    return port_;
+  }
+
+ private:
+  void Serve(std::stop_token stop) {
+    std::array<uint8_t, 512> buffer;
+    while (!stop.stop_requested()) {
+      pollfd entry{fd_, POLLIN, 0};
+      if (::poll(&entry, 1, 10) <= 0) {
+        continue;
+      }
+      sockaddr_in source{};
+      socklen_t length = sizeof(source);
+      const ssize_t received = ::recvfrom(
+          fd_,
+          buffer.data(),
+          buffer.size(),
+          0,
+          reinterpret_cast<sockaddr*>(&source),
+          &length);
+      if (received < 12) {
+        continue;
+      }
+      buffer[2] |= 0x80; // QR
+      if (wrong_id_) {
+        buffer[0] ^= 0xff;
+      }
+      ::sendto(
+          fd_,
+          buffer.data(),
+          static_cast<size_t>(received),
+          0,
+          reinterpret_cast<sockaddr*>(&source),
+          length);
+    }
+  }
+
+  bool wrong_id_;
+  int fd_ = -1;
+  uint16_t port_ = 0;
+  std::jthread thread_;
+};
+
+std::string Ip(std::initializer_list<std::string_view> args) {
+  std::vector<std::string_view> argv{"ip"};
+  argv.insert(argv.end(), args);
+  iptool::process::ProcessResult result;
+  if (!iptool::process::RunProcess(argv, {}, &result) ||
+      !result.Succeeded()) {
+    return std::string(result.ErrorOutput());
+  }
+  return {};
+}
+
+} // namespace
+
+TEST(ParseProbeEndpoint, AcceptsHostAndOptionalPort) {
+  const auto plain = ParseProbeEndpoint("192.168.1.1", ProbeKind::kGateway, 80);
+  ASSERT_TRUE(plain.has_value());
+  EXPECT_EQ(plain->host, "192.168.1.1");
+  EXPECT_EQ(plain->port, 80);
+
+  const auto with_port =
+      ParseProbeEndpoint(" 10.0.0.8:8554 ", ProbeKind::kCamera, 554);
+  ASSERT_TRUE(with_port.has_value());
+  EXPECT_EQ(with_port->host, "10.0.0.8");
+  EXPECT_EQ(with_port->port, 8554);
+
+  EXPECT_FALSE(ParseProbeEndpoint("camera.local", ProbeKind::kCamera, 554));
+  EXPECT_FALSE(ParseProbeEndpoint("10.0.0.8:0", ProbeKind::kCamera, 554));
+  EXPECT_FALSE(ParseProbeEndpoint("10.0.0.8:70000", ProbeKind::kCamera, 554));
+}
+
+TEST(BuildConfigTargets, SplitsDnsServers) {
+  const auto targets =
+      BuildConfigTargets("192.168.1.1", "8.8.8.8; 1.1.1.1,bad", 80);
+  ASSERT_EQ(targets.size(), 3u);
+  EXPECT_EQ(targets[0].kind, ProbeKind::kGateway);
+  EXPECT_EQ(targets[1].host, "8.8.8.8");
+  EXPECT_EQ(targets[1].port, kDefaultDnsPort);
+  EXPECT_EQ(targets[2].host, "1.1.1.1");
+}
+
+TEST(RunPathDiagnostics, TcpCountsHandshakeAndReset) {
+  uint16_t open_port = 0;
+  const int listener = BindLoopback(SOCK_STREAM, &open_port);
+  ASSERT_EQ(::listen(listener, 16), 0);
+  // 關閉後該埠不再有 listener，connect 會收到 RST
+  uint16_t closed_port = 0;
+  ::close(BindLoopback(SOCK_STREAM, &closed_port));
+
+  const std::vector<ProbeTarget> targets{
+      Target(ProbeKind::kCamera, "127.0.0.1", open_port),
+      Target(ProbeKind::kCamera, "127.0.0.1", closed_port)};
+  const auto results = RunPathDiagnostics(targets, FastOptions());
+  ::close(listener);
+
+  ASSERT_EQ(results.size(), 2u);
+  for (const auto& stats : results) {
+    EXPECT_EQ(stats.sent, 3u);
+    EXPECT_EQ(stats.received, 3u);
+    EXPECT_EQ(stats.loss_ratio(), 0.0);
+    EXPECT_LE(stats.min_ms, stats.avg_ms);
+    EXPECT_LE(stats.avg_ms, stats.max_ms);
+    EXPECT_TRUE(stats.reachable());
+  }
+}
+
+TEST(RunPathDiagnostics, DnsRequiresMatchingId) {
+  DnsResponder good;
+  DnsResponder forged(/*wrong_id=*/true);
+  uint16_t silent_port = 0;
+  const int silent = BindLoopback(SOCK_DGRAM, &silent_port);
+
+  const std::vector<ProbeTarget> targets{
+      Target(ProbeKind::kDns, "127.0.0.1", good.port()),
+      Target(ProbeKind::kDns, "127.0.0.1", forged.port()),
+      Target(ProbeKind::kDns, "127.0.0.1", silent_port)};
+  const auto results = RunPathDiagnostics(targets, FastOptions());
+  ::close(silent);
+
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[0].received, 3u);
+  EXPECT_TRUE(results[0].reachable());
+  for (size_t i = 1; i < results.size(); ++i) {
+    EXPECT_EQ(results[i].sent, 3u);
+    EXPECT_EQ(results[i].received, 0u);
+    EXPECT_EQ(results[i].loss_ratio(), 1.0);
+    EXPECT_FALSE(results[i].reachable());
+  }
+}
+
+TEST(RunPathDiagnostics, CancelStopsBeforeAllAttempts) {
+  uint16_t silent_port = 0;
+  const int silent = BindLoopback(SOCK_DGRAM, &silent_port);
+  DiagnosticsOptions options = FastOptions();
+  options.attempts = 10;
+  options.timeout = 1s;
+
+  const auto started = std::chrono::steady_clock::now();
+  const auto deadline = started + 150ms;
+  const auto results = RunPathDiagnostics(
+      std::vector<ProbeTarget>{
+          Target(ProbeKind::kDns, "127.0.0.1", silent_port)},
+      options,
+      [&] { return std::chrono::steady_clock::now() >= deadline; });
+  ::close(silent);
+
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].sent, 1u);
+  EXPECT_LT(std::chrono::steady_clock::now() - started, 500ms);
+}
+
+/**
+ * gateway 位於另一個 network namespace，回覆 ARP 但以 blackhole 路由
+ * 丟棄所有回程的 TCP 封包，模擬不回應 TCP/80 的路由器。需要
+ * CAP_NET_ADMIN，否則跳過。
+ */
+class GatewayNetns : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    if (::unshare(CLONE_NEWNET) != 0) {
+      skip_reason_ = std::string("無法建立 network namespace: ") +
+          std::strerror(errno);
+    }
+  }
+
+  void SetUp() override {
+    if (!skip_reason_.empty()) {
+      GTEST_SKIP() << skip_reason_;
+    }
+    peer_ = "iptool-test-gw-" + std::to_string(::getpid());
+    for (const auto& error :
+         {Ip({"netns", "add", peer_}),
+          Ip({"link", "add", "v0", "type", "veth", "peer", "name", "v1"}),
+          Ip({"link", "set", "v1", "netns", peer_}),
+          Ip({"link", "set", "v0", "up"}),
+          Ip({"addr", "add", "10.9.0.1/24", "dev", "v0"}),
+          Ip({"-n", peer_, "link", "set", "v1", "up"}),
+          Ip({"-n", peer_, "addr", "add", "10.9.0.2/24", "dev", "v1"}),
+          Ip({"-n", peer_, "route", "add", "blackhole", "10.9.0.1/32"})}) {
+      ASSERT_TRUE(error.empty()) << error;
+    }
+  }
+
+  void TearDown() override {
+    if (!peer_.empty()) {
+      Ip({"link", "del", "v0"});
+      Ip({"netns", "del", peer_});
+    }
+  }
+
+  static inline std::string skip_reason_;
+  std::string peer_;
+};
+
+TEST_F(GatewayNetns, ArpReplyCountsWhenTcpIsDropped) {
+  DiagnosticsOptions options = FastOptions();
+  options.attempts = 2;
+  const auto results = RunPathDiagnostics(
+      std::vector<ProbeTarget>{Target(
+          ProbeKind::kGateway, "10.9.0.2", kDefaultGatewayProbePort)},
+      options);
+
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].received, 0u);
+  EXPECT_EQ(results[0].loss_ratio(), 1.0);
+  EXPECT_TRUE(results[0].arp_resolved);
+  EXPECT_TRUE(results[0].reachable());
+}
+
+TEST_F(GatewayNetns, MissingGatewayIsUnreachable) {
+  DiagnosticsOptions options = FastOptions();
+  options.attempts = 2;
+  const auto results = RunPathDiagnostics(
+      std::vector<ProbeTarget>{Target(
+          ProbeKind::kGateway, "10.9.0.3", kDefaultGatewayProbePort)},
+      options);
+
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].received, 0u);
+  EXPECT_FALSE(results[0].arp_resolved);
+  EXPECT_FALSE(results[0].reachable());
+}
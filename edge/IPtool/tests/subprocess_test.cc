@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <thread>
+
+#include "process/subprocess.hpp"
+
+using namespace iptool::process;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+ProcessOptions WithTimeout(std::chrono::milliseconds timeout) {
+  ProcessOptions options;
+  options.timeout = timeout;
+  return options;
+}
+
+} // namespace
+
+TEST(SubprocessTest, CapturesExitCodeAndOutput) {
+  ProcessResult result;
+  ASSERT_TRUE(RunProcess(
+      {"sh", "-c", "echo out; echo err >&2; exit 3"}, {}, &result));
+  EXPECT_EQ(result.exit_code, 3);
+  EXPECT_EQ(result.stdout_data, "out\n");
+  EXPECT_EQ(result.stderr_data, "err\n");
+  EXPECT_FALSE(result.Succeeded());
+  EXPECT_EQ(result.ErrorOutput(), "err\n");
+}
+
+TEST(SubprocessTest, TimeoutKillsTheChild) {
+  ProcessResult result;
+  const auto started = Clock::now();
+  ASSERT_TRUE(RunProcess({"sleep", "5"}, WithTimeout(100ms), &result));
+  EXPECT_LT(Clock::now() - started, 2s);
+  EXPECT_TRUE(result.timed_out);
+  EXPECT_EQ(result.term_signal, SIGKILL);
+  EXPECT_FALSE(result.Succeeded());
+}
+
+TEST(SubprocessTest, TimeoutAppliesAfterOutputIsClosed) {
+  // 關閉 stdout/stderr 後才開始等待，走等待行程結束的路徑
+  ProcessResult result;
+  const auto started = Clock::now();
+  ASSERT_TRUE(RunProcess(
+      {"sh", "-c", "exec >&- 2>&-; sleep 5"}, WithTimeout(100ms), &result));
+  EXPECT_LT(Clock::now() - started, 2s);
+  EXPECT_TRUE(result.timed_out);
+  EXPECT_EQ(result.term_signal, SIGKILL);
+}
+
+TEST(SubprocessTest, ExitAfterOutputIsClosedIsSeenPromptly) {
+  ProcessResult result;
+  const auto started = Clock::now();
+  ASSERT_TRUE(RunProcess(
+      {"sh", "-c", "exec >&- 2>&-; sleep 0.2; exit 4"},
+      WithTimeout(10s),
+      &result));
+  EXPECT_LT(Clock::now() - started, 2s);
+  EXPECT_FALSE(result.timed_out);
+  EXPECT_EQ(result.exit_code, 4);
+}
+
+TEST(SubprocessTest, ScopedCancellationAbortsRunningChild) {
+  std::atomic<bool> cancel{false};
+  std::jthread canceller([&] {
+    std::this_thread::sleep_for(100ms);
+    cancel = true;
+  });
+  ProcessResult result;
+  const auto started = Clock::now();
+  {
+    ScopedCancellation scope(&cancel);
+    ASSERT_TRUE(RunProcess({"sleep", "5"}, WithTimeout(10s), &result));
+  }
+  EXPECT_LT(Clock::now() - started, 2s);
+  EXPECT_TRUE(result.canceled);
+  EXPECT_FALSE(result.timed_out);
+  EXPECT_EQ(ScopedCancellation::Current(), nullptr);
+}
+
+TEST(SubprocessTest, PredicateCancellationAfterOutputIsClosed) {
+  const auto cancel_at = Clock::now() + 100ms;
+  ProcessResult result;
+  ScopedCancellation scope([cancel_at] { return Clock::now() >= cancel_at; });
+  ASSERT_TRUE(RunProcess(
+      {"sh", "-c", "exec >&- 2>&-; sleep 5"}, WithTimeout(10s), &result));
+  EXPECT_LT(Clock::now() - cancel_at, 2s);
+  EXPECT_TRUE(result.canceled);
+}
+
+TEST(SubprocessTest, NestedScopesRestoreThePreviousOne) {
+  std::atomic<bool> outer_flag{false};
+  ScopedCancellation outer(&outer_flag);
+  {
+    ScopedCancellation inner([] { return true; });
+    EXPECT_EQ(ScopedCancellation::Current(), &inner);
+    ProcessResult result;
+    ASSERT_TRUE(RunProcess({"sleep", "5"}, WithTimeout(10s), &result));
+    EXPECT_TRUE(result.canceled);
+  }
+  EXPECT_EQ(ScopedCancellation::Current(), &outer);
+  EXPECT_FALSE(outer.cancelled());
+}
+
+TEST(SubprocessTest, OutputLargerThanThePipeBuffer) {
+  // 兩個串流都遠超過 64 KiB 的 pipe 緩衝區，必須同時讀取才不會卡住
+  ProcessResult result;
+  ASSERT_TRUE(RunProcess(
+      {"sh",
+       "-c",
+       "head -c 1000000 /dev/zero; head -c 700000 /dev/zero >&2; "
+       "head -c 300000 /dev/zero"},
+      WithTimeout(10s),
+      &result));
+  EXPECT_TRUE(result.Succeeded());
+  EXPECT_EQ(result.stdout_data.size(), 1'300'000u);
+  EXPECT_EQ(result.stderr_data.size(), 700'000u);
+}
+
+TEST(SubprocessTest, MissingExecutableIsReportedAsSpawnFailure) {
+  ProcessResult result;
+  result.stdout_data = "stale";
+  EXPECT_FALSE(RunProcess({"iptool-no-such-command"}, {}, &result));
+  EXPECT_NE(result.stderr_data.find("posix_spawnp"), std::string::npos)
+      << result.stderr_data;
+  EXPECT_TRUE(result.stdout_data.empty());
+  EXPECT_FALSE(result.Succeeded());
+}
+
+TEST(SubprocessTest, LabelRecordsLatency) {
+  ProcessOptions options;
+  options.label = "subprocess_test";
+  ProcessResult result;
+  ASSERT_TRUE(RunProcess({"true"}, options, &result));
+  EXPECT_GE(SubprocessLatencies().Get("subprocess_test").Read().count, 1u);
+}
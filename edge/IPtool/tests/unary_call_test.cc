@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "grpc/unary_call.hpp"
+#include "util/latency_histogram.hpp"
+
+using iptool::grpcservice::UnaryCall;
+using iptool::util::LatencyHistogram;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * 沒有實際連線時 reactor 不會被 gRPC 綁定，Finish 只會暫存狀態；
+ * 測試結束時以 OnDone 模擬 gRPC 釋放 reactor。
+ */
+class UnaryCallTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    if (call_) {
+      call_->reactor()->OnDone();
+    }
+  }
+
+  LatencyHistogram latency_;
+  std::shared_ptr<UnaryCall> call_ = UnaryCall::Start(&latency_);
+};
+
+} // namespace
+
+TEST_F(UnaryCallTest, SecondCompleteIsIgnored) {
+  int fills = 0;
+  EXPECT_TRUE(call_->Complete([&] {
+    ++fills;
+    return grpc::Status::OK;
+  }));
+  EXPECT_FALSE(call_->Complete([&] {
+    ++fills;
+    return grpc::Status(grpc::StatusCode::INTERNAL, "late");
+  }));
+  EXPECT_FALSE(call_->Complete(grpc::Status::CANCELLED));
+  EXPECT_EQ(fills, 1);
+  EXPECT_EQ(latency_.Read().count, 1u);
+}
+
+TEST_F(UnaryCallTest, CompleteAfterCancellationDoesNotFill) {
+  EXPECT_FALSE(call_->cancelled().load());
+  call_->reactor()->OnCancel();
+  EXPECT_TRUE(call_->cancelled().load());
+
+  // 取消時已以 CANCELLED 完成，之後的結果不得再寫入 response
+  bool filled = false;
+  EXPECT_FALSE(call_->Complete([&] {
+    filled = true;
+    return grpc::Status::OK;
+  }));
+  EXPECT_FALSE(filled);
+  EXPECT_EQ(latency_.Read().count, 1u);
+}
+
+TEST_F(UnaryCallTest, ConcurrentCompletersHaveOneWinner) {
+  constexpr int kThreads = 8;
+  std::atomic<int> winners{0};
+  std::atomic<int> fills{0};
+  {
+    std::vector<std::jthread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+      threads.emplace_back([&] {
+        if (call_->Complete([&] {
+              ++fills;
+              return grpc::Status::OK;
+            })) {
+          ++winners;
+        }
+      });
+    }
+  }
+  EXPECT_EQ(winners.load(), 1);
+  EXPECT_EQ(fills.load(), 1);
+}
+
+TEST_F(UnaryCallTest, CompleteAtFillsOnlyIfStillPending) {
+  std::atomic<bool> fired{false};
+  call_->CompleteAt(std::chrono::system_clock::now() + 20ms, [&] {
+    fired = true;
+    return grpc::Status::OK;
+  });
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (!fired && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_TRUE(fired.load());
+  EXPECT_FALSE(call_->Complete(grpc::Status::OK));
+}
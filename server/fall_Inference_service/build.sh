@@ -4,6 +4,8 @@ set -euo pipefail
 IMAGE_TAG="fall-inference-service:latest"
 PLATFORM="linux/amd64"
 CONTAINER_NAME="fall-inference-service"
+# DOCKERFILE=Dockerfile.native ./build.sh 產生不含 libtorch 的映像
+DOCKERFILE="${DOCKERFILE:-Dockerfile}"
 
 if docker ps -a --format '{{.Names}}' | grep -qx "$CONTAINER_NAME"; then
   echo "[info] Stopping existing container $CONTAINER_NAME"
@@ -11,7 +13,7 @@ if docker ps -a --format '{{.Names}}' | grep -qx "$CONTAINER_NAME"; then
 fi
 
 echo "[info] Building image $IMAGE_TAG for platform $PLATFORM"
-docker buildx build --platform "$PLATFORM" --progress=plain -t "$IMAGE_TAG" .
+docker buildx build --platform "$PLATFORM" --progress=plain -f "$DOCKERFILE" -t "$IMAGE_TAG" .
 
 echo "[info] Saveing container $CONTAINER_NAME"
 docker save $IMAGE_TAG | gzip > fall-inference-service-amd64.tar.gz
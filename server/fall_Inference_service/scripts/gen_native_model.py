@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+"""將 TorchScript 跌倒模型轉成不依賴 libtorch 的 C++ 標頭檔。
+
+模型結構固定為：
+    x -> (x - feature_mean) / feature_std
+      -> Linear(9, 64) -> ReLU -> Linear(64, 32) -> ReLU -> Linear(32, 1)
+
+權重直接從 .pt（zip）內的 data.pkl 與 data/<key> 讀出，不需要安裝 torch。
+若環境中有 torch，會再以 torch.jit.load 對固定輸入做一次 parity 比對，
+並將 TorchScript 的 logits 寫入標頭，讓 C++ 端以 static_assert 於編譯期驗證。
+"""
+
+from __future__ import annotations
+
+import argparse
+import io
+import math
+import pickle
+import random
+import struct
+import sys
+import zipfile
+from pathlib import Path
+from typing import Any, Dict, List, Sequence, Tuple
+
+PARITY_SAMPLES = 16
+PARITY_TOLERANCE = 1e-3
+
+
+class _Module:
+    """data.pkl 內 __torch__.* 物件的替身，只保留屬性字典。"""
+
+    def __init__(self, *args: Any) -> None:
+        self.attrs: Dict[str, Any] = {}
+
+    def __setstate__(self, state: Dict[str, Any]) -> None:
+        self.attrs = dict(state)
+
+
+class _Tensor:
+    def __init__(self, values: List[float], shape: Tuple[int, ...]) -> None:
+        self.values = values
+        self.shape = shape
+
+
+class _Unpickler(pickle.Unpickler):
+    def __init__(self, data: bytes, archive: zipfile.ZipFile, prefix: str):
+        super().__init__(io.BytesIO(data))
+        self._archive = archive
+        self._prefix = prefix
+
+    def find_class(self, module: str, name: str) -> Any:
+        if module == "torch._utils" and name == "_rebuild_tensor_v2":
+            return self._rebuild_tensor
+        if module == "torch" and name == "FloatStorage":
+            return "float"
+        if module == "collections" and name == "OrderedDict":
+            return dict
+        if module.startswith("__torch__"):
+            return _Module
+        raise pickle.UnpicklingError(f"unsupported global {module}.{name}")
+
+    def persistent_load(self, pid: Tuple[Any, ...]) -> List[float]:
+        kind, storage_type, key, _location, numel = pid
+        if kind != "storage" or storage_type != "float":
+            raise pickle.UnpicklingError(f"unsupported storage {pid!r}")
+        raw = self._archive.read(f"{self._prefix}/data/{key}")
+        return list(struct.unpack(f"<{numel}f", raw[: numel * 4]))
+
+    @staticmethod
+    def _rebuild_tensor(
+        storage: List[float],
+        offset: int,
+        shape: Tuple[int, ...],
+        stride: Tuple[int, ...],
+        *_unused: Any,
+    ) -> _Tensor:
+        count = math.prod(shape) if shape else 1
+        expected = tuple(
+            math.prod(shape[i + 1 :]) for i in range(len(shape))
+        )
+        if tuple(stride) != expected:
+            raise pickle.UnpicklingError("non-contiguous tensor not supported")
+        return _Tensor(storage[offset : offset + count], tuple(shape))
+
+
+def load_weights(model_path: Path) -> Dict[str, _Tensor]:
+    with zipfile.ZipFile(model_path) as archive:
+        data_name = next(n for n in archive.namelist() if n.endswith("/data.pkl"))
+        prefix = data_name[: -len("/data.pkl")]
+        byteorder = archive.read(f"{prefix}/byteorder").decode().strip()
+        if byteorder != "little":
+            raise SystemExit(f"unsupported byteorder: {byteorder}")
+        root = _Unpickler(archive.read(data_name), archive, prefix).load()
+
+    network = root.attrs["network"].attrs
+    weights = {
+        "feature_mean": root.attrs["feature_mean"],
+        "feature_std": root.attrs["feature_std"],
+    }
+    for index, layer in enumerate(("0", "2", "4")):
+        weights[f"w{index}"] = network[layer].attrs["weight"]
+        weights[f"b{index}"] = network[layer].attrs["bias"]
+
+    expected_shapes = {
+        "feature_mean": (9,),
+        "feature_std": (9,),
+        "w0": (64, 9),
+        "b0": (64,),
+        "w1": (32, 64),
+        "b1": (32,),
+        "w2": (1, 32),
+        "b2": (1,),
+    }
+    for name, shape in expected_shapes.items():
+        if weights[name].shape != shape:
+            raise SystemExit(
+                f"{name}: expected shape {shape}, got {weights[name].shape}"
+            )
+    return weights
+
+
+def reference_logit(w: Dict[str, _Tensor], features: Sequence[float]) -> float:
+    mean = w["feature_mean"].values
+    std = w["feature_std"].values
+    x = [(features[i] - mean[i]) / std[i] for i in range(9)]
+    for layer, (rows, cols) in enumerate(((64, 9), (32, 64), (1, 32))):
+        weight = w[f"w{layer}"].values
+        bias = w[f"b{layer}"].values
+        y = [
+            bias[r] + sum(weight[r * cols + c] * x[c] for c in range(cols))
+            for r in range(rows)
+        ]
+        x = y if layer == 2 else [max(v, 0.0) for v in y]
+    return x[0]
+
+
+def parity_inputs() -> List[List[float]]:
+    # 每組特徵為 [a, r, h] x 3，取貼近實際分佈的範圍
+    rng = random.Random(20250101)
+    samples = []
+    for _ in range(PARITY_SAMPLES):
+        row = []
+        for _frame in range(3):
+            row.append(round(rng.uniform(0.0, 90.0), 3))
+            row.append(round(rng.uniform(-2.0, 2.0), 3))
+            row.append(round(rng.uniform(0.2, 1.6), 3))
+        samples.append(row)
+    return samples
+
+
+def torch_logits(model_path: Path, inputs: List[List[float]]) -> List[float]:
+    import torch  # noqa: PLC0415
+
+    module = torch.jit.load(str(model_path), map_location="cpu")
+    module.eval()
+    with torch.no_grad():
+        out = module(torch.tensor(inputs, dtype=torch.float32))
+    return [float(v) for v in out.reshape(-1).tolist()]
+
+
+def fmt(value: float) -> str:
+    text = f"{value:.9g}"
+    if "e" not in text and "." not in text and "inf" not in text:
+        text += ".0"
+    return text + "f"
+
+
+def emit_array(name: str, values: Sequence[float]) -> str:
+    body = ",\n    ".join(
+        ", ".join(fmt(v) for v in values[i : i + 6])
+        for i in range(0, len(values), 6)
+    )
+    return (
+        f"inline constexpr std::array<float, {len(values)}> {name}{{\n"
+        f"    {body}}};\n"
+    )
+
+
+def emit_layer(out_name: str, in_name: str, layer: int, rows: int, cols: int,
+               relu: bool) -> List[str]:
+    lines = []
+    for r in range(rows):
+        terms = " + ".join(
+            f"kW{layer}[{r * cols + c}] * {in_name}[{c}]" for c in range(cols)
+        )
+        expr = f"kB{layer}[{r}] + {terms}"
+        if relu:
+            expr = f"Relu({expr})"
+        lines.append(f"  {out_name}[{r}] = {expr};")
+    return lines
+
+
+def generate(model_path: Path, parity: str) -> str:
+    weights = load_weights(model_path)
+    inputs = parity_inputs()
+    reference = [reference_logit(weights, row) for row in inputs]
+
+    source = "python reference"
+    expected = reference
+    if parity != "off":
+        try:
+            expected = torch_logits(model_path, inputs)
+            source = "TorchScript"
+        except ImportError:
+            if parity == "require":
+                raise SystemExit(
+                    "torch is required for the parity check; "
+                    "install it or pass --parity=auto"
+                )
+            print(
+                "gen_native_model: torch not available, parity vectors use "
+                "the python reference",
+                file=sys.stderr,
+            )
+    for i, (ref, exp) in enumerate(zip(reference, expected)):
+        if abs(ref - exp) > PARITY_TOLERANCE:
+            raise SystemExit(
+                f"parity mismatch at sample {i}: reference={ref} {source}={exp}"
+            )
+
+    out = [
+        f"// Generated by scripts/gen_native_model.py from {model_path.name}.",
+        "// Do not edit; re-run the build to regenerate.",
+        "#pragma once",
+        "",
+        "#include <array>",
+        "",
+        "namespace fall_model::native {",
+        "",
+        emit_array("kFeatureMean", weights["feature_mean"].values),
+        emit_array("kFeatureStd", weights["feature_std"].values),
+    ]
+    for layer in range(3):
+        out.append(emit_array(f"kW{layer}", weights[f"w{layer}"].values))
+        out.append(emit_array(f"kB{layer}", weights[f"b{layer}"].values))
+
+    out += [
+        "constexpr float Relu(float value) {",
+        "  return value > 0.0f ? value : 0.0f;",
+        "}",
+        "",
+        "// 9 維特徵 -> logit，固定形狀、完全展開",
+        "constexpr float EvaluateLogit(const std::array<float, 9>& features) {",
+        "  std::array<float, 9> x{};",
+    ]
+    out += [
+        f"  x[{i}] = (features[{i}] - kFeatureMean[{i}]) / kFeatureStd[{i}];"
+        for i in range(9)
+    ]
+    out.append("  std::array<float, 64> h0{};")
+    out += emit_layer("h0", "x", 0, 64, 9, True)
+    out.append("  std::array<float, 32> h1{};")
+    out += emit_layer("h1", "h0", 1, 32, 64, True)
+    terms = " + ".join(f"kW2[{c}] * h1[{c}]" for c in range(32))
+    out += [f"  return kB2[0] + {terms};", "}", ""]
+
+    out.append(f"// Parity vectors, expected logits from {source}")
+    out.append(
+        f"inline constexpr std::array<std::array<float, 9>, {len(inputs)}> "
+        "kParityInputs{{"
+    )
+    for row in inputs:
+        out.append("    {" + ", ".join(fmt(v) for v in row) + "},")
+    out.append("}};")
+    out.append(emit_array("kParityLogits", expected))
+    out.append(f"inline constexpr float kParityTolerance = {fmt(PARITY_TOLERANCE)};")
+    out += ["", "} // namespace fall_model::native", ""]
+    return "\n".join(out)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--model", type=Path, required=True)
+    parser.add_argument("--output", type=Path, required=True)
+    parser.add_argument(
+        "--parity",
+        choices=("require", "auto", "off"),
+        default="auto",
+        help="compare against torch.jit.load (require fails without torch)",
+    )
+    args = parser.parse_args()
+
+    text = generate(args.model, args.parity)
+    args.output.parent.mkdir(parents=True, exist_ok=True)
+    if not args.output.exists() or args.output.read_text() != text:
+        args.output.write_text(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,99 @@
+#include "heuristic_cascade.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace fall_cascade {
+
+std::optional<CascadeMode> ParseCascadeMode(std::string_view value) {
+  if (value == "off") {
+    return CascadeMode::kOff;
+  }
+  if (value == "filter") {
+    return CascadeMode::kFilter;
+  }
+  if (value == "audit") {
+    return CascadeMode::kAudit;
+  }
+  return std::nullopt;
+}
+
+HeuristicCascade::HeuristicCascade(CascadeConfig config) : config_(config) {}
+
+namespace {
+
+// 以 & 取代 &&，避免短路產生分支；NaN 的比較結果恆為 false，
+// 因此任何 NaN 都會使結果為 0
+unsigned Steady(const CascadeConfig& config, float tilt, float ratio, float h) {
+  return static_cast<unsigned>(tilt < config.max_tilt_deg) &
+      static_cast<unsigned>(std::fabs(ratio - 1.0f) <= config.max_box_change) &
+      static_cast<unsigned>(h >= config.min_height_ratio) &
+      static_cast<unsigned>(h <= kRuleBaseHeightRatio);
+}
+
+// 換算為每幀傾角變化量與框高比例變化量的 infer_labels 門檻
+struct MotionLimits {
+  float rotation_step;
+  float collapse_step;
+  float collapse_ratio_drop;
+};
+
+MotionLimits DeriveLimits(const CascadeConfig& config) {
+  const float scale = config.frame_interval_ms / 1000.0f * config.margin;
+  return MotionLimits{
+      kRuleRotationOmegaDegS * scale,
+      kRuleCollapseOmegaDegS * scale,
+      kRuleCollapseBoxRate * scale,
+  };
+}
+
+// 影格間的 fast rotation 與 fast collapse 都不成立
+unsigned Calm(
+    const MotionLimits& limits, float prev_tilt, float tilt, float ratio) {
+  const float step = std::fabs(tilt - prev_tilt);
+  return static_cast<unsigned>(step <= limits.rotation_step) &
+      (static_cast<unsigned>(step <= limits.collapse_step) |
+       static_cast<unsigned>(ratio - 1.0f >= limits.collapse_ratio_drop));
+}
+
+} // namespace
+
+void HeuristicCascade::classify(
+    std::span<const std::array<float, 9>> batch,
+    std::span<uint8_t> negative) const {
+  if (negative.size() < batch.size()) {
+    throw std::invalid_argument("decision span smaller than batch");
+  }
+  const MotionLimits limits = DeriveLimits(config_);
+  const size_t n = batch.size();
+  for (size_t i = 0; i < n; ++i) {
+    const auto& f = batch[i];
+    const unsigned steady = Steady(config_, f[0], f[1], f[2]) &
+        Steady(config_, f[3], f[4], f[5]) & Steady(config_, f[6], f[7], f[8]);
+    const unsigned calm =
+        Calm(limits, f[0], f[3], f[4]) & Calm(limits, f[3], f[6], f[7]);
+    negative[i] = static_cast<uint8_t>(steady & calm);
+  }
+}
+
+void HeuristicCascade::record(size_t total, size_t filtered) {
+  total_.fetch_add(total, std::memory_order_relaxed);
+  filtered_.fetch_add(filtered, std::memory_order_relaxed);
+}
+
+void HeuristicCascade::recordAudit(size_t audited, size_t disagreements) {
+  audited_.fetch_add(audited, std::memory_order_relaxed);
+  audit_disagreements_.fetch_add(disagreements, std::memory_order_relaxed);
+}
+
+CascadeStats HeuristicCascade::stats() const {
+  CascadeStats stats;
+  stats.total = total_.load(std::memory_order_relaxed);
+  stats.filtered = filtered_.load(std::memory_order_relaxed);
+  stats.audited = audited_.load(std::memory_order_relaxed);
+  stats.audit_disagreements =
+      audit_disagreements_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace fall_cascade
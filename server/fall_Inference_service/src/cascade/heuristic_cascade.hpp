@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace fall_cascade {
+
+enum class CascadeMode {
+  kOff, // 全部送進模型
+  kFilter, // 明確非跌倒者直接回覆，不進模型
+  kAudit, // 仍全部送進模型，但比對 cascade 判斷與模型結果
+};
+
+std::optional<CascadeMode> ParseCascadeMode(std::string_view value);
+
+// fall_detector.py::infer_labels 的門檻；cascade 的條件由此推導
+inline constexpr float kRuleBaseHeightRatio = 1.1f;
+inline constexpr float kRuleCollapseOmegaDegS = 100.0f;
+inline constexpr float kRuleCollapseBoxRate = -0.2f;
+inline constexpr float kRuleRotationOmegaDegS = 170.0f;
+
+/**
+ * 第一階段過濾條件。特徵為 [a1, r1, h1, a2, r2, h2, a3, r3, h3]：a 為
+ * 身體傾角（度），r 為框高相對前一幀的比例，h 為頭踝距離與框高比。
+ *
+ * 明確非跌倒需同時滿足：
+ * - 每個影格：a < max_tilt_deg、|r - 1| <= max_box_change、
+ *   min_height_ratio <= h <= 1.1。h 不超過 1.1 使 infer_labels 的 base
+ *   分支不成立；r 與 h 的範圍也排除模型會反應的劇烈框高與姿態變化。
+ * - 影格 2、3 相對前一幀：以 frame_interval_ms 換算
+ *   omega = |a_t - a_{t-1}| / dt、box_rate = (r_t - 1) / dt 後，
+ *   fast rotation（omega > 170）與 fast collapse（omega > 100 且
+ *   box_rate < -0.2）都不成立。
+ *
+ * dt 取實際可能的最短間隔：實際間隔較長時換算出的速度只會偏高，判斷
+ * 更保守。margin < 1 時速度門檻再按比例收緊。任何 NaN 都視為不明確。
+ */
+struct CascadeConfig {
+  CascadeMode mode = CascadeMode::kOff;
+  float max_tilt_deg = 35.0f;
+  float max_box_change = 0.2f;
+  float min_height_ratio = 0.7f;
+  // 視窗內相鄰影格的最短間隔（毫秒），預設以 30 fps 估算
+  float frame_interval_ms = 33.0f;
+  // 角速度與框高變化率門檻的縮放比例，1 為 infer_labels 原始門檻
+  float margin = 1.0f;
+  // 被過濾者回覆的機率（百分比）
+  float negative_probability = 0.0f;
+  // audit 模式下，模型機率達此值（百分比）即視為 cascade 誤判
+  float audit_threshold = 50.0f;
+};
+
+struct CascadeStats {
+  uint64_t total = 0;
+  uint64_t filtered = 0;
+  uint64_t audited = 0;
+  uint64_t audit_disagreements = 0;
+};
+
+class HeuristicCascade {
+ public:
+  explicit HeuristicCascade(CascadeConfig config);
+
+  const CascadeConfig& config() const { return config_; }
+  bool enabled() const { return config_.mode != CascadeMode::kOff; }
+  bool auditing() const { return config_.mode == CascadeMode::kAudit; }
+
+  // 對整個 batch 判斷是否為明確非跌倒（1）或需交給模型（0）。
+  // 迴圈內無分支，編譯器可直接向量化。negative 長度需 >= batch。
+  void classify(
+      std::span<const std::array<float, 9>> batch,
+      std::span<uint8_t> negative) const;
+
+  // 記錄本次 batch 的統計，filtered 為 classify 判定為非跌倒的筆數
+  void record(size_t total, size_t filtered);
+  // audit 模式：記錄與模型比對的筆數與不一致筆數
+  void recordAudit(size_t audited, size_t disagreements);
+
+  CascadeStats stats() const;
+
+ private:
+  CascadeConfig config_;
+  std::atomic<uint64_t> total_{0};
+  std::atomic<uint64_t> filtered_{0};
+  std::atomic<uint64_t> audited_{0};
+  std::atomic<uint64_t> audit_disagreements_{0};
+};
+
+} // namespace fall_cascade
@@ -1,4 +1,6 @@
 #include "core.hpp"
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 torch::Device FallProbInfer::selectDevice() {
@@ -24,46 +26,96 @@ FallProbInfer::FallProbInfer(const std::string& ts_model_path) {
   device_ = selectDevice();
   if (device_.is_cuda())
     module_.to(device_);
+  allocateBuffers();
 }
 
-torch::Tensor FallProbInfer::toTensor(
-    const std::vector<std::array<float, 9>>& batch) {
-  const auto n = static_cast<int64_t>(batch.size());
-  torch::Tensor t =
-      torch::empty({n, 9}, torch::TensorOptions().dtype(torch::kFloat32));
-  // 逐行拷貝，避免 from_blob 的生命週期/對齊問題
-  for (int64_t i = 0; i < n; ++i) {
-    auto row =
-        torch::from_blob((void*)batch[i].data(), {9}, torch::kFloat32).clone();
-    t.index_put_({i}, row);
+void FallProbInfer::allocateBuffers() {
+  const auto host_options = torch::TensorOptions()
+                                .dtype(torch::kFloat32)
+                                .pinned_memory(device_.is_cuda());
+  host_input_ = torch::empty({kMaxBatch, 9}, host_options);
+  host_output_ = torch::empty({kMaxBatch, 1}, host_options);
+  if (device_.is_cuda()) {
+    const auto device_options =
+        torch::TensorOptions().dtype(torch::kFloat32).device(device_);
+    device_input_ = torch::empty({kMaxBatch, 9}, device_options);
+    device_output_ = torch::empty({kMaxBatch, 1}, device_options);
+  } else {
+    device_input_ = host_input_;
+    device_output_ = host_output_;
+  }
+
+  host_input_views_.reserve(kMaxBatch);
+  host_output_views_.reserve(kMaxBatch);
+  input_views_.reserve(kMaxBatch);
+  output_views_.reserve(kMaxBatch);
+  for (int64_t n = 1; n <= kMaxBatch; ++n) {
+    host_input_views_.push_back(host_input_.narrow(0, 0, n));
+    host_output_views_.push_back(host_output_.narrow(0, 0, n));
+    input_views_.push_back(device_input_.narrow(0, 0, n));
+    output_views_.push_back(device_output_.narrow(0, 0, n));
+  }
+
+  args_.reserve(1);
+  args_.emplace_back(device_input_);
+}
+
+void FallProbInfer::forwardChunk(
+    const std::array<float, 9>* rows, int64_t n, float* out) {
+  static_assert(sizeof(std::array<float, 9>) == 9 * sizeof(float));
+  const auto idx = static_cast<size_t>(n - 1);
+
+  // 直接寫入預先配置的 host buffer，取代逐列 from_blob + clone
+  std::memcpy(
+      host_input_.data_ptr<float>(),
+      rows,
+      static_cast<size_t>(n) * sizeof(std::array<float, 9>));
+  if (device_.is_cuda()) {
+    input_views_[idx].copy_(host_input_views_[idx], /*non_blocking=*/true);
+  }
+
+  args_[0] = input_views_[idx];
+  auto logits = module_.forward(args_).toTensor();
+  auto& probs = output_views_[idx];
+  torch::sigmoid_out(probs, logits);
+  probs.mul_(100.0f); // -> 百分比
+
+  if (device_.is_cuda()) {
+    host_output_views_[idx].copy_(probs);
   }
-  return t.to(device_);
+  // logits shape: [N, 1]，連續記憶體直接拷貝
+  const float* src = host_output_.data_ptr<float>();
+  std::copy_n(src, n, out);
 }
 
 float FallProbInfer::inferOne(const std::array<float, 9>& features) {
-  std::vector<std::array<float, 9>> batch{features};
-  auto probs = inferBatch(batch);
-  return probs.front();
+  torch::NoGradGuard no_grad;
+  float probability = 0.0f;
+  forwardChunk(&features, 1, &probability);
+  return probability;
 }
 
-std::vector<float> FallProbInfer::inferBatch(
-    const std::vector<std::array<float, 9>>& batch) {
+void FallProbInfer::inferBatch(
+    std::span<const std::array<float, 9>> batch, std::span<float> out) {
+  if (out.size() < batch.size()) {
+    throw std::invalid_argument("output span smaller than batch");
+  }
   if (batch.empty())
-    return {};
+    return;
   torch::NoGradGuard no_grad;
 
-  auto input = toTensor(batch);
-  std::vector<torch::jit::IValue> args;
-  args.emplace_back(input);
-  auto logits = module_.forward(args).toTensor();
-  auto probs = torch::sigmoid(logits) * 100.0f; // -> 百分比
-
-  probs = probs.to(torch::kCPU);
-  std::vector<float> out;
-  out.reserve(batch.size());
-  // logits shape: [N, 1]，把每列取出
-  for (int64_t i = 0; i < probs.size(0); ++i) {
-    out.push_back(probs[i][0].item<float>());
+  size_t offset = 0;
+  while (offset < batch.size()) {
+    const auto n = std::min<size_t>(batch.size() - offset, kMaxBatch);
+    forwardChunk(
+        batch.data() + offset, static_cast<int64_t>(n), out.data() + offset);
+    offset += n;
   }
+}
+
+std::vector<float> FallProbInfer::inferBatch(
+    const std::vector<std::array<float, 9>>& batch) {
+  std::vector<float> out(batch.size());
+  inferBatch(std::span<const std::array<float, 9>>(batch), std::span(out));
   return out;
-}
\ No newline at end of file
+}
@@ -1,23 +1,47 @@
 #pragma once
 #include <array>
+#include <span>
 #include <vector>
 #include <torch/script.h>
 
 class FallProbInfer {
  public:
+  // 單次 forward 可處理的最大筆數；超過時會分段推論
+  static constexpr int64_t kMaxBatch = 64;
+
   // ctor 傳入 TorchScript 模型路徑
   explicit FallProbInfer(const std::string& ts_model_path);
 
   // 1 筆資料：9 維 -> 機率百分比 [0,100]
   float inferOne(const std::array<float, 9>& features);
 
+  // 多筆 batch：N x 9 -> 寫入呼叫端提供的 out（長度需 >= N）
+  void inferBatch(
+      std::span<const std::array<float, 9>> batch, std::span<float> out);
+
   // 多筆 batch：N x 9 -> N 個百分比
   std::vector<float> inferBatch(const std::vector<std::array<float, 9>>& batch);
 
+  bool usesCuda() const { return device_.is_cuda(); }
+
  private:
   torch::jit::script::Module module_;
   torch::Device device_ = torch::kCPU;
 
-  torch::Tensor toTensor(const std::vector<std::array<float, 9>>& batch);
+  // 每個 worker 預先配置的輸入/輸出緩衝區，大小固定為 kMaxBatch，
+  // input_views_[n-1] / output_views_[n-1] 為前 n 列的 view，
+  // 於 ctor 建好後重複使用，穩態下推論路徑不再自行配置記憶體
+  torch::Tensor host_input_;
+  torch::Tensor host_output_;
+  torch::Tensor device_input_;
+  torch::Tensor device_output_;
+  std::vector<torch::Tensor> host_input_views_;
+  std::vector<torch::Tensor> host_output_views_;
+  std::vector<torch::Tensor> input_views_;
+  std::vector<torch::Tensor> output_views_;
+  std::vector<torch::jit::IValue> args_;
+
+  void allocateBuffers();
+  void forwardChunk(const std::array<float, 9>* rows, int64_t n, float* out);
   static torch::Device selectDevice();
-};
\ No newline at end of file
+};
@@ -2,6 +2,8 @@
 
 #include "core.hpp"
 
+#include <ATen/Parallel.h>
+
 namespace fall_model {
 
 class InferenceAdapter::Impl {
@@ -12,6 +14,8 @@ class InferenceAdapter::Impl {
     return infer_.inferOne(features);
   }
 
+  bool uses_cuda() const { return infer_.usesCuda(); }
+
  private:
   FallProbInfer infer_;
 };
@@ -29,4 +33,14 @@ float InferenceAdapter::infer_one(const std::array<float, 9>& features) {
   return impl_->infer_one(features);
 }
 
+bool InferenceAdapter::uses_cuda() const {
+  return impl_->uses_cuda();
+}
+
+void InferenceAdapter::SetThreadCount(int threads) {
+  at::set_num_threads(threads);
+  // inter-op pool 只能設定一次，且必須在 pool 啟動之前
+  at::set_num_interop_threads(threads);
+}
+
 } // namespace fall_model
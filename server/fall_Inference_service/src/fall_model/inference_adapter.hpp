@@ -23,6 +23,13 @@ class InferenceAdapter {
 
   float infer_one(const std::array<float, 9>& features);
 
+  // 模型是否在 CUDA 上執行；CUDA context 無法帶進 fork 出的子行程
+  bool uses_cuda() const;
+
+  // 設定本行程 intra-op / inter-op thread pool 的大小，須在第一次推論前
+  // 呼叫；失敗時丟出 std::exception
+  static void SetThreadCount(int threads);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -1,6 +1,8 @@
 #include "server.hpp"
 
+#include <cascade/heuristic_cascade.hpp>
 #include <fall_model/inference_adapter.hpp>
+#include <memory/memory_governor.hpp>
 
 #include <folly/Conv.h>
 #include <folly/Format.h>
@@ -8,15 +10,51 @@
 #include <folly/logging/xlog.h>
 
 #include <array>
+#include <cmath>
+#include <cstdint>
 #include <exception>
 #include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace fallinference {
 
+namespace {
+
+std::string_view CascadeModeName(fall_cascade::CascadeMode mode) {
+  switch (mode) {
+    case fall_cascade::CascadeMode::kFilter:
+      return "filter";
+    case fall_cascade::CascadeMode::kAudit:
+      return "audit";
+    case fall_cascade::CascadeMode::kOff:
+    default:
+      return "off";
+  }
+}
+
+std::string_view PressureName(fall_memory::MemoryPressure pressure) {
+  switch (pressure) {
+    case fall_memory::MemoryPressure::kSoft:
+      return "SOFT";
+    case fall_memory::MemoryPressure::kHard:
+      return "HARD";
+    case fall_memory::MemoryPressure::kNormal:
+    default:
+      return "NORMAL";
+  }
+}
+
+} // namespace
+
 FallInferenceServiceImpl::FallInferenceServiceImpl(
-    std::shared_ptr<fall_model::InferenceAdapter> adapter)
-    : adapter_(std::move(adapter)) {}
+    std::shared_ptr<fall_model::InferenceAdapter> adapter,
+    std::shared_ptr<fall_cascade::HeuristicCascade> cascade,
+    std::shared_ptr<fall_memory::MemoryGovernor> memory)
+    : adapter_(std::move(adapter)),
+      cascade_(std::move(cascade)),
+      memory_(std::move(memory)) {}
 
 grpc::Status FallInferenceServiceImpl::InferFallProbability(
     grpc::ServerContext* /*context*/,
@@ -41,14 +79,45 @@ grpc::Status FallInferenceServiceImpl::InferFallProbability(
         grpc::StatusCode::INVALID_ARGUMENT, "expected exactly 9 features");
   }
 
+  // 接近記憶體預算時拒絕新請求，由呼叫端重試
+  fall_memory::InflightGuard admission(memory_.get());
+  if (!admission.admitted()) {
+    return grpc::Status(
+        grpc::StatusCode::RESOURCE_EXHAUSTED,
+        "inference service is shedding load under memory pressure");
+  }
+
   std::array<float, 9> features{};
   for (int i = 0; i < 9; ++i) {
     features[static_cast<size_t>(i)] = request->features(i);
   }
 
+  // 第一階段：明確非跌倒者直接回覆，不進模型
+  std::array<uint8_t, 1> negative{};
+  const bool cascade_enabled = cascade_ && cascade_->enabled();
+  if (cascade_enabled) {
+    cascade_->classify(
+        std::span<const std::array<float, 9>>(&features, 1), negative);
+    cascade_->record(1, negative[0]);
+    if (negative[0] && !cascade_->auditing()) {
+      response->set_probability(cascade_->config().negative_probability);
+      return grpc::Status::OK;
+    }
+  }
+
   try {
     std::lock_guard<std::mutex> guard(infer_mutex_);
     const float probability = adapter_->infer_one(features);
+    if (cascade_enabled && cascade_->auditing() && negative[0]) {
+      const bool disagree = probability >= cascade_->config().audit_threshold;
+      cascade_->recordAudit(1, disagree ? 1 : 0);
+      if (disagree) {
+        XLOGF(
+            WARN,
+            "cascade audit mismatch: filtered but model probability {}",
+            probability);
+      }
+    }
     const double rounded_probability =
         std::round(probability * 1000.0) / 1000.0;
     XLOGF(
@@ -66,4 +135,51 @@ grpc::Status FallInferenceServiceImpl::InferFallProbability(
   return grpc::Status::OK;
 }
 
+grpc::Status FallInferenceServiceImpl::GetInferenceStats(
+    grpc::ServerContext* /*context*/,
+    const InferenceStatsRequest* /*request*/,
+    InferenceStatsResponse* response) {
+  if (!response) {
+    return grpc::Status(
+        grpc::StatusCode::INVALID_ARGUMENT, "response container is null");
+  }
+
+  const auto allocator = fall_memory::MemoryGovernor::ReadAllocatorStats();
+  auto* memory = response->mutable_memory();
+  memory->set_rss_bytes(allocator.rss_bytes);
+  memory->set_anon_rss_bytes(allocator.anon_rss_bytes);
+  memory->set_jemalloc(allocator.jemalloc);
+  memory->set_allocated_bytes(allocator.allocated_bytes);
+  memory->set_active_bytes(allocator.active_bytes);
+  memory->set_resident_bytes(allocator.resident_bytes);
+  memory->set_mapped_bytes(allocator.mapped_bytes);
+  memory->set_arenas(allocator.arenas);
+  if (memory_) {
+    memory->set_budget_bytes(memory_->config().budget_bytes);
+    memory->set_pressure(std::string(PressureName(memory_->pressure())));
+    memory->set_inflight(memory_->inflight());
+    memory->set_inflight_limit(memory_->inflightLimit());
+    memory->set_rejected(memory_->rejected());
+  } else {
+    memory->set_pressure("NORMAL");
+  }
+
+  auto* cascade = response->mutable_cascade();
+  if (!cascade_) {
+    cascade->set_mode("off");
+    return grpc::Status::OK;
+  }
+  const auto stats = cascade_->stats();
+  cascade->set_mode(std::string(CascadeModeName(cascade_->config().mode)));
+  cascade->set_total(stats.total);
+  cascade->set_filtered(stats.filtered);
+  cascade->set_filtered_fraction(
+      stats.total == 0 ? 0.0
+                       : static_cast<double>(stats.filtered) /
+              static_cast<double>(stats.total));
+  cascade->set_audited(stats.audited);
+  cascade->set_audit_disagreements(stats.audit_disagreements);
+  return grpc::Status::OK;
+}
+
 } // namespace fallinference
@@ -10,19 +10,35 @@ namespace fall_model {
 class InferenceAdapter;
 }  // namespace fall_model
 
+namespace fall_cascade {
+class HeuristicCascade;
+}  // namespace fall_cascade
+
+namespace fall_memory {
+class MemoryGovernor;
+}  // namespace fall_memory
+
 namespace fallinference {
 
 class FallInferenceServiceImpl final : public FallInferenceService::Service {
  public:
   explicit FallInferenceServiceImpl(
-      std::shared_ptr<fall_model::InferenceAdapter> adapter);
+      std::shared_ptr<fall_model::InferenceAdapter> adapter,
+      std::shared_ptr<fall_cascade::HeuristicCascade> cascade = nullptr,
+      std::shared_ptr<fall_memory::MemoryGovernor> memory = nullptr);
 
   grpc::Status InferFallProbability(grpc::ServerContext* context,
                                     const FallInferenceRequest* request,
                                     FallInferenceResponse* response) override;
 
+  grpc::Status GetInferenceStats(grpc::ServerContext* context,
+                                 const InferenceStatsRequest* request,
+                                 InferenceStatsResponse* response) override;
+
  private:
   std::shared_ptr<fall_model::InferenceAdapter> adapter_;
+  std::shared_ptr<fall_cascade::HeuristicCascade> cascade_;
+  std::shared_ptr<fall_memory::MemoryGovernor> memory_;
   std::mutex infer_mutex_;
 };
 
@@ -0,0 +1,217 @@
+#include "memory_governor.hpp"
+
+#include <folly/logging/xlog.h>
+#include <folly/memory/MallctlHelper.h>
+#include <folly/memory/Malloc.h>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fall_memory {
+
+namespace {
+
+// jemalloc 的 MALLCTL_ARENAS_ALL
+constexpr const char* kPurgeAllArenas = "arena.4096.purge";
+
+struct RssBytes {
+  uint64_t total = 0;
+  uint64_t anon = 0;
+};
+
+// /proc/self/status 中「Name:   1234 kB」格式的欄位
+uint64_t StatusFieldBytes(std::string_view status, std::string_view name) {
+  const size_t pos = status.find(name);
+  if (pos == std::string_view::npos) {
+    return 0;
+  }
+  const char* cursor = status.data() + pos + name.size();
+  return std::strtoull(cursor, nullptr, 10) * 1024;
+}
+
+RssBytes ReadRssBytes() {
+  RssBytes rss;
+#if defined(__linux__)
+  const int fd = ::open("/proc/self/status", O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return rss;
+  }
+  std::array<char, 4096> buffer{};
+  const ssize_t n = ::read(fd, buffer.data(), buffer.size() - 1);
+  ::close(fd);
+  if (n <= 0) {
+    return rss;
+  }
+  const std::string_view status(buffer.data(), static_cast<size_t>(n));
+  rss.total = StatusFieldBytes(status, "\nVmRSS:");
+  rss.anon = StatusFieldBytes(status, "\nRssAnon:");
+#endif
+  return rss;
+}
+
+} // namespace
+
+MemoryPressure NextPressure(
+    const MemoryBudgetConfig& config,
+    MemoryPressure current,
+    uint64_t anon_rss_bytes) {
+  const auto budget = static_cast<double>(config.budget_bytes);
+  const auto usage = static_cast<double>(anon_rss_bytes);
+  if (usage >= budget * config.hard_ratio) {
+    return MemoryPressure::kHard;
+  }
+  if (current == MemoryPressure::kHard &&
+      usage >= budget * config.hard_exit_ratio) {
+    return MemoryPressure::kHard;
+  }
+  if (usage >= budget * config.soft_ratio) {
+    return MemoryPressure::kSoft;
+  }
+  if (current != MemoryPressure::kNormal &&
+      usage >= budget * config.soft_exit_ratio) {
+    return MemoryPressure::kSoft;
+  }
+  return MemoryPressure::kNormal;
+}
+
+MemoryGovernor::MemoryGovernor(MemoryBudgetConfig config) : config_(config) {
+  base_inflight_limit_ = std::max<uint32_t>(config_.max_inflight, 1);
+  if (limited()) {
+    // 預算的一半留給進行中的請求，其餘給模型、gRPC 與 allocator 快取
+    const uint64_t by_budget = config_.budget_bytes / 2 / kPerRequestBytes;
+    base_inflight_limit_ = static_cast<uint32_t>(std::clamp<uint64_t>(
+        by_budget, 1, static_cast<uint64_t>(base_inflight_limit_)));
+  }
+}
+
+MemoryGovernor::~MemoryGovernor() {
+  if (sampler_.joinable()) {
+    sampler_.request_stop();
+    sampler_.join();
+  }
+}
+
+void MemoryGovernor::start() {
+  if (!limited() || sampler_.joinable()) {
+    return;
+  }
+  sampler_ = std::jthread([this](std::stop_token stop) { sampleLoop(stop); });
+}
+
+uint64_t MemoryGovernor::grpcQuotaBytes() const {
+  return config_.budget_bytes / 4;
+}
+
+uint32_t MemoryGovernor::inflightLimit() const {
+  switch (pressure()) {
+    case MemoryPressure::kHard:
+      // 保留一個名額：拒絕全部請求時已進行的工作無法完成，用量也
+      // 就無從下降
+      return 1;
+    case MemoryPressure::kSoft:
+      return std::max<uint32_t>(base_inflight_limit_ / 4, 1);
+    case MemoryPressure::kNormal:
+    default:
+      return base_inflight_limit_;
+  }
+}
+
+bool MemoryGovernor::tryAcquire() {
+  const uint32_t limit = inflightLimit();
+  uint32_t current = inflight_.load(std::memory_order_relaxed);
+  while (current < limit) {
+    if (inflight_.compare_exchange_weak(
+            current, current + 1, std::memory_order_acquire)) {
+      return true;
+    }
+  }
+  rejected_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void MemoryGovernor::release() {
+  inflight_.fetch_sub(1, std::memory_order_release);
+}
+
+AllocatorStats MemoryGovernor::ReadAllocatorStats() {
+  AllocatorStats stats;
+  const RssBytes rss = ReadRssBytes();
+  stats.rss_bytes = rss.total;
+  stats.anon_rss_bytes = rss.anon;
+  if (!folly::usingJEMalloc()) {
+    return stats;
+  }
+  try {
+    // stats.* 為快取值，需先推進 epoch 才會更新
+    folly::mallctlWrite<uint64_t>("epoch", 1);
+    size_t value = 0;
+    folly::mallctlRead<size_t>("stats.allocated", &value);
+    stats.allocated_bytes = value;
+    folly::mallctlRead<size_t>("stats.active", &value);
+    stats.active_bytes = value;
+    folly::mallctlRead<size_t>("stats.resident", &value);
+    stats.resident_bytes = value;
+    folly::mallctlRead<size_t>("stats.mapped", &value);
+    stats.mapped_bytes = value;
+    unsigned arenas = 0;
+    folly::mallctlRead<unsigned>("arenas.narenas", &arenas);
+    stats.arenas = arenas;
+    stats.jemalloc = true;
+  } catch (const std::exception& ex) {
+    XLOGF(WARN, "failed to read jemalloc stats: {}", ex.what());
+  }
+  return stats;
+}
+
+void MemoryGovernor::sampleLoop(std::stop_token stop) {
+  std::mutex mutex;
+  std::condition_variable_any cv;
+  while (!stop.stop_requested()) {
+    sampleOnce();
+    std::unique_lock lock(mutex);
+    cv.wait_for(lock, stop, config_.sample_interval, [] { return false; });
+  }
+}
+
+void MemoryGovernor::sampleOnce() {
+  const uint64_t anon = ReadRssBytes().anon;
+  if (anon == 0) {
+    return;
+  }
+  const MemoryPressure current = pressure_.load(std::memory_order_relaxed);
+  const MemoryPressure next = NextPressure(config_, current, anon);
+  pressure_.store(next, std::memory_order_relaxed);
+
+  // 把 allocator 快取中的空閒頁還給系統：壓力升高時立即執行，之後
+  // 依 purge_interval 限制頻率（purge 會走訪所有 arena）
+  const auto now = std::chrono::steady_clock::now();
+  const bool escalated = next > current;
+  const bool purge_due = next != MemoryPressure::kNormal &&
+      (escalated || now - last_purge_ >= config_.purge_interval);
+  if (purge_due && folly::usingJEMalloc()) {
+    last_purge_ = now;
+    try {
+      folly::mallctlCall(kPurgeAllArenas);
+    } catch (const std::exception& ex) {
+      XLOGF(WARN, "jemalloc purge failed: {}", ex.what());
+    }
+  }
+  if (current != next) {
+    XLOGF(
+        WARN,
+        "memory pressure changed to {} (anon rss {} / budget {} bytes)",
+        static_cast<int>(next),
+        anon,
+        config_.budget_bytes);
+  }
+}
+
+} // namespace fall_memory
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+
+namespace fall_memory {
+
+enum class MemoryPressure {
+  kNormal,
+  kSoft, // 接近預算：縮小同時處理上限並釋放 allocator 快取
+  kHard, // 超過預算：只允許一個請求進行
+};
+
+/**
+ * 壓力等級以匿名記憶體（RssAnon）相對預算的比例判斷；模型權重與
+ * libtorch 的檔案頁面可被回收且由 worker 共用，不計入。進入與離開各有
+ * 門檻（exit < enter），避免在邊界附近每次取樣都切換等級。
+ */
+struct MemoryBudgetConfig {
+  // 0 代表不設限
+  uint64_t budget_bytes = 0;
+  double soft_ratio = 0.80;
+  double soft_exit_ratio = 0.70;
+  double hard_ratio = 0.95;
+  double hard_exit_ratio = 0.88;
+  // 最多同時處理的請求數（上限），實際值會再依預算縮小
+  uint32_t max_inflight = 64;
+  std::chrono::milliseconds sample_interval{200};
+  // 壓力升高時立即 purge，持續處於壓力下時最多每隔此時間 purge 一次
+  std::chrono::milliseconds purge_interval{5000};
+};
+
+// 依目前等級與匿名記憶體用量決定下一個等級（含遲滯）
+MemoryPressure NextPressure(
+    const MemoryBudgetConfig& config,
+    MemoryPressure current,
+    uint64_t anon_rss_bytes);
+
+struct AllocatorStats {
+  uint64_t rss_bytes = 0;
+  uint64_t anon_rss_bytes = 0;
+  bool jemalloc = false;
+  uint64_t allocated_bytes = 0;
+  uint64_t active_bytes = 0;
+  uint64_t resident_bytes = 0;
+  uint64_t mapped_bytes = 0;
+  uint32_t arenas = 0;
+};
+
+/**
+ * 依記憶體預算推導 gRPC resource quota 與同時處理上限，並在背景取樣
+ * 匿名 RSS；接近預算時逐步降級（縮小上限、purge jemalloc arena），超過
+ * 時只保留一個進行中的請求，避免被 OOM killer 終止，同時讓處理完的請求
+ * 釋放記憶體後能回到正常狀態。
+ */
+class MemoryGovernor {
+ public:
+  // 每個進行中的請求（gRPC buffer + 推論暫存）的保守估計
+  static constexpr uint64_t kPerRequestBytes = 256 * 1024;
+
+  explicit MemoryGovernor(MemoryBudgetConfig config);
+  ~MemoryGovernor();
+
+  MemoryGovernor(const MemoryGovernor&) = delete;
+  MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+  // 啟動背景取樣執行緒；pre-fork 模式下須在 worker 內呼叫
+  void start();
+
+  bool limited() const { return config_.budget_bytes != 0; }
+  const MemoryBudgetConfig& config() const { return config_; }
+
+  // 給 gRPC ResourceQuota 使用的位元組數（預算的四分之一）
+  uint64_t grpcQuotaBytes() const;
+
+  MemoryPressure pressure() const {
+    return pressure_.load(std::memory_order_relaxed);
+  }
+  uint32_t inflightLimit() const;
+  uint32_t inflight() const {
+    return inflight_.load(std::memory_order_relaxed);
+  }
+  uint64_t rejected() const {
+    return rejected_.load(std::memory_order_relaxed);
+  }
+
+  // 準入控制：成功時須呼叫 release()
+  bool tryAcquire();
+  void release();
+
+  static AllocatorStats ReadAllocatorStats();
+
+ private:
+  void sampleLoop(std::stop_token stop);
+  void sampleOnce();
+
+  MemoryBudgetConfig config_;
+  uint32_t base_inflight_limit_ = 0;
+  std::atomic<MemoryPressure> pressure_{MemoryPressure::kNormal};
+  std::atomic<uint32_t> inflight_{0};
+  std::atomic<uint64_t> rejected_{0};
+  // 僅由取樣執行緒存取
+  std::chrono::steady_clock::time_point last_purge_{};
+  std::jthread sampler_;
+};
+
+// RAII 準入票券
+class InflightGuard {
+ public:
+  explicit InflightGuard(MemoryGovernor* governor)
+      : governor_(governor), admitted_(!governor || governor->tryAcquire()) {}
+  ~InflightGuard() {
+    if (governor_ && admitted_) {
+      governor_->release();
+    }
+  }
+  InflightGuard(const InflightGuard&) = delete;
+  InflightGuard& operator=(const InflightGuard&) = delete;
+
+  bool admitted() const { return admitted_; }
+
+ private:
+  MemoryGovernor* governor_;
+  bool admitted_;
+};
+
+} // namespace fall_memory
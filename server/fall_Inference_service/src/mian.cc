@@ -1,47 +1,380 @@
 #include "grpc/server.hpp"
 
+#include <cascade/heuristic_cascade.hpp>
 #include <fall_model/inference_adapter.hpp>
+#include <memory/memory_governor.hpp>
 
 #include <grpcpp/grpcpp.h>
+#include <grpcpp/resource_quota.h>
 #include <folly/init/Init.h>
 #include <folly/logging/xlog.h>
+#include <folly/portability/GFlags.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
-int main(int argc, char** argv) {
-  folly::Init init(&argc, &argv);
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/prctl.h>
+#endif
 
-  std::string model_path = "fall_probability_model_ts.pt";
-  std::string server_address = "0.0.0.0:30050";
+DEFINE_int32(
+    workers,
+    0,
+    "Number of pre-forked worker processes sharing the listening port via "
+    "SO_REUSEPORT; 0 serves from the current process. CPU models only");
+DEFINE_int32(
+    worker_threads,
+    0,
+    "Intra-op and inter-op threads per worker process; 0 divides the "
+    "available cores evenly among --workers");
+DEFINE_int64(
+    memory_budget_mb,
+    0,
+    "Memory budget per process in MiB, compared with anonymous RSS (shared "
+    "model and library pages excluded); gRPC quota and in-flight limits are "
+    "derived from it and load is shed near the limit. 0 disables the budget");
+DEFINE_int32(
+    max_inflight,
+    64,
+    "Upper bound on concurrently processed inference requests");
+DEFINE_string(
+    cascade_mode,
+    "off",
+    "Heuristic pre-filter before the model: off, filter or audit");
+DEFINE_double(
+    cascade_max_tilt_deg,
+    35.0,
+    "Cascade: tilt angle (deg) all three frames must stay below");
+DEFINE_double(
+    cascade_max_box_change,
+    0.2,
+    "Cascade: max |box height ratio - 1| allowed in every frame");
+DEFINE_double(
+    cascade_min_height_ratio,
+    0.7,
+    "Cascade: min head-to-ankle / box height ratio in every frame");
+DEFINE_double(
+    cascade_frame_interval_ms,
+    33.0,
+    "Cascade: shortest expected interval (ms) between the window's frames, "
+    "used to turn infer_labels' angular velocity and box rate thresholds "
+    "into per-frame limits");
+DEFINE_double(
+    cascade_margin,
+    1.0,
+    "Cascade: scale (<= 1) applied to the derived per-frame limits");
+DEFINE_double(
+    cascade_audit_threshold,
+    50.0,
+    "Cascade audit: model probability (%) counted as a missed fall");
+
+namespace {
 
+volatile std::sig_atomic_t g_stop_requested = 0;
+
+void HandleStopSignal(int /*signo*/) {
+  g_stop_requested = 1;
+}
+
+struct ServeOptions {
   std::shared_ptr<fall_model::InferenceAdapter> adapter;
-  try {
-    adapter = std::make_shared<fall_model::InferenceAdapter>(model_path);
-  } catch (const std::exception& ex) {
-    XLOGF(ERR, "failed to load model from {}: {}", model_path, ex.what());
-    return 1;
-  }
+  std::shared_ptr<fall_cascade::HeuristicCascade> cascade;
+  std::shared_ptr<fall_memory::MemoryGovernor> memory;
+  std::string server_address;
+  std::string model_path;
+  // 每個 worker 的 libtorch thread pool 大小（只在 --workers 模式使用）
+  int worker_threads = 1;
+};
 
-  fallinference::FallInferenceServiceImpl service(adapter);
+int RunServer(const ServeOptions& ctx) {
+  fallinference::FallInferenceServiceImpl service(
+      ctx.adapter, ctx.cascade, ctx.memory);
 
   grpc::ServerBuilder builder;
-  builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
+  if (ctx.memory && ctx.memory->limited()) {
+    // 取樣執行緒須在 fork 之後建立
+    ctx.memory->start();
+    grpc::ResourceQuota quota("fall_inference_service");
+    quota.Resize(static_cast<size_t>(ctx.memory->grpcQuotaBytes()));
+    quota.SetMaxThreads(static_cast<int>(ctx.memory->inflightLimit()) + 2);
+    builder.SetResourceQuota(quota);
+  }
+  // 9 維特徵的請求很小，限制單一訊息大小避免異常請求佔用記憶體
+  builder.SetMaxReceiveMessageSize(64 * 1024);
+  // 多個 worker 共用同一個埠，由 kernel 分配連線
+  builder.AddChannelArgument(GRPC_ARG_ALLOW_REUSEPORT, 1);
+  builder.AddListeningPort(
+      ctx.server_address, grpc::InsecureServerCredentials());
   builder.RegisterService(&service);
 
   std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
   if (!server) {
-    XLOGF(ERR, "failed to start gRPC server on {}", server_address);
+    XLOGF(ERR, "failed to start gRPC server on {}", ctx.server_address);
     return 1;
   }
 
   XLOGF(
       INFO,
-      "FallInferenceService gRPC server listening on {} with model : {}",
-      server_address,
-      model_path);
+      "FallInferenceService gRPC server listening on {} with model : {} "
+      "(pid {})",
+      ctx.server_address,
+      ctx.model_path,
+      ::getpid());
 
   server->Wait();
   return 0;
 }
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kForkRetryInitial = std::chrono::milliseconds(100);
+constexpr auto kForkRetryMax = std::chrono::milliseconds(5000);
+
+// supervisor 需傳入 fork 前的 getpid()：容器內 supervisor 本身就是
+// PID 1，不能以 getppid() == 1 判斷 supervisor 是否已經結束
+pid_t SpawnWorker(const ServeOptions& ctx, pid_t supervisor) {
+  const pid_t pid = ::fork();
+  if (pid != 0) {
+    return pid;
+  }
+  std::signal(SIGTERM, SIG_DFL);
+  std::signal(SIGINT, SIG_DFL);
+#if defined(__linux__)
+  // supervisor 消失時一併結束，避免留下孤兒 worker；prctl 之前
+  // supervisor 就已結束時 getppid() 會變成收養的行程
+  ::prctl(PR_SET_PDEATHSIG, SIGTERM);
+  if (::getppid() != supervisor) {
+    ::_exit(1);
+  }
+#endif
+  // 各 worker 預設都會開滿所有核心的 intra-op pool，N 個 worker 會互相
+  // 搶核心；fork 後、第一次推論前縮小到分配給本 worker 的數量
+  try {
+    fall_model::InferenceAdapter::SetThreadCount(ctx.worker_threads);
+  } catch (const std::exception& ex) {
+    XLOGF(WARN, "failed to set worker thread count: {}", ex.what());
+  }
+  ::_exit(RunServer(ctx));
+}
+
+// fork 失敗（EAGAIN/ENOMEM）時以指數退避重試，直到成功或收到停止訊號；
+// 停止時回傳 0，代表該位置沒有 worker
+pid_t SpawnWorkerWithRetry(
+    const ServeOptions& ctx, pid_t supervisor, size_t index) {
+  auto delay = kForkRetryInitial;
+  while (!g_stop_requested) {
+    const pid_t pid = SpawnWorker(ctx, supervisor);
+    if (pid > 0) {
+      return pid;
+    }
+    const int error = errno;
+    XLOGF(
+        ERR,
+        "failed to fork worker {}: {}; retrying in {} ms",
+        index,
+        std::strerror(error),
+        delay.count());
+    std::this_thread::sleep_for(delay);
+    delay = std::min(delay * 2, kForkRetryMax);
+  }
+  return 0;
+}
+
+// Pre-fork supervisor：模型在 fork 前載入一次，權重頁面以 copy-on-write
+// 方式由所有 worker 共用（推論只讀不寫，不會被複製）；gRPC 只在 worker
+// 內初始化。worker 異常結束時自動重啟。只支援 CPU 模型，見 main()。
+int RunSupervisor(const ServeOptions& ctx, int worker_count) {
+  struct sigaction action {};
+  action.sa_handler = HandleStopSignal;
+  sigemptyset(&action.sa_mask);
+  ::sigaction(SIGTERM, &action, nullptr);
+  ::sigaction(SIGINT, &action, nullptr);
+
+  constexpr auto kMinUptime = std::chrono::seconds(1);
+
+  const pid_t supervisor = ::getpid();
+  // 0 代表該位置目前沒有 worker（只會在停止時出現）
+  std::vector<pid_t> workers(static_cast<size_t>(worker_count), 0);
+  std::vector<Clock::time_point> started(workers.size());
+  for (size_t i = 0; i < workers.size(); ++i) {
+    workers[i] = SpawnWorkerWithRetry(ctx, supervisor, i);
+    started[i] = Clock::now();
+  }
+  XLOGF(INFO, "supervisor {} started {} workers", supervisor, worker_count);
+
+  while (!g_stop_requested) {
+    int status = 0;
+    const pid_t pid = ::waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      XLOGF(ERR, "waitpid failed: {}", std::strerror(errno));
+      break;
+    }
+
+    size_t index = workers.size();
+    for (size_t i = 0; i < workers.size(); ++i) {
+      if (workers[i] == pid) {
+        index = i;
+        break;
+      }
+    }
+    if (index == workers.size()) {
+      continue;
+    }
+    if (g_stop_requested) {
+      // 已回收的 pid 可能被重複使用，停止時不可再對它送訊號
+      workers[index] = 0;
+      continue;
+    }
+
+    if (WIFSIGNALED(status)) {
+      XLOGF(
+          WARN,
+          "worker {} (pid {}) killed by signal {}",
+          index,
+          pid,
+          WTERMSIG(status));
+    } else {
+      XLOGF(
+          WARN,
+          "worker {} (pid {}) exited with status {}",
+          index,
+          pid,
+          WEXITSTATUS(status));
+    }
+
+    // 啟動後立即崩潰時稍作等待，避免 crash loop 佔滿 CPU
+    if (Clock::now() - started[index] < kMinUptime) {
+      std::this_thread::sleep_for(kMinUptime);
+    }
+    workers[index] = SpawnWorkerWithRetry(ctx, supervisor, index);
+    started[index] = Clock::now();
+    if (workers[index] > 0) {
+      XLOGF(INFO, "restarted worker {} as pid {}", index, workers[index]);
+    }
+  }
+
+  XLOGF(INFO, "supervisor stopping {} workers", worker_count);
+  for (const pid_t pid : workers) {
+    if (pid > 0) {
+      ::kill(pid, SIGTERM);
+    }
+  }
+  for (const pid_t pid : workers) {
+    if (pid > 0) {
+      ::waitpid(pid, nullptr, 0);
+    }
+  }
+  return 0;
+}
+
+// 本行程可使用的核心數；容器以 cpuset 限制時小於機器的核心數
+int AvailableCores() {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+    return std::max(CPU_COUNT(&set), 1);
+  }
+#endif
+  return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::Init init(&argc, &argv);
+
+  std::string model_path = "fall_probability_model_ts.pt";
+  std::string server_address = "0.0.0.0:30050";
+
+  ServeOptions ctx;
+  ctx.server_address = server_address;
+  ctx.model_path = model_path;
+  try {
+    ctx.adapter = std::make_shared<fall_model::InferenceAdapter>(model_path);
+  } catch (const std::exception& ex) {
+    XLOGF(ERR, "failed to load model from {}: {}", model_path, ex.what());
+    return 1;
+  }
+
+  const auto cascade_mode = fall_cascade::ParseCascadeMode(FLAGS_cascade_mode);
+  if (!cascade_mode) {
+    XLOGF(ERR, "invalid --cascade_mode: {}", FLAGS_cascade_mode);
+    return 1;
+  }
+  fall_memory::MemoryBudgetConfig memory_config;
+  memory_config.budget_bytes =
+      static_cast<uint64_t>(std::max<int64_t>(FLAGS_memory_budget_mb, 0)) *
+      1024 * 1024;
+  memory_config.max_inflight =
+      static_cast<uint32_t>(std::max<int32_t>(FLAGS_max_inflight, 1));
+  ctx.memory = std::make_shared<fall_memory::MemoryGovernor>(memory_config);
+  if (ctx.memory->limited()) {
+    XLOGF(
+        INFO,
+        "memory budget {} MiB, in-flight limit {}, gRPC quota {} bytes",
+        FLAGS_memory_budget_mb,
+        ctx.memory->inflightLimit(),
+        ctx.memory->grpcQuotaBytes());
+  }
+
+  if (FLAGS_cascade_frame_interval_ms <= 0.0 || FLAGS_cascade_margin <= 0.0 ||
+      FLAGS_cascade_margin > 1.0) {
+    XLOGF(
+        ERR,
+        "invalid cascade limits: --cascade_frame_interval_ms={} "
+        "--cascade_margin={}",
+        FLAGS_cascade_frame_interval_ms,
+        FLAGS_cascade_margin);
+    return 1;
+  }
+  fall_cascade::CascadeConfig cascade_config;
+  cascade_config.mode = *cascade_mode;
+  cascade_config.max_tilt_deg = static_cast<float>(FLAGS_cascade_max_tilt_deg);
+  cascade_config.max_box_change =
+      static_cast<float>(FLAGS_cascade_max_box_change);
+  cascade_config.min_height_ratio =
+      static_cast<float>(FLAGS_cascade_min_height_ratio);
+  cascade_config.frame_interval_ms =
+      static_cast<float>(FLAGS_cascade_frame_interval_ms);
+  cascade_config.margin = static_cast<float>(FLAGS_cascade_margin);
+  cascade_config.audit_threshold =
+      static_cast<float>(FLAGS_cascade_audit_threshold);
+  ctx.cascade =
+      std::make_shared<fall_cascade::HeuristicCascade>(cascade_config);
+  XLOGF(INFO, "cascade mode: {}", FLAGS_cascade_mode);
+
+  if (FLAGS_workers > 0) {
+    // supervisor 載入模型時已建立 CUDA context，fork 出的 worker 無法
+    // 使用也無法重新初始化 CUDA
+    if (ctx.adapter->uses_cuda()) {
+      XLOGF(ERR, "--workers requires a CPU model; the model is on CUDA");
+      return 1;
+    }
+    ctx.worker_threads = FLAGS_worker_threads > 0
+        ? FLAGS_worker_threads
+        : std::max(AvailableCores() / FLAGS_workers, 1);
+    XLOGF(
+        INFO,
+        "{} workers with {} threads each",
+        FLAGS_workers,
+        ctx.worker_threads);
+    return RunSupervisor(ctx, FLAGS_workers);
+  }
+  return RunServer(ctx);
+}
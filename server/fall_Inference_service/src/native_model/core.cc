@@ -0,0 +1,50 @@
+#include "core.hpp"
+#include <cmath>
+#include <stdexcept>
+
+#include "native_model/native_model_weights.hpp"
+
+namespace {
+
+// 編譯期 parity 檢查：產生器寫入的期望 logits 來自 TorchScript 模型，
+// 若展開後的 C++ 計算與之不符則建置失敗
+constexpr bool ParityHolds() {
+  using namespace fall_model::native;
+  for (size_t i = 0; i < kParityInputs.size(); ++i) {
+    const float diff = EvaluateLogit(kParityInputs[i]) - kParityLogits[i];
+    if (diff > kParityTolerance || diff < -kParityTolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(ParityHolds(), "native model diverges from TorchScript model");
+
+float ToPercent(float logit) {
+  return 100.0f / (1.0f + std::exp(-logit));
+}
+
+} // namespace
+
+float NativeFallProbInfer::inferOne(
+    const std::array<float, 9>& features) const {
+  return ToPercent(fall_model::native::EvaluateLogit(features));
+}
+
+void NativeFallProbInfer::inferBatch(
+    std::span<const std::array<float, 9>> batch,
+    std::span<float> out) const {
+  if (out.size() < batch.size()) {
+    throw std::invalid_argument("output span smaller than batch");
+  }
+  for (size_t i = 0; i < batch.size(); ++i) {
+    out[i] = inferOne(batch[i]);
+  }
+}
+
+std::vector<float> NativeFallProbInfer::inferBatch(
+    const std::vector<std::array<float, 9>>& batch) const {
+  std::vector<float> out(batch.size());
+  inferBatch(std::span<const std::array<float, 9>>(batch), std::span(out));
+  return out;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <array>
+#include <span>
+#include <vector>
+
+// 不依賴 libtorch 的推論實作；權重於建置時由 TorchScript 模型產生並編入
+// binary（見 scripts/gen_native_model.py），介面與 FallProbInfer 相同
+class NativeFallProbInfer {
+ public:
+  NativeFallProbInfer() = default;
+
+  // 1 筆資料：9 維 -> 機率百分比 [0,100]
+  float inferOne(const std::array<float, 9>& features) const;
+
+  // 多筆 batch：N x 9 -> 寫入呼叫端提供的 out（長度需 >= N）
+  void inferBatch(
+      std::span<const std::array<float, 9>> batch,
+      std::span<float> out) const;
+
+  // 多筆 batch：N x 9 -> N 個百分比
+  std::vector<float> inferBatch(
+      const std::vector<std::array<float, 9>>& batch) const;
+};
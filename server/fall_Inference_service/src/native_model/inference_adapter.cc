@@ -0,0 +1,40 @@
+#include "fall_model/inference_adapter.hpp"
+
+#include "core.hpp"
+
+namespace fall_model {
+
+// native build：權重已編入 binary，model_path 僅保留介面相容
+class InferenceAdapter::Impl {
+ public:
+  explicit Impl(const std::string& /*model_path*/) {}
+
+  float infer_one(const std::array<float, 9>& features) {
+    return infer_.inferOne(features);
+  }
+
+ private:
+  NativeFallProbInfer infer_;
+};
+
+InferenceAdapter::InferenceAdapter(const std::string& model_path)
+    : impl_(std::make_unique<Impl>(model_path)) {}
+
+InferenceAdapter::~InferenceAdapter() = default;
+
+InferenceAdapter::InferenceAdapter(InferenceAdapter&&) noexcept = default;
+InferenceAdapter& InferenceAdapter::operator=(InferenceAdapter&&) noexcept =
+    default;
+
+float InferenceAdapter::infer_one(const std::array<float, 9>& features) {
+  return impl_->infer_one(features);
+}
+
+bool InferenceAdapter::uses_cuda() const {
+  return false;
+}
+
+// native build 只在呼叫端的執行緒上計算，沒有可調整的 thread pool
+void InferenceAdapter::SetThreadCount(int /*threads*/) {}
+
+} // namespace fall_model
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "cascade/heuristic_cascade.hpp"
+#include "native_model/core.hpp"
+#include "native_model/native_model_weights.hpp"
+
+using fall_cascade::CascadeConfig;
+using fall_cascade::CascadeMode;
+using fall_cascade::HeuristicCascade;
+
+namespace {
+
+using Window = std::array<float, 9>;
+
+constexpr size_t kSamples = 200000;
+constexpr size_t kSearchSeeds = 2000;
+constexpr int kSearchSteps = 300;
+
+bool IsNegative(const HeuristicCascade& cascade, const Window& window) {
+  std::array<uint8_t, 1> decision{};
+  cascade.classify(std::span<const Window>(&window, 1), decision);
+  return decision[0] != 0;
+}
+
+// 站立並帶有偵測抖動的視窗，是實際流量中大多數的樣本
+Window UprightWindow(std::mt19937& rng) {
+  std::normal_distribution<float> unit(0.0f, 1.0f);
+  Window w{};
+  w[0] = std::fabs(15.0f * unit(rng));
+  w[3] = std::fabs(w[0] + 3.0f * unit(rng));
+  w[6] = std::fabs(w[3] + 3.0f * unit(rng));
+  for (size_t t = 0; t < 3; ++t) {
+    w[t * 3 + 1] = 1.0f + 0.06f * unit(rng);
+    w[t * 3 + 2] = 1.0f + 0.1f * unit(rng);
+  }
+  return w;
+}
+
+} // namespace
+
+/**
+ * 以實際模型檢查 cascade 的 recall：從被過濾的視窗出發，在仍被 cascade
+ * 判為明確非跌倒的範圍內做隨機爬坡，找模型機率最高的視窗。任何被過濾的
+ * 視窗都不得達到 audit 門檻，否則 filter 模式會漏掉模型會抓到的跌倒。
+ */
+TEST(CascadeRecall, FilteredWindowsStayBelowAuditThreshold) {
+  const NativeFallProbInfer model;
+  for (const float interval_ms : {33.0f, 100.0f}) {
+    CascadeConfig config;
+    config.mode = CascadeMode::kFilter;
+    config.frame_interval_ms = interval_ms;
+    const HeuristicCascade cascade(config);
+
+    std::mt19937 rng(5);
+    std::vector<Window> seeds;
+    size_t filtered = 0;
+    for (size_t i = 0; i < kSamples; ++i) {
+      const Window w = UprightWindow(rng);
+      if (!IsNegative(cascade, w)) {
+        continue;
+      }
+      ++filtered;
+      ASSERT_LT(model.inferOne(w), config.audit_threshold);
+      if (seeds.size() < kSearchSeeds) {
+        seeds.push_back(w);
+      }
+    }
+    EXPECT_GT(filtered, kSamples / 4) << "at " << interval_ms << " ms";
+
+    std::normal_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<size_t> feature(0, 8);
+    float worst = 0.0f;
+    for (Window w : seeds) {
+      float probability = model.inferOne(w);
+      for (int step = 0; step < kSearchSteps; ++step) {
+        Window candidate = w;
+        const size_t k = feature(rng);
+        candidate[k] +=
+            0.3f * fall_model::native::kFeatureStd[k] * unit(rng);
+        if (!IsNegative(cascade, candidate)) {
+          continue;
+        }
+        const float p = model.inferOne(candidate);
+        if (p > probability) {
+          w = candidate;
+          probability = p;
+        }
+      }
+      worst = std::max(worst, probability);
+    }
+    EXPECT_LT(worst, config.audit_threshold) << "at " << interval_ms << " ms";
+  }
+}
@@ -0,0 +1,311 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(FALL_INFERENCE_NATIVE_MODEL)
+#include "native_model/core.hpp"
+#else
+#include <c10/core/CPUAllocator.h>
+#include "fall_model/core.hpp"
+#endif
+
+// 以全域 operator new 計數：只在 AllocationScope 存活期間累計，所有執行緒
+// （包含 libtorch 的 intra-op pool）的配置都會算進去。
+// tensor 的儲存空間由 c10 CPU allocator 以 posix_memalign 配置，不經過
+// operator new，libtorch build 另外在 c10 allocator 上計數（見下方）
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<size_t> g_allocations{0};
+std::atomic<size_t> g_tensor_allocations{0};
+
+void* CountedAlloc(std::size_t size, std::size_t alignment) {
+  if (g_counting.load(std::memory_order_relaxed)) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  size = std::max<std::size_t>(size, 1);
+  void* ptr = alignment <= alignof(std::max_align_t)
+      ? std::malloc(size)
+      : std::aligned_alloc(
+            alignment, (size + alignment - 1) / alignment * alignment);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+class AllocationScope {
+ public:
+  AllocationScope() {
+    g_allocations.store(0);
+    g_tensor_allocations.store(0);
+    g_counting.store(true);
+  }
+  ~AllocationScope() {
+    g_counting.store(false);
+  }
+
+  size_t count() const {
+    return g_allocations.load();
+  }
+
+  size_t tensor_count() const {
+    return g_tensor_allocations.load();
+  }
+};
+
+constexpr int kWarmupRounds = 8;
+constexpr int kMeasuredRounds = 200;
+
+std::array<float, 9> MakeFeatures(size_t i) {
+  std::array<float, 9> features{};
+  for (size_t j = 0; j < features.size(); ++j) {
+    features[j] = static_cast<float>((i * 7 + j * 3) % 11) * 0.1f;
+  }
+  return features;
+}
+
+std::vector<std::array<float, 9>> MakeBatch(size_t n) {
+  std::vector<std::array<float, 9>> batch(n);
+  for (size_t i = 0; i < n; ++i) {
+    batch[i] = MakeFeatures(i);
+  }
+  return batch;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+  return CountedAlloc(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+  return CountedAlloc(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return CountedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return CountedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+#if defined(FALL_INFERENCE_NATIVE_MODEL)
+
+// native build 的推論完全在堆疊上完成，穩態必須是零配置
+
+TEST(NativeFallProbInferAlloc, InferOneDoesNotAllocate) {
+  NativeFallProbInfer infer;
+  const auto features = MakeFeatures(3);
+  float sink = 0.0f;
+  for (int i = 0; i < kWarmupRounds; ++i) {
+    sink += infer.inferOne(features);
+  }
+
+  AllocationScope scope;
+  for (int i = 0; i < kMeasuredRounds; ++i) {
+    sink += infer.inferOne(features);
+  }
+  EXPECT_EQ(scope.count(), 0u);
+  EXPECT_GT(sink, 0.0f);
+}
+
+TEST(NativeFallProbInferAlloc, InferBatchIntoSpanDoesNotAllocate) {
+  NativeFallProbInfer infer;
+  const auto batch = MakeBatch(128);
+  std::vector<float> out(batch.size());
+  for (int i = 0; i < kWarmupRounds; ++i) {
+    infer.inferBatch(batch, out);
+  }
+
+  AllocationScope scope;
+  for (int i = 0; i < kMeasuredRounds; ++i) {
+    infer.inferBatch(batch, out);
+  }
+  EXPECT_EQ(scope.count(), 0u);
+}
+
+#else
+
+/**
+ * 包住原本的 c10 CPU allocator，只多做計數；釋放仍走原 allocator 的
+ * deleter。以較高的 priority 註冊，之後所有 CPU tensor 都經過這裡。
+ */
+class CountingCpuAllocator final : public c10::Allocator {
+ public:
+  explicit CountingCpuAllocator(c10::Allocator* wrapped) : wrapped_(wrapped) {}
+
+  c10::DataPtr allocate(size_t n) override {
+    if (g_counting.load(std::memory_order_relaxed)) {
+      g_tensor_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return wrapped_->allocate(n);
+  }
+
+  c10::DeleterFnPtr raw_deleter() const override {
+    return wrapped_->raw_deleter();
+  }
+
+  void copy_data(void* dest, const void* src, std::size_t count)
+      const override {
+    wrapped_->copy_data(dest, src, count);
+  }
+
+ private:
+  c10::Allocator* wrapped_;
+};
+
+void InstallCountingCpuAllocator() {
+  static CountingCpuAllocator allocator(c10::GetCPUAllocator());
+  static const bool installed = [] {
+    c10::SetCPUAllocator(&allocator, /*priority=*/1);
+    return true;
+  }();
+  (void)installed;
+}
+
+// 量測值超過基準的部分；FallProbInfer 自身不得多出任何配置
+size_t AddedAllocations(size_t measured, size_t baseline) {
+  return measured > baseline ? measured - baseline : 0;
+}
+
+struct ForwardAllocations {
+  size_t heap = 0;
+  size_t tensors = 0;
+};
+
+/**
+ * libtorch build：module.forward() 內部的 interpreter 仍會配置（IValue
+ * stack、每層的輸出 tensor 等），不在 FallProbInfer 的控制範圍。因此以
+ * 同一個模型直接呼叫 forward 當作基準，要求 inferOne / inferBatch 在
+ * operator new 與 c10 allocator 上都不比基準多出任何配置，也就是
+ * forwardChunk 的 buffer、view、sigmoid_out 與參數容器在穩態下零配置。
+ */
+class FallProbInferAlloc : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    InstallCountingCpuAllocator();
+  }
+
+  // 直接以 torch API 呼叫 forward n 筆，回傳 kMeasuredRounds 次的總配置數
+  static ForwardAllocations ForwardBaseline(int64_t n) {
+    auto module = torch::jit::load(FALL_INFERENCE_TEST_MODEL, torch::kCPU);
+    module.eval();
+    torch::NoGradGuard no_grad;
+    std::vector<torch::jit::IValue> args;
+    args.reserve(1);
+    args.emplace_back(torch::rand({n, 9}));
+    for (int i = 0; i < kWarmupRounds; ++i) {
+      module.forward(args);
+    }
+
+    AllocationScope scope;
+    for (int i = 0; i < kMeasuredRounds; ++i) {
+      module.forward(args);
+    }
+    return {scope.count(), scope.tensor_count()};
+  }
+
+  FallProbInfer infer_{FALL_INFERENCE_TEST_MODEL};
+};
+
+TEST_F(FallProbInferAlloc, CountsTensorStorage) {
+  // 確認計數器確實掛在 tensor 配置路徑上，否則下面的測試會恆真
+  AllocationScope scope;
+  auto tensor = torch::empty({FallProbInfer::kMaxBatch, 9});
+  EXPECT_EQ(scope.tensor_count(), 1u);
+  EXPECT_GT(tensor.numel(), 0);
+}
+
+TEST_F(FallProbInferAlloc, InferOneAddsNoAllocationsBeyondForward) {
+  const auto baseline = ForwardBaseline(1);
+  const auto features = MakeFeatures(3);
+  for (int i = 0; i < kWarmupRounds; ++i) {
+    infer_.inferOne(features);
+  }
+
+  AllocationScope scope;
+  for (int i = 0; i < kMeasuredRounds; ++i) {
+    infer_.inferOne(features);
+  }
+  EXPECT_EQ(AddedAllocations(scope.tensor_count(), baseline.tensors), 0u);
+  EXPECT_EQ(AddedAllocations(scope.count(), baseline.heap), 0u);
+}
+
+TEST_F(FallProbInferAlloc, InferBatchAddsNoAllocationsBeyondForward) {
+  // batch <= kMaxBatch 時只會呼叫一次 forwardChunk
+  for (const int64_t n : {int64_t{1}, int64_t{7}, FallProbInfer::kMaxBatch}) {
+    const auto baseline = ForwardBaseline(n);
+    const auto batch = MakeBatch(static_cast<size_t>(n));
+    std::vector<float> out(batch.size());
+    for (int i = 0; i < kWarmupRounds; ++i) {
+      infer_.inferBatch(batch, out);
+    }
+
+    AllocationScope scope;
+    for (int i = 0; i < kMeasuredRounds; ++i) {
+      infer_.inferBatch(batch, out);
+    }
+    EXPECT_EQ(AddedAllocations(scope.tensor_count(), baseline.tensors), 0u)
+        << "n=" << n;
+    EXPECT_EQ(AddedAllocations(scope.count(), baseline.heap), 0u)
+        << "n=" << n;
+  }
+}
+
+TEST_F(FallProbInferAlloc, ChunkedBatchAddsNoAllocationsBeyondForward) {
+  // 超過 kMaxBatch 時分兩段 forward，基準為兩次 kMaxBatch 的 forward
+  const auto chunk = ForwardBaseline(FallProbInfer::kMaxBatch);
+  const auto batch = MakeBatch(2 * FallProbInfer::kMaxBatch);
+  std::vector<float> out(batch.size());
+  for (int i = 0; i < kWarmupRounds; ++i) {
+    infer_.inferBatch(batch, out);
+  }
+
+  AllocationScope scope;
+  for (int i = 0; i < kMeasuredRounds; ++i) {
+    infer_.inferBatch(batch, out);
+  }
+  EXPECT_EQ(AddedAllocations(scope.tensor_count(), 2 * chunk.tensors), 0u);
+  EXPECT_EQ(AddedAllocations(scope.count(), 2 * chunk.heap), 0u);
+}
+
+#endif
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "cascade/heuristic_cascade.hpp"
+
+using fall_cascade::CascadeConfig;
+using fall_cascade::CascadeMode;
+using fall_cascade::HeuristicCascade;
+
+namespace {
+
+using Window = std::array<float, 9>;
+
+// 與 edge/ComputerVision/Vision/fall_detector.py::infer_labels 相同
+int InferLabel(double tilt, double height_ratio, double omega, double rate) {
+  if (std::isnan(tilt) || std::isnan(height_ratio) || std::isnan(omega) ||
+      std::isnan(rate)) {
+    return 0;
+  }
+  const bool base =
+      tilt > 55.0 && height_ratio > 1.1 && omega > 80 && rate < -0.5;
+  const bool fast_collapse = omega > 100 && rate < -0.2;
+  const bool fast_rotation = omega > 170;
+  return base || fast_collapse || fast_rotation ? 1 : 0;
+}
+
+// 以實際影格間隔 dt_ms 計算影格 2、3 的 infer_labels，任一為 1 即回傳 1
+int WindowLabel(const Window& f, double dt_ms) {
+  const double dt = dt_ms / 1000.0;
+  int label = 0;
+  for (size_t t = 1; t < 3; ++t) {
+    const double tilt = f[t * 3];
+    const double omega = std::fabs(tilt - f[(t - 1) * 3]) / dt;
+    const double rate = (f[t * 3 + 1] - 1.0) / dt;
+    label |= InferLabel(tilt, f[t * 3 + 2], omega, rate);
+  }
+  return label;
+}
+
+bool IsNegative(const HeuristicCascade& cascade, const Window& window) {
+  std::array<uint8_t, 1> decision{};
+  cascade.classify(std::span<const Window>(&window, 1), decision);
+  return decision[0] != 0;
+}
+
+CascadeConfig FilterConfig(float frame_interval_ms) {
+  CascadeConfig config;
+  config.mode = CascadeMode::kFilter;
+  config.frame_interval_ms = frame_interval_ms;
+  return config;
+}
+
+// 傾角與變化量集中在門檻附近，讓邊界情況大量出現
+std::vector<Window> RandomWindows(size_t count, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> tilt(0.0f, 60.0f);
+  std::normal_distribution<float> step(0.0f, 4.0f);
+  std::normal_distribution<float> ratio(1.0f, 0.03f);
+  std::normal_distribution<float> height(1.0f, 0.1f);
+  std::vector<Window> windows(count);
+  for (auto& w : windows) {
+    w[0] = tilt(rng);
+    w[3] = std::fabs(w[0] + step(rng));
+    w[6] = std::fabs(w[3] + step(rng));
+    for (size_t t = 0; t < 3; ++t) {
+      w[t * 3 + 1] = ratio(rng);
+      w[t * 3 + 2] = height(rng);
+    }
+  }
+  return windows;
+}
+
+} // namespace
+
+TEST(HeuristicCascade, ParsesModes) {
+  EXPECT_EQ(fall_cascade::ParseCascadeMode("off"), CascadeMode::kOff);
+  EXPECT_EQ(fall_cascade::ParseCascadeMode("filter"), CascadeMode::kFilter);
+  EXPECT_EQ(fall_cascade::ParseCascadeMode("audit"), CascadeMode::kAudit);
+  EXPECT_FALSE(fall_cascade::ParseCascadeMode("on").has_value());
+}
+
+TEST(HeuristicCascade, SteadyUprightIsNegative) {
+  const HeuristicCascade cascade(FilterConfig(33.0f));
+  EXPECT_TRUE(IsNegative(
+      cascade, {5.0f, 1.0f, 1.0f, 5.5f, 1.0f, 1.0f, 5.2f, 1.0f, 1.0f}));
+}
+
+TEST(HeuristicCascade, FastRotationIsAmbiguous) {
+  // 每幀 6 度、30 fps 約 182 度/秒，超過 fast rotation 的 170
+  const HeuristicCascade cascade(FilterConfig(33.0f));
+  EXPECT_FALSE(IsNegative(
+      cascade, {10.0f, 1.0f, 1.0f, 16.0f, 1.0f, 1.0f, 22.0f, 1.0f, 1.0f}));
+}
+
+TEST(HeuristicCascade, FastCollapseIsAmbiguous) {
+  // 每幀 4 度（約 121 度/秒）且框高每幀縮小 2%（約 -0.6/秒）
+  const HeuristicCascade cascade(FilterConfig(33.0f));
+  EXPECT_FALSE(IsNegative(
+      cascade, {10.0f, 1.0f, 1.0f, 14.0f, 0.98f, 1.0f, 18.0f, 0.98f, 1.0f}));
+}
+
+TEST(HeuristicCascade, TiltedPostureIsAmbiguous) {
+  const HeuristicCascade cascade(FilterConfig(33.0f));
+  EXPECT_FALSE(IsNegative(
+      cascade, {40.0f, 1.0f, 1.0f, 40.0f, 1.0f, 1.0f, 40.0f, 1.0f, 1.0f}));
+}
+
+TEST(HeuristicCascade, BoxJumpIsAmbiguous) {
+  // 傾角不變但框高一幀內變為 1.5 倍：infer_labels 不會觸發，但模型會反應
+  const HeuristicCascade cascade(FilterConfig(33.0f));
+  EXPECT_FALSE(IsNegative(
+      cascade, {10.0f, 1.0f, 1.0f, 10.0f, 1.0f, 1.0f, 10.0f, 1.5f, 1.0f}));
+}
+
+TEST(HeuristicCascade, HeightRatioOutsideEnvelopeIsAmbiguous) {
+  const HeuristicCascade cascade(FilterConfig(33.0f));
+  EXPECT_FALSE(IsNegative(
+      cascade, {10.0f, 1.0f, 1.0f, 10.0f, 1.0f, 0.5f, 10.0f, 1.0f, 1.0f}));
+  EXPECT_FALSE(IsNegative(
+      cascade, {10.0f, 1.0f, 1.2f, 10.0f, 1.0f, 1.0f, 10.0f, 1.0f, 1.0f}));
+}
+
+TEST(HeuristicCascade, NaNIsAmbiguous) {
+  const HeuristicCascade cascade(FilterConfig(33.0f));
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  for (size_t i = 0; i < 9; ++i) {
+    Window window{5.0f, 1.0f, 1.0f, 5.0f, 1.0f, 1.0f, 5.0f, 1.0f, 1.0f};
+    window[i] = nan;
+    EXPECT_FALSE(IsNegative(cascade, window)) << "NaN at feature " << i;
+  }
+}
+
+TEST(HeuristicCascade, NeverFiltersWhatInferLabelsFlags) {
+  // 實際間隔不短於設定值時，被判為明確非跌倒者 infer_labels 必為 0
+  for (const float configured_ms : {33.0f, 100.0f}) {
+    const HeuristicCascade cascade(FilterConfig(configured_ms));
+    const auto windows = RandomWindows(200000, 7);
+    std::vector<uint8_t> negative(windows.size());
+    cascade.classify(windows, negative);
+
+    size_t filtered = 0;
+    for (size_t i = 0; i < windows.size(); ++i) {
+      if (!negative[i]) {
+        continue;
+      }
+      ++filtered;
+      for (const double actual_ms :
+           {double{configured_ms}, configured_ms * 1.5, configured_ms * 3.0}) {
+        ASSERT_EQ(WindowLabel(windows[i], actual_ms), 0)
+            << "window " << i << " filtered at " << configured_ms
+            << " ms but flagged at " << actual_ms << " ms";
+      }
+    }
+    // 規則仍需實際過濾掉一部分，否則 cascade 沒有意義
+    EXPECT_GT(filtered, windows.size() / 20);
+  }
+}
+
+TEST(HeuristicCascade, MarginOnlyTightens) {
+  CascadeConfig tight = FilterConfig(33.0f);
+  tight.margin = 0.5f;
+  const HeuristicCascade loose_cascade(FilterConfig(33.0f));
+  const HeuristicCascade tight_cascade(tight);
+  const auto windows = RandomWindows(50000, 11);
+  std::vector<uint8_t> loose(windows.size());
+  std::vector<uint8_t> strict(windows.size());
+  loose_cascade.classify(windows, loose);
+  tight_cascade.classify(windows, strict);
+  for (size_t i = 0; i < windows.size(); ++i) {
+    EXPECT_LE(strict[i], loose[i]) << "window " << i;
+  }
+}
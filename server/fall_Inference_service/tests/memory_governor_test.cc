@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "memory/memory_governor.hpp"
+
+using fall_memory::MemoryBudgetConfig;
+using fall_memory::MemoryGovernor;
+using fall_memory::MemoryPressure;
+using fall_memory::NextPressure;
+
+namespace {
+
+MemoryBudgetConfig Budget() {
+  MemoryBudgetConfig config;
+  config.budget_bytes = 1000;
+  return config;
+}
+
+} // namespace
+
+TEST(MemoryGovernor, SoftHoldsUntilExitRatio) {
+  const auto config = Budget();
+  EXPECT_EQ(
+      NextPressure(config, MemoryPressure::kNormal, 790),
+      MemoryPressure::kNormal);
+  EXPECT_EQ(
+      NextPressure(config, MemoryPressure::kNormal, 800),
+      MemoryPressure::kSoft);
+  EXPECT_EQ(
+      NextPressure(config, MemoryPressure::kSoft, 750),
+      MemoryPressure::kSoft);
+  EXPECT_EQ(
+      NextPressure(config, MemoryPressure::kSoft, 690),
+      MemoryPressure::kNormal);
+}
+
+TEST(MemoryGovernor, HardStepsDownThroughSoft) {
+  const auto config = Budget();
+  EXPECT_EQ(
+      NextPressure(config, MemoryPressure::kNormal, 960),
+      MemoryPressure::kHard);
+  EXPECT_EQ(
+      NextPressure(config, MemoryPressure::kHard, 900),
+      MemoryPressure::kHard);
+  EXPECT_EQ(
+      NextPressure(config, MemoryPressure::kHard, 870),
+      MemoryPressure::kSoft);
+  EXPECT_EQ(
+      NextPressure(config, MemoryPressure::kHard, 650),
+      MemoryPressure::kNormal);
+}
+
+TEST(MemoryGovernor, NoFlappingAroundSoftRatio) {
+  // 用量在 soft 門檻上下跳動時只應切換一次
+  const auto config = Budget();
+  MemoryPressure pressure = MemoryPressure::kNormal;
+  int transitions = 0;
+  for (int i = 0; i < 100; ++i) {
+    const uint64_t usage = i % 2 == 0 ? 810 : 790;
+    const MemoryPressure next = NextPressure(config, pressure, usage);
+    transitions += next != pressure ? 1 : 0;
+    pressure = next;
+  }
+  EXPECT_EQ(transitions, 1);
+  EXPECT_EQ(pressure, MemoryPressure::kSoft);
+}
+
+TEST(MemoryGovernor, InflightLimitDerivedFromBudget) {
+  MemoryBudgetConfig config;
+  config.budget_bytes = 8 * MemoryGovernor::kPerRequestBytes;
+  config.max_inflight = 64;
+  const MemoryGovernor governor(config);
+  // 預算的一半給進行中的請求
+  EXPECT_EQ(governor.inflightLimit(), 4u);
+}